@@ -0,0 +1,218 @@
+/**
+ * @file HitboxBroadphase.cpp
+ * @brief This file contains the implementation of the FHitboxCapsuleSet struct.
+ */
+
+#include "CharacterAttributeModule/Hitbox/Public/HitboxBroadphase.h"
+#include "Math/VectorRegister.h"
+
+
+/**
+ * @brief Removes every capsule but keeps the memory for the next refresh.
+ */
+void FHitboxCapsuleSet::Reset() {
+	NumCapsules = 0;
+	CenterX.Reset();
+	CenterY.Reset();
+	CenterZ.Reset();
+	AxisHalfLength.Reset();
+	Radius.Reset();
+}
+
+
+/**
+ * @brief Reserves room for a number of capsules, rounded up to whole vector iterations.
+ * @param NumToReserve The number of capsules to make room for.
+ */
+void FHitboxCapsuleSet::Reserve( const int32 NumToReserve ) {
+	const int32 NumLanes = Align(NumToReserve, LaneCount);
+	CenterX.Reserve(NumLanes);
+	CenterY.Reserve(NumLanes);
+	CenterZ.Reserve(NumLanes);
+	AxisHalfLength.Reserve(NumLanes);
+	Radius.Reserve(NumLanes);
+}
+
+
+/**
+ * @brief Adds an upright capsule.
+ * A new group of four lanes is opened when the last one is full, so the arrays always hold whole groups.
+ * @param Center The centre of the capsule.
+ * @param HalfHeight The half height of the capsule, including the hemispheres.
+ * @param InRadius The radius of the capsule.
+ * @return The index of the capsule.
+ */
+int32 FHitboxCapsuleSet::Add( const FVector3f& Center, const float HalfHeight, const float InRadius ) {
+	if ( NumCapsules % LaneCount == 0 ) {
+		CenterX.AddZeroed(LaneCount);
+		CenterY.AddZeroed(LaneCount);
+		CenterZ.AddZeroed(LaneCount);
+		AxisHalfLength.AddZeroed(LaneCount);
+		Radius.AddZeroed(LaneCount);
+	}
+
+	const int32 Index = NumCapsules++;
+	CenterX[Index] = Center.X;
+	CenterY[Index] = Center.Y;
+	CenterZ[Index] = Center.Z;
+	AxisHalfLength[Index] = FMath::Max(HalfHeight - InRadius, 0.f);
+	Radius[Index] = InRadius;
+	return Index;
+}
+
+
+namespace HitboxBroadphase
+{
+	/**
+	 * @brief Measures the squared distance from a point on the ray to the axes of four capsules.
+	 * The axis point nearest to the ray point is the ray point's height clamped to the axis, so only the part
+	 * of the height beyond the axis adds to the horizontal distance.
+	 * @param RayT The ray parameter of every lane.
+	 * @param RelativeX The ray start relative to every capsule centre, along X.
+	 * @param RelativeY The ray start relative to every capsule centre, along Y.
+	 * @param RelativeZ The ray start relative to every capsule centre, along Z.
+	 * @param DirectionX The ray direction along X, broadcast.
+	 * @param DirectionY The ray direction along Y, broadcast.
+	 * @param DirectionZ The ray direction along Z, broadcast.
+	 * @param HalfLength Half the axis length of every capsule.
+	 * @return The squared distance of every lane.
+	 */
+	FORCEINLINE VectorRegister4Float AxisDistanceSquared(const VectorRegister4Float RayT, const VectorRegister4Float RelativeX, const VectorRegister4Float RelativeY, const VectorRegister4Float RelativeZ,
+		const VectorRegister4Float DirectionX, const VectorRegister4Float DirectionY, const VectorRegister4Float DirectionZ, const VectorRegister4Float HalfLength)
+	{
+		const VectorRegister4Float DeltaX = VectorMultiplyAdd(DirectionX, RayT, RelativeX);
+		const VectorRegister4Float DeltaY = VectorMultiplyAdd(DirectionY, RayT, RelativeY);
+		const VectorRegister4Float DeltaZ = VectorMax(VectorSubtract(VectorAbs(VectorMultiplyAdd(DirectionZ, RayT, RelativeZ)), HalfLength), VectorZeroFloat());
+		return VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ)));
+	}
+
+	/**
+	 * @brief Clamps the ray parameters of four lanes to a range.
+	 * @param Value The parameters.
+	 * @param Min The lower bound of every lane.
+	 * @param Max The upper bound of every lane.
+	 * @return The clamped parameters.
+	 */
+	FORCEINLINE VectorRegister4Float ClampLanes(const VectorRegister4Float Value, const VectorRegister4Float Min, const VectorRegister4Float Max)
+	{
+		return VectorMin(VectorMax(Value, Min), Max);
+	}
+}
+
+
+/**
+ * @brief Finds every capsule a ray passes within a margin of, testing four capsules per iteration.
+ *
+ * The squared distance from the ray point at t to a vertical axis is the horizontal distance squared plus the
+ * squared height beyond the axis. That is convex in t and quadratic on three pieces: below the axis, level with it
+ * and above it. The exact minimum is the smallest of three candidates:
+ * - the minimiser of the distance to the bottom end point, clamped to the ray,
+ * - the minimiser of the distance to the top end point, clamped to the ray,
+ * - the minimiser of the horizontal distance, clamped to where the ray is level with the axis.
+ * The end point distances bound the true distance from above and equal it on their pieces, so their clamped
+ * minimisers are exact whenever the nearest point lies above or below the axis; the level candidate covers the rest.
+ * Every step is a handful of multiply-adds, mins and maxes, so the lanes never diverge. The ray is the same for
+ * every lane and is broadcast once up front.
+ * @param RayStart The start of the ray.
+ * @param RayEnd The end of the ray.
+ * @param Margin The distance from a capsule's surface that still counts as near.
+ * @param OutCandidates Receives the indices of the capsules near the ray, in ascending order.
+ */
+void FHitboxCapsuleSet::FindRayCandidates( const FVector& RayStart, const FVector& RayEnd, const float Margin, FHitboxCandidates& OutCandidates ) const {
+	using namespace HitboxBroadphase;
+
+	OutCandidates.Reset();
+
+	const FVector3f Start(RayStart);
+	const FVector3f Direction(RayEnd - RayStart);
+	const float DirectionLengthSquared = Direction.SizeSquared();
+	if ( NumCapsules == 0 || DirectionLengthSquared <= UE_SMALL_NUMBER ) { return; }
+
+	// A vertical ray keeps the same horizontal distance everywhere, so any point on it minimises it
+	const float HorizontalLengthSquared = DirectionLengthSquared - FMath::Square(Direction.Z);
+	const VectorRegister4Float InvHorizontalLengthSquared = VectorSetFloat1(HorizontalLengthSquared > UE_KINDA_SMALL_NUMBER * DirectionLengthSquared ? 1.f / HorizontalLengthSquared : 0.f);
+	const VectorRegister4Float InvDirectionLengthSquared = VectorSetFloat1(1.f / DirectionLengthSquared);
+
+	// A level ray is level with an axis along its whole length or nowhere; in the latter case the level candidate is
+	// just an upper bound and the end point candidates are exact
+	const bool bLevelRay = FMath::Abs(Direction.Z) <= UE_KINDA_SMALL_NUMBER * FMath::Sqrt(DirectionLengthSquared);
+	const VectorRegister4Float InvDirectionZ = VectorSetFloat1(bLevelRay ? 0.f : 1.f / Direction.Z);
+
+	const VectorRegister4Float StartX = VectorSetFloat1(Start.X);
+	const VectorRegister4Float StartY = VectorSetFloat1(Start.Y);
+	const VectorRegister4Float StartZ = VectorSetFloat1(Start.Z);
+	const VectorRegister4Float DirectionX = VectorSetFloat1(Direction.X);
+	const VectorRegister4Float DirectionY = VectorSetFloat1(Direction.Y);
+	const VectorRegister4Float DirectionZ = VectorSetFloat1(Direction.Z);
+	const VectorRegister4Float MarginV = VectorSetFloat1(Margin);
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float One = VectorOneFloat();
+
+	const float* CenterXData = CenterX.GetData();
+	const float* CenterYData = CenterY.GetData();
+	const float* CenterZData = CenterZ.GetData();
+	const float* AxisHalfLengthData = AxisHalfLength.GetData();
+	const float* RadiusData = Radius.GetData();
+
+	for ( int32 Base = 0; Base < NumCapsules; Base += LaneCount ) {
+		// The ray start relative to every capsule centre
+		const VectorRegister4Float RelativeX = VectorSubtract(StartX, VectorLoad(CenterXData + Base));
+		const VectorRegister4Float RelativeY = VectorSubtract(StartY, VectorLoad(CenterYData + Base));
+		const VectorRegister4Float RelativeZ = VectorSubtract(StartZ, VectorLoad(CenterZData + Base));
+		const VectorRegister4Float HalfLength = VectorLoad(AxisHalfLengthData + Base);
+
+		const VectorRegister4Float HorizontalDot = VectorMultiplyAdd(DirectionX, RelativeX, VectorMultiply(DirectionY, RelativeY));
+		const VectorRegister4Float DirectionDotRelative = VectorMultiplyAdd(DirectionZ, RelativeZ, HorizontalDot);
+		const VectorRegister4Float DirectionZTimesHalfLength = VectorMultiply(DirectionZ, HalfLength);
+
+		// The ray points nearest to the top and the bottom end of the axis
+		const VectorRegister4Float TopT = ClampLanes(VectorMultiply(VectorSubtract(DirectionZTimesHalfLength, DirectionDotRelative), InvDirectionLengthSquared), Zero, One);
+		const VectorRegister4Float BottomT = ClampLanes(VectorMultiply(VectorNegate(VectorAdd(DirectionZTimesHalfLength, DirectionDotRelative)), InvDirectionLengthSquared), Zero, One);
+
+		// The part of the ray level with the axis, and the point on it nearest to the axis
+		VectorRegister4Float LevelMin = Zero;
+		VectorRegister4Float LevelMax = One;
+		if ( !bLevelRay ) {
+			const VectorRegister4Float EnterT = VectorMultiply(VectorNegate(VectorAdd(HalfLength, RelativeZ)), InvDirectionZ);
+			const VectorRegister4Float ExitT = VectorMultiply(VectorSubtract(HalfLength, RelativeZ), InvDirectionZ);
+			LevelMin = ClampLanes(VectorMin(EnterT, ExitT), Zero, One);
+			LevelMax = ClampLanes(VectorMax(EnterT, ExitT), Zero, One);
+		}
+		const VectorRegister4Float LevelT = ClampLanes(VectorMultiply(VectorNegate(HorizontalDot), InvHorizontalLengthSquared), LevelMin, VectorMax(LevelMin, LevelMax));
+
+		const VectorRegister4Float DistanceSquared = VectorMin(
+			AxisDistanceSquared(LevelT, RelativeX, RelativeY, RelativeZ, DirectionX, DirectionY, DirectionZ, HalfLength),
+			VectorMin(
+				AxisDistanceSquared(TopT, RelativeX, RelativeY, RelativeZ, DirectionX, DirectionY, DirectionZ, HalfLength),
+				AxisDistanceSquared(BottomT, RelativeX, RelativeY, RelativeZ, DirectionX, DirectionY, DirectionZ, HalfLength)));
+
+		const VectorRegister4Float Reach = VectorAdd(VectorLoad(RadiusData + Base), MarginV);
+		uint32 NearMask = static_cast<uint32>(VectorMaskBits(VectorCompareLE(DistanceSquared, VectorMultiply(Reach, Reach))));
+
+		while ( NearMask != 0 ) {
+			const int32 Index = Base + static_cast<int32>(FMath::CountTrailingZeros(NearMask));
+			NearMask &= NearMask - 1;
+			// The padding lanes past the last capsule are never reported
+			if ( Index < NumCapsules ) { OutCandidates.Add(Index); }
+		}
+	}
+}
+
+
+/**
+ * @brief Checks one capsule against a ray without vector instructions.
+ * @param Index The index of the capsule.
+ * @param RayStart The start of the ray.
+ * @param RayEnd The end of the ray.
+ * @param Margin The distance from the capsule's surface that still counts as near.
+ * @return True if the ray passes within the margin, false otherwise.
+ */
+bool FHitboxCapsuleSet::IsRayNear( const int32 Index, const FVector& RayStart, const FVector& RayEnd, const float Margin ) const {
+	const FVector Center(CenterX[Index], CenterY[Index], CenterZ[Index]);
+	const FVector AxisExtent(0.0, 0.0, AxisHalfLength[Index]);
+
+	FVector OnRay;
+	FVector OnAxis;
+	FMath::SegmentDistToSegmentSafe(RayStart, RayEnd, Center - AxisExtent, Center + AxisExtent, OnRay, OnAxis);
+	return FVector::DistSquared(OnRay, OnAxis) <= FMath::Square(Radius[Index] + Margin);
+}
@@ -0,0 +1,320 @@
+/**
+ * @file HitboxSubsystem.cpp
+ * @brief This file contains the implementation of the UHitboxSubsystem class.
+ */
+
+#include "CharacterAttributeModule/Hitbox/Public/HitboxSubsystem.h"
+#include "CharacterAttributeModule/Private/Logging.h"
+#include "CharacterAttributeModule/Private/Profiling.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Character.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarHitbox(
+	TEXT("LastShooter.Hitbox"),
+	true,
+	TEXT("Resolves weapon rays against characters through the packed hitbox layer instead of the general scene query."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarHitboxMargin(
+	TEXT("LastShooter.Hitbox.Margin"),
+	30.f,
+	TEXT("Extra distance around a character's capsule within which its physics asset is traced. Covers limbs and weapons outside the capsule."),
+	ECVF_Default);
+
+/** The number of characters the packed capsules are sized for up front. */
+static constexpr int32 ExpectedCharacters = 16;
+
+
+namespace Hitbox
+{
+#if !UE_BUILD_SHIPPING
+	/**
+	 * @brief Measures the packed broadphase against the scalar reference on a synthetic crowd and logs the throughput.
+	 * @param Args The number of characters and the number of rays, both optional.
+	 */
+	void RunBenchmark(const TArray<FString>& Args)
+	{
+		const int32 NumCharacters = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 128;
+		const int32 NumRays = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100000;
+		const float Margin = CVarHitboxMargin.GetValueOnGameThread();
+
+		// A fixed seed keeps runs comparable across builds and machines
+		FRandomStream Random(0x48495442);
+
+		// Characters spread over a 100 m square arena, standing on the floor
+		FHitboxCapsuleSet Capsules;
+		Capsules.Reserve(NumCharacters);
+		for ( int32 Index = 0; Index < NumCharacters; ++Index ) {
+			const FVector3f Center(Random.FRandRange(-5000.f, 5000.f), Random.FRandRange(-5000.f, 5000.f), 90.f);
+			Capsules.Add(Center, 90.f, 35.f);
+		}
+
+		// Shots fired from head height somewhere in the arena, mostly level, up to 50 m long
+		TArray<FVector> RayStarts;
+		TArray<FVector> RayEnds;
+		RayStarts.SetNumUninitialized(NumRays);
+		RayEnds.SetNumUninitialized(NumRays);
+		for ( int32 Ray = 0; Ray < NumRays; ++Ray ) {
+			RayStarts[Ray] = FVector(Random.FRandRange(-5000.f, 5000.f), Random.FRandRange(-5000.f, 5000.f), 160.f);
+			const FVector Direction = FVector(Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f), Random.FRandRange(-0.2f, 0.2f)).GetSafeNormal();
+			RayEnds[Ray] = RayStarts[Ray] + Direction * 5000.f;
+		}
+
+		FHitboxCandidates Candidates;
+		int64 PackedCandidates = 0;
+		const double PackedStart = FPlatformTime::Seconds();
+		for ( int32 Ray = 0; Ray < NumRays; ++Ray ) {
+			Capsules.FindRayCandidates(RayStarts[Ray], RayEnds[Ray], Margin, Candidates);
+			PackedCandidates += Candidates.Num();
+		}
+		const double PackedSeconds = FPlatformTime::Seconds() - PackedStart;
+
+		int64 ScalarCandidates = 0;
+		const double ScalarStart = FPlatformTime::Seconds();
+		for ( int32 Ray = 0; Ray < NumRays; ++Ray ) {
+			for ( int32 Index = 0; Index < NumCharacters; ++Index ) { ScalarCandidates += Capsules.IsRayNear(Index, RayStarts[Ray], RayEnds[Ray], Margin) ? 1 : 0; }
+		}
+		const double ScalarSeconds = FPlatformTime::Seconds() - ScalarStart;
+
+		UE_LOG(LogCharacterAttributeModule, Display, TEXT("Hitbox broadphase, %d characters, %d rays:"), NumCharacters, NumRays);
+		UE_LOG(LogCharacterAttributeModule, Display, TEXT("  packed: %.2f M rays/s (%.1f ns/ray), %lld candidates"), NumRays / FMath::Max(PackedSeconds, UE_DOUBLE_SMALL_NUMBER) * 1.e-6, PackedSeconds * 1.e9 / NumRays, PackedCandidates);
+		UE_LOG(LogCharacterAttributeModule, Display, TEXT("  scalar: %.2f M rays/s (%.1f ns/ray), %lld candidates"), NumRays / FMath::Max(ScalarSeconds, UE_DOUBLE_SMALL_NUMBER) * 1.e-6, ScalarSeconds * 1.e9 / NumRays, ScalarCandidates);
+
+		// Float rounding may flip a ray that grazes the margin, anything more is a bug in the packed test
+		if ( FMath::Abs(PackedCandidates - ScalarCandidates) > NumRays / 10000 + 1 ) {
+			UE_LOG(LogCharacterAttributeModule, Warning, TEXT("  packed and scalar candidates disagree"));
+		}
+	}
+#endif
+}
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommandWithArgs HitboxBenchmarkCommand(
+	TEXT("LastShooter.Hitbox.Benchmark"),
+	TEXT("Measures rays per second of the packed hitbox broadphase against the scalar test. Usage: LastShooter.Hitbox.Benchmark [Characters=128] [Rays=100000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&Hitbox::RunBenchmark));
+#endif
+
+
+/**
+ * @brief Adds a character to the hitbox layer.
+ * The capsule is watched so the packed capsules are rebuilt whenever it moves, whatever moved it.
+ * @param Character The character that can be shot.
+ */
+void UHitboxSubsystem::RegisterCharacter( ACharacter* Character ) {
+	if ( Character == nullptr || Characters.Contains(Character) ) { return; }
+
+	LLM_SCOPE_BYTAG(CharacterAttribute);
+	Characters.Add(Character);
+	if ( UCapsuleComponent* Capsule = Character->GetCapsuleComponent() ) { Capsule->TransformUpdated.AddUObject(this, &UHitboxSubsystem::OnCapsuleMoved); }
+	++RegistrationSerial;
+	Invalidate();
+}
+
+
+/**
+ * @brief Removes a character from the hitbox layer.
+ * @param Character The character to forget.
+ */
+void UHitboxSubsystem::UnregisterCharacter( const ACharacter* Character ) {
+	const int32 Index = Characters.IndexOfByKey(Character);
+	if ( Index == INDEX_NONE ) { return; }
+
+	if ( UCapsuleComponent* Capsule = Character->GetCapsuleComponent() ) { Capsule->TransformUpdated.RemoveAll(this); }
+	Characters.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	++RegistrationSerial;
+	Invalidate();
+}
+
+
+/**
+ * @brief Marks the packed capsules stale when a registered capsule moves.
+ * Movement runs after some rays of a frame may already have been traced, such as shots received before the tick.
+ * @param Component The capsule that moved.
+ * @param UpdateTransformFlags How the transform was updated.
+ * @param Teleport Whether the capsule was teleported.
+ */
+void UHitboxSubsystem::OnCapsuleMoved( USceneComponent* Component, const EUpdateTransformFlags UpdateTransformFlags, const ETeleportType Teleport ) { Invalidate(); }
+
+
+/**
+ * @brief Traces a character as if it stood elsewhere until ClearRewinds is called, without moving it.
+ * @param Character The registered character.
+ * @param Offset How far its hitbox is shifted from where it stands.
+ */
+void UHitboxSubsystem::AddRewind( const ACharacter* Character, const FVector& Offset ) {
+	Rewinds.Add({ Character, Offset });
+	Invalidate();
+}
+
+
+/**
+ * @brief Traces every character where it stands again.
+ */
+void UHitboxSubsystem::ClearRewinds() {
+	if ( Rewinds.Num() == 0 ) { return; }
+
+	Rewinds.Reset();
+	Invalidate();
+}
+
+
+/**
+ * @brief Gets how far a character's hitbox is shifted by the rewind in progress.
+ * @param Character The character.
+ * @return The offset, zero if the character is not rewound.
+ */
+FVector UHitboxSubsystem::GetRewindOffset( const ACharacter* Character ) const {
+	for ( const FRewind& Rewind : Rewinds ) {
+		if ( Rewind.Character == Character ) { return Rewind.Offset; }
+	}
+	return FVector::ZeroVector;
+}
+
+
+/**
+ * @brief Gets whether weapon rays resolve characters through the hitbox layer.
+ * @return True while LastShooter.Hitbox is enabled, false otherwise.
+ */
+bool UHitboxSubsystem::IsEnabled() { return CVarHitbox.GetValueOnGameThread(); }
+
+
+/**
+ * @brief Ignores every registered character in the world part of a weapon trace, since the layer resolves them.
+ * Pawns that never registered, such as those of other modules, keep their visibility response and are hit as before.
+ * @param Params The query parameters to extend.
+ */
+void UHitboxSubsystem::AddIgnoredCharacters( FCollisionQueryParams& Params ) const {
+	for ( const ACharacter* Character : Characters ) {
+		if ( IsValid(Character) ) { Params.AddIgnoredActor(Character); }
+	}
+}
+
+
+/**
+ * @brief Packs the capsule of every registered character unless nothing moved since the last pack this frame.
+ * Characters without collision, such as pooled or dead ones, are left out. Rewound characters are packed at their offset.
+ */
+void UHitboxSubsystem::PackCapsules() {
+	if ( PackedFrame == GFrameCounter ) { return; }
+	PackedFrame = GFrameCounter;
+
+	Capsules.Reset();
+	CapsuleCharacters.Reset();
+	CapsuleOffsets.Reset();
+
+	for ( ACharacter* Character : Characters ) {
+		const UCapsuleComponent* Capsule = IsValid(Character) ? Character->GetCapsuleComponent() : nullptr;
+		if ( Capsule == nullptr || !Character->GetActorEnableCollision() ) { continue; }
+
+		const FVector Offset = GetRewindOffset(Character);
+		Capsules.Add(FVector3f(Capsule->GetComponentLocation() + Offset), Capsule->GetScaledCapsuleHalfHeight(), Capsule->GetScaledCapsuleRadius());
+		CapsuleCharacters.Add(Character);
+		CapsuleOffsets.Add(Offset);
+	}
+}
+
+
+/**
+ * @brief Traces a ray against the registered characters.
+ * The packed capsules reject the characters far from the ray and only the few left are traced precisely.
+ * @param RayStart The start of the ray.
+ * @param RayEnd The end of the ray.
+ * @param Params The query parameters of the weapon trace. Ignored actors are never hit.
+ * @param OutHit Receives the nearest character hit.
+ * @return True if a character was hit, false otherwise.
+ */
+bool UHitboxSubsystem::TraceCharacters( const FVector& RayStart, const FVector& RayEnd, const FCollisionQueryParams& Params, FHitResult& OutHit ) {
+	CHARACTERATTRIBUTE_SCOPE(HitboxTrace);
+
+	PackCapsules();
+
+	FHitboxCandidates Candidates;
+	Capsules.FindRayCandidates(RayStart, RayEnd, CVarHitboxMargin.GetValueOnGameThread(), Candidates);
+	CSV_CUSTOM_STAT(CharacterAttribute, HitboxCandidates, Candidates.Num(), ECsvCustomStatOp::Accumulate);
+
+	bool bHit = false;
+	for ( const int32 Index : Candidates ) {
+		ACharacter* Character = CapsuleCharacters[Index];
+		if ( !IsValid(Character) || Params.GetIgnoredActors().Contains(Character->GetUniqueID()) ) { continue; }
+
+		FHitResult CharacterHit;
+		if ( TraceCharacter(Character, CapsuleOffsets[Index], RayStart, RayEnd, Params, CharacterHit) && (!bHit || CharacterHit.Time < OutHit.Time) ) {
+			OutHit = CharacterHit;
+			bHit = true;
+		}
+	}
+	return bHit;
+}
+
+
+/**
+ * @brief Traces a ray precisely against one character.
+ * The physics asset of the mesh is traced when it has query collision, otherwise the capsule stands in for it.
+ * A shifted character is traced by shifting the ray the other way and the hit back, so nothing has to move.
+ * @param Character The character.
+ * @param Offset How far the character's hitbox is shifted from where it stands.
+ * @param RayStart The start of the ray.
+ * @param RayEnd The end of the ray.
+ * @param Params The query parameters of the weapon trace.
+ * @param OutHit Receives the hit.
+ * @return True if the character was hit, false otherwise.
+ */
+bool UHitboxSubsystem::TraceCharacter( ACharacter* Character, const FVector& Offset, const FVector& RayStart, const FVector& RayEnd, const FCollisionQueryParams& Params, FHitResult& OutHit ) {
+	USkeletalMeshComponent* Mesh = Character->GetMesh();
+	const bool bUsePhysicsAsset = Mesh && Mesh->GetPhysicsAsset() && Mesh->IsQueryCollisionEnabled();
+	UPrimitiveComponent* HitboxComponent = bUsePhysicsAsset ? static_cast<UPrimitiveComponent*>(Mesh) : Character->GetCapsuleComponent();
+	if ( HitboxComponent == nullptr || !HitboxComponent->LineTraceComponent(OutHit, RayStart - Offset, RayEnd - Offset, Params) ) { return false; }
+
+	// The ray keeps its length, so only the points move back to where the hitbox was traced
+	OutHit.Location += Offset;
+	OutHit.ImpactPoint += Offset;
+	OutHit.TraceStart = RayStart;
+	OutHit.TraceEnd = RayEnd;
+	OutHit.bBlockingHit = true;
+	return true;
+}
+
+
+/**
+ * @brief Sizes the packed capsules for a typical match up front.
+ * @param Collection The collection of subsystems being initialized.
+ */
+void UHitboxSubsystem::Initialize( FSubsystemCollectionBase& Collection ) {
+	Super::Initialize(Collection);
+
+	LLM_SCOPE_BYTAG(CharacterAttribute);
+	Characters.Reserve(ExpectedCharacters);
+	CapsuleCharacters.Reserve(ExpectedCharacters);
+	CapsuleOffsets.Reserve(ExpectedCharacters);
+	Capsules.Reserve(ExpectedCharacters);
+}
+
+
+/**
+ * @brief Forgets every character before the world goes away.
+ */
+void UHitboxSubsystem::Deinitialize() {
+	for ( const ACharacter* Character : Characters ) {
+		UCapsuleComponent* Capsule = IsValid(Character) ? Character->GetCapsuleComponent() : nullptr;
+		if ( Capsule ) { Capsule->TransformUpdated.RemoveAll(this); }
+	}
+	Characters.Empty();
+	CapsuleCharacters.Empty();
+	CapsuleOffsets.Empty();
+	Rewinds.Empty();
+	Capsules.Reset();
+	Invalidate();
+
+	Super::Deinitialize();
+}
+
+
+/**
+ * @brief The hitbox layer only applies to worlds that actually play.
+ * @param WorldType The type of the world the subsystem would be created for.
+ * @return True for game and PIE worlds, false otherwise.
+ */
+bool UHitboxSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const { return WorldType == EWorldType::Game || WorldType == EWorldType::PIE; }
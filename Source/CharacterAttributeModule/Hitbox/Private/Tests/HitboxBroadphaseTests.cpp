@@ -0,0 +1,84 @@
+/**
+ * @file HitboxBroadphaseTests.cpp
+ * @brief This file contains the automation tests of the FHitboxCapsuleSet struct.
+ */
+
+#include "CharacterAttributeModule/Hitbox/Public/HitboxBroadphase.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitboxBroadphaseExactTest, "LastShooter.Hitbox.Broadphase.MatchesBruteForce", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Compares the packed candidates of random rays with the exact segment distance to every capsule axis.
+ *
+ * Every capsule well inside the reach must be reported and every capsule well outside it must not. Only capsules
+ * within the float rounding of the packed test may go either way. The rays include vertical and level ones, short ones
+ * and ones grazing the end caps, which the closed form has to get right as well as the general case.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FHitboxBroadphaseExactTest::RunTest( const FString& Parameters ) {
+	constexpr int32 NumCapsules = 37;
+	constexpr int32 NumRays = 20000;
+	constexpr float Margin = 30.f;
+	constexpr double Tolerance = 0.05;
+
+	// A fixed seed keeps failures reproducible
+	FRandomStream Random(0x45584354);
+
+	struct FCapsule
+	{
+		FVector Center;
+		float HalfHeight;
+		float Radius;
+	};
+	TArray<FCapsule> Reference;
+	FHitboxCapsuleSet Capsules;
+	for ( int32 Index = 0; Index < NumCapsules; ++Index ) {
+		const FCapsule& Capsule = Reference.Add_GetRef({ FVector(Random.FRandRange(-600.f, 600.f), Random.FRandRange(-600.f, 600.f), Random.FRandRange(-100.f, 200.f)), Random.FRandRange(20.f, 120.f), Random.FRandRange(10.f, 50.f) });
+		Capsules.Add(FVector3f(Capsule.Center), Capsule.HalfHeight, Capsule.Radius);
+	}
+
+	int32 NumMissed = 0;
+	int32 NumExtra = 0;
+	int32 NumReported = 0;
+	FHitboxCandidates Candidates;
+	for ( int32 Ray = 0; Ray < NumRays; ++Ray ) {
+		const FVector RayStart(Random.FRandRange(-800.f, 800.f), Random.FRandRange(-800.f, 800.f), Random.FRandRange(-300.f, 400.f));
+		FVector Delta(Random.FRandRange(-1500.f, 1500.f), Random.FRandRange(-1500.f, 1500.f), Random.FRandRange(-600.f, 600.f));
+		switch ( Ray % 8 ) {
+			case 0: Delta.X = 0.0; Delta.Y = 0.0; break;
+			case 1: Delta.Z = 0.0; break;
+			case 2: Delta *= 0.02; break;
+			case 3: Delta.Z *= 0.001; break;
+			default: break;
+		}
+		const FVector RayEnd = RayStart + Delta;
+
+		Capsules.FindRayCandidates(RayStart, RayEnd, Margin, Candidates);
+		NumReported += Candidates.Num();
+
+		for ( int32 Index = 0; Index < NumCapsules; ++Index ) {
+			const FCapsule& Capsule = Reference[Index];
+			const FVector AxisExtent(0.0, 0.0, FMath::Max(Capsule.HalfHeight - Capsule.Radius, 0.f));
+			FVector OnRay;
+			FVector OnAxis;
+			FMath::SegmentDistToSegmentSafe(RayStart, RayEnd, Capsule.Center - AxisExtent, Capsule.Center + AxisExtent, OnRay, OnAxis);
+			const double Distance = FVector::Dist(OnRay, OnAxis);
+			const double Reach = Capsule.Radius + Margin;
+
+			const bool bReported = Candidates.Contains(Index);
+			if ( Distance <= Reach - Tolerance && !bReported ) { ++NumMissed; }
+			if ( Distance > Reach + Tolerance && bReported ) { ++NumExtra; }
+		}
+	}
+
+	TestEqual(TEXT("Capsules the ray passes within reach of are reported"), NumMissed, 0);
+	TestEqual(TEXT("Capsules out of reach are not reported"), NumExtra, 0);
+	TestTrue(TEXT("The rays report some capsules at all"), NumReported > 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file HitboxBroadphase.h
+ * @brief This file contains the declaration of the FHitboxCapsuleSet struct.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The capsules a ray passes near. Sized so a shot into a crowd does not allocate. */
+using FHitboxCandidates = TArray<int32, TInlineAllocator<16>>;
+
+/**
+ * @struct FHitboxCapsuleSet
+ * @brief Upright capsule hitboxes packed structure-of-arrays so a ray is tested against four of them at a time.
+ *
+ * Every array is padded to a multiple of four so the vector loop never needs a scalar tail.
+ * The padding lanes are never reported.
+ */
+struct CHARACTERATTRIBUTEMODULE_API FHitboxCapsuleSet
+{
+	/** The number of capsules tested by one vector iteration. */
+	static constexpr int32 LaneCount = 4;
+
+	/**
+	 * @brief Removes every capsule but keeps the memory for the next refresh.
+	 */
+	void Reset();
+
+	/**
+	 * @brief Reserves room for a number of capsules.
+	 * @param NumToReserve The number of capsules to make room for.
+	 */
+	void Reserve(int32 NumToReserve);
+
+	/**
+	 * @brief Adds an upright capsule.
+	 * @param Center The centre of the capsule.
+	 * @param HalfHeight The half height of the capsule, including the hemispheres.
+	 * @param InRadius The radius of the capsule.
+	 * @return The index of the capsule.
+	 */
+	int32 Add(const FVector3f& Center, float HalfHeight, float InRadius);
+
+	/**
+	 * @brief Gets the number of capsules in the set.
+	 * @return The number of capsules.
+	 */
+	FORCEINLINE int32 Num() const { return NumCapsules; }
+
+	/**
+	 * @brief Finds every capsule a ray passes within a margin of, testing four capsules per iteration.
+	 * @param RayStart The start of the ray.
+	 * @param RayEnd The end of the ray.
+	 * @param Margin The distance from a capsule's surface that still counts as near.
+	 * @param OutCandidates Receives the indices of the capsules near the ray, in ascending order.
+	 */
+	void FindRayCandidates(const FVector& RayStart, const FVector& RayEnd, float Margin, FHitboxCandidates& OutCandidates) const;
+
+	/**
+	 * @brief Checks one capsule against a ray without vector instructions. The reference FindRayCandidates is measured against.
+	 * @param Index The index of the capsule.
+	 * @param RayStart The start of the ray.
+	 * @param RayEnd The end of the ray.
+	 * @param Margin The distance from the capsule's surface that still counts as near.
+	 * @return True if the ray passes within the margin, false otherwise.
+	 */
+	bool IsRayNear(int32 Index, const FVector& RayStart, const FVector& RayEnd, float Margin) const;
+
+private:
+	/** The number of capsules added, excluding the padding lanes. */
+	int32 NumCapsules = 0;
+
+	/** The centre of every capsule, one array per axis. */
+	TArray<float> CenterX;
+	TArray<float> CenterY;
+	TArray<float> CenterZ;
+
+	/** Half the length of every capsule's axis, the half height without the hemispheres. */
+	TArray<float> AxisHalfLength;
+
+	/** The radius of every capsule. */
+	TArray<float> Radius;
+};
@@ -0,0 +1,168 @@
+/**
+ * @file HitboxSubsystem.h
+ * @brief This file contains the declaration of the UHitboxSubsystem class.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Components/SceneComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CharacterAttributeModule/Hitbox/Public/HitboxBroadphase.h"
+#include "HitboxSubsystem.generated.h"
+
+class ACharacter;
+
+/**
+ * @class UHitboxSubsystem
+ * @brief The combat hitbox layer: resolves weapon rays against characters without going through the general scene query.
+ *
+ * The capsule of every registered character is packed into an FHitboxCapsuleSet the first time a ray is traced after
+ * a frame starts or a registered capsule moves, so rays never test stale capsules. A ray is tested against the packed capsules four at a time and only the characters it passes
+ * near are traced precisely against their physics asset. The general weapon trace ignores the registered characters
+ * and still hits every other pawn.
+ * Lag compensation shifts the hitboxes of rewound characters through AddRewind; the characters themselves never move.
+ */
+UCLASS()
+class CHARACTERATTRIBUTEMODULE_API UHitboxSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief Adds a character to the hitbox layer.
+	 * @param Character The character that can be shot.
+	 */
+	void RegisterCharacter(ACharacter* Character);
+
+	/**
+	 * @brief Removes a character from the hitbox layer.
+	 * @param Character The character to forget.
+	 */
+	void UnregisterCharacter(const ACharacter* Character);
+
+	/**
+	 * @brief Forces the packed capsules to be rebuilt before the next ray.
+	 */
+	FORCEINLINE void Invalidate() { PackedFrame = MAX_uint64; }
+
+	/**
+	 * @brief Traces a character as if it stood elsewhere until ClearRewinds is called, without moving it.
+	 * @param Character The registered character.
+	 * @param Offset How far its hitbox is shifted from where it stands.
+	 */
+	void AddRewind(const ACharacter* Character, const FVector& Offset);
+
+	/**
+	 * @brief Traces every character where it stands again.
+	 */
+	void ClearRewinds();
+
+	/**
+	 * @brief Gets whether any character is traced somewhere else than where it stands.
+	 * @return True between AddRewind and ClearRewinds, false otherwise.
+	 */
+	FORCEINLINE bool IsRewinding() const { return Rewinds.Num() > 0; }
+
+	/**
+	 * @brief Gets whether weapon rays resolve characters through the hitbox layer.
+	 * @return True while LastShooter.Hitbox is enabled, false otherwise.
+	 */
+	static bool IsEnabled();
+
+	/**
+	 * @brief Ignores every registered character in the world part of a weapon trace, since the layer resolves them.
+	 * @param Params The query parameters to extend.
+	 */
+	void AddIgnoredCharacters(FCollisionQueryParams& Params) const;
+
+	/**
+	 * @brief Gets a number that changes whenever a character registers or unregisters.
+	 * @return The serial, which tells when parameters extended by AddIgnoredCharacters are stale.
+	 */
+	FORCEINLINE uint32 GetRegistrationSerial() const { return RegistrationSerial; }
+
+	/**
+	 * @brief Traces a ray against the registered characters.
+	 * @param RayStart The start of the ray.
+	 * @param RayEnd The end of the ray.
+	 * @param Params The query parameters of the weapon trace. Ignored actors are never hit.
+	 * @param OutHit Receives the nearest character hit.
+	 * @return True if a character was hit, false otherwise.
+	 */
+	bool TraceCharacters(const FVector& RayStart, const FVector& RayEnd, const FCollisionQueryParams& Params, FHitResult& OutHit);
+
+	/**
+	 * @brief Sizes the packed capsules for a typical match up front.
+	 * @param Collection The collection of subsystems being initialized.
+	 */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * @brief Packs the capsule of every registered character unless it was already packed this frame.
+	 */
+	void PackCapsules();
+
+	/**
+	 * @brief Marks the packed capsules stale when a registered capsule moves.
+	 * @param Component The capsule that moved.
+	 * @param UpdateTransformFlags How the transform was updated.
+	 * @param Teleport Whether the capsule was teleported.
+	 */
+	void OnCapsuleMoved(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	/**
+	 * @brief Gets how far a character's hitbox is shifted by the rewind in progress.
+	 * @param Character The character.
+	 * @return The offset, zero if the character is not rewound.
+	 */
+	FVector GetRewindOffset(const ACharacter* Character) const;
+
+	/**
+	 * @brief Traces a ray precisely against one character.
+	 * @param Character The character.
+	 * @param Offset How far the character's hitbox is shifted from where it stands.
+	 * @param RayStart The start of the ray.
+	 * @param RayEnd The end of the ray.
+	 * @param Params The query parameters of the weapon trace.
+	 * @param OutHit Receives the hit.
+	 * @return True if the character was hit, false otherwise.
+	 */
+	static bool TraceCharacter(ACharacter* Character, const FVector& Offset, const FVector& RayStart, const FVector& RayEnd, const FCollisionQueryParams& Params, FHitResult& OutHit);
+
+	/** The registered characters. */
+	UPROPERTY()
+	TArray<ACharacter*> Characters;
+
+	/** The capsules of the characters with collision, as of the last pack. */
+	FHitboxCapsuleSet Capsules;
+
+	/** The character of every packed capsule, parallel to Capsules. */
+	TArray<ACharacter*> CapsuleCharacters;
+
+	/** The rewind offset of every packed capsule, parallel to Capsules. */
+	TArray<FVector> CapsuleOffsets;
+
+	/** A character traced elsewhere than where it stands, and how far. */
+	struct FRewind
+	{
+		const ACharacter* Character;
+		FVector Offset;
+	};
+
+	/** The characters the rewind in progress shifts. Sized so rewinding a crowd does not allocate. */
+	TArray<FRewind, TInlineAllocator<8>> Rewinds;
+
+	/** The frame the capsules were last packed on, or MAX_uint64 if they must be packed again. */
+	uint64 PackedFrame = MAX_uint64;
+
+	/** Bumped whenever a character registers or unregisters. */
+	uint32 RegistrationSerial = 0;
+};
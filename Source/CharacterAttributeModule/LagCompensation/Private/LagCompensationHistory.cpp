@@ -0,0 +1,174 @@
+/**
+ * @file LagCompensationHistory.cpp
+ * @brief This file contains the implementation of the FLagCompensationHistory struct.
+ */
+
+#include "CharacterAttributeModule/LagCompensation/Public/LagCompensationHistory.h"
+#include "CharacterAttributeModule/Private/Profiling.h"
+
+namespace LagCompensation
+{
+	/**
+	 * @brief Measures how far a ray passes from a capsule's surface.
+	 * @param Sample The capsule.
+	 * @param RayStart The start of the ray.
+	 * @param RayEnd The end of the ray.
+	 * @return The distance from the ray to the capsule's surface, negative if the ray passes through it.
+	 */
+	FORCEINLINE double DistanceToCapsule(const FLagCompensationSample& Sample, const FVector& RayStart, const FVector& RayEnd)
+	{
+		const FVector Center(Sample.Center);
+		const FVector AxisExtent(0.0, 0.0, FMath::Max(Sample.HalfHeight - Sample.Radius, 0.f));
+
+		FVector OnRay;
+		FVector OnAxis;
+		FMath::SegmentDistToSegmentSafe(RayStart, RayEnd, Center - AxisExtent, Center + AxisExtent, OnRay, OnAxis);
+		return FVector::Dist(OnRay, OnAxis) - Sample.Radius;
+	}
+
+	/**
+	 * @brief Checks whether any of a set of rays passes near a capsule.
+	 * @param Sample The capsule.
+	 * @param RayStart The start shared by every ray.
+	 * @param RayEnds The end of every ray.
+	 * @param Margin The distance from the capsule's surface that still counts as near.
+	 * @return True if a ray passes within the margin, false otherwise.
+	 */
+	FORCEINLINE bool IsNearAnyRay(const FLagCompensationSample& Sample, const FVector& RayStart, const TConstArrayView<FVector> RayEnds, const double Margin)
+	{
+		for ( const FVector& RayEnd : RayEnds ) {
+			if ( DistanceToCapsule(Sample, RayStart, RayEnd) <= Margin ) { return true; }
+		}
+		return false;
+	}
+}
+
+
+/**
+ * @brief Sizes the rings and forgets everything recorded.
+ * @param InHistoryLength The number of frames every ring holds.
+ * @param ExpectedSlots The number of slots to reserve memory for.
+ */
+void FLagCompensationHistory::Init( const int32 InHistoryLength, const int32 ExpectedSlots ) {
+	HistoryLength = FMath::Max(InHistoryLength, 1);
+	NewestFrame = INDEX_NONE;
+	NumFrames = 0;
+
+	LLM_SCOPE_BYTAG(CharacterAttribute);
+	FrameTimes.SetNumZeroed(HistoryLength);
+	Samples.Reset();
+	Samples.Reserve(HistoryLength * ExpectedSlots);
+}
+
+
+/**
+ * @brief Frees the memory of every ring.
+ */
+void FLagCompensationHistory::Reset() {
+	Samples.Empty();
+	FrameTimes.Empty();
+	NewestFrame = INDEX_NONE;
+	NumFrames = 0;
+}
+
+
+/**
+ * @brief Appends a slot with an empty ring.
+ * @return The index of the slot.
+ */
+int32 FLagCompensationHistory::AddSlot() {
+	LLM_SCOPE_BYTAG(CharacterAttribute);
+	const int32 Slot = Samples.Num() / HistoryLength;
+	Samples.AddDefaulted(HistoryLength);
+	return Slot;
+}
+
+
+/**
+ * @brief Empties the ring of a slot so no frames of its previous owner are looked up.
+ * @param Slot The slot to clear.
+ */
+void FLagCompensationHistory::ClearSlot( const int32 Slot ) {
+	for ( int32 Frame = 0; Frame < HistoryLength; ++Frame ) { Samples[Slot * HistoryLength + Frame] = FLagCompensationSample(); }
+}
+
+
+/**
+ * @brief Starts the next frame of the rings, overwriting the oldest one once the rings are full.
+ * @param Time The server time of the frame.
+ */
+void FLagCompensationHistory::BeginFrame( const double Time ) {
+	NewestFrame = (NewestFrame + 1) % HistoryLength;
+	NumFrames = FMath::Min(NumFrames + 1, HistoryLength);
+	FrameTimes[NewestFrame] = Time;
+}
+
+
+/**
+ * @brief Gets the hitbox of a slot at a past time.
+ * The time is clamped to the recorded history and the hitbox is interpolated between the two frames around it.
+ * A frame in which the slot had no hitbox is only used if the time falls exactly on it.
+ * @param Slot The slot.
+ * @param Timestamp The server time to look up.
+ * @param OutSample Receives the hitbox.
+ * @return True if the slot has a hitbox at that time, false otherwise.
+ */
+bool FLagCompensationHistory::GetSampleAt( const int32 Slot, const double Timestamp, FLagCompensationSample& OutSample ) const {
+	if ( NumFrames == 0 ) { return false; }
+
+	// Walk back from the newest frame to the first one at or before the requested time
+	int32 Newer = NewestFrame;
+	int32 Older = NewestFrame;
+	for ( int32 Step = 1; Step < NumFrames && FrameTimes[Older] > Timestamp; ++Step ) {
+		Newer = Older;
+		Older = (Older + HistoryLength - 1) % HistoryLength;
+	}
+
+	const FLagCompensationSample& OlderSample = GetSample(Slot, Older);
+	const FLagCompensationSample& NewerSample = GetSample(Slot, Newer);
+
+	// Past either end of the history, or across a gap in the slot's recording, use the nearest frame as is
+	const double Span = FrameTimes[Newer] - FrameTimes[Older];
+	if ( Older == Newer || Span <= 0.0 || !OlderSample.IsValid() || !NewerSample.IsValid() ) {
+		OutSample = FrameTimes[Older] >= Timestamp || !NewerSample.IsValid() ? OlderSample : NewerSample;
+		return OutSample.IsValid();
+	}
+
+	const float Alpha = static_cast<float>(FMath::Clamp((Timestamp - FrameTimes[Older]) / Span, 0.0, 1.0));
+	OutSample.Center = FMath::Lerp(OlderSample.Center, NewerSample.Center, Alpha);
+	OutSample.HalfHeight = FMath::Lerp(OlderSample.HalfHeight, NewerSample.HalfHeight, Alpha);
+	OutSample.Radius = FMath::Lerp(OlderSample.Radius, NewerSample.Radius, Alpha);
+	return true;
+}
+
+
+/**
+ * @brief Bounds the time a shooter claims to have fired at by how late its view can be.
+ * A client can stamp its shots with any time; without the bound it could pick whichever recorded frame suits it.
+ * @param Timestamp The server time the shooter claims.
+ * @param Now The current server time.
+ * @param MaxRewindSeconds The furthest the shooter can see into the past.
+ * @return The time to rewind to.
+ */
+double FLagCompensationHistory::ClampRewindTime( const double Timestamp, const double Now, const double MaxRewindSeconds ) {
+	return FMath::Clamp(Timestamp, Now - FMath::Max(MaxRewindSeconds, 0.0), Now);
+}
+
+
+/**
+ * @brief Decides whether a shot rewinds a character and by how much.
+ * @param Current The hitbox of the character now.
+ * @param Rewound The hitbox of the character at the time of the shot.
+ * @param RayStart The start shared by every ray.
+ * @param RayEnds The end of every ray.
+ * @param Margin The distance from a capsule's surface that still counts as near.
+ * @param OutOffset Receives how far the hitbox moves from where it is now to where it was.
+ * @return True if the character is rewound, false otherwise.
+ */
+bool FLagCompensationHistory::GetRewindOffset( const FLagCompensationSample& Current, const FLagCompensationSample& Rewound, const FVector& RayStart, const TConstArrayView<FVector> RayEnds, const double Margin, FVector& OutOffset ) {
+	if ( !Current.IsValid() || !Rewound.IsValid() ) { return false; }
+	if ( !LagCompensation::IsNearAnyRay(Current, RayStart, RayEnds, Margin) && !LagCompensation::IsNearAnyRay(Rewound, RayStart, RayEnds, Margin) ) { return false; }
+
+	OutOffset = FVector(Rewound.Center) - FVector(Current.Center);
+	return true;
+}
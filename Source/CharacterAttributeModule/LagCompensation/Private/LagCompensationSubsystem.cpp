@@ -0,0 +1,339 @@
+/**
+ * @file LagCompensationSubsystem.cpp
+ * @brief This file contains the implementation of the ULagCompensationSubsystem class.
+ */
+
+#include "CharacterAttributeModule/LagCompensation/Public/LagCompensationSubsystem.h"
+#include "CharacterAttributeModule/Hitbox/Public/HitboxSubsystem.h"
+#include "CharacterAttributeModule/Private/Logging.h"
+#include "CharacterAttributeModule/Private/Profiling.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarLagCompensation(
+	TEXT("LastShooter.LagCompensation"),
+	true,
+	TEXT("Validates shots on the server against character hitboxes rewound to the time the shooter fired."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLagCompensationRecordRate(
+	TEXT("LastShooter.LagCompensation.RecordRate"),
+	30.f,
+	TEXT("Hitbox history frames recorded per second. Read when the world starts."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLagCompensationHistorySeconds(
+	TEXT("LastShooter.LagCompensation.HistorySeconds"),
+	1.f,
+	TEXT("Seconds of hitbox history kept per character, and the furthest a shot can be rewound. Read when the world starts."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLagCompensationPingSlack(
+	TEXT("LastShooter.LagCompensation.PingSlack"),
+	0.1f,
+	TEXT("Seconds a shot may be rewound beyond the shooter's round trip time and proxy smoothing delay, covering jitter."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLagCompensationCandidateMargin(
+	TEXT("LastShooter.LagCompensation.CandidateMargin"),
+	50.f,
+	TEXT("Extra distance around a capsule within which a shot rewinds its character."),
+	ECVF_Default);
+
+#if !UE_BUILD_SHIPPING
+static TAutoConsoleVariable<bool> CVarLagCompensationDebug(
+	TEXT("LastShooter.LagCompensation.Debug"),
+	false,
+	TEXT("Logs every character a shot rewinds and how far its hitbox was shifted."),
+	ECVF_Cheat);
+#endif
+
+/** The number of slots the history is sized for up front. More slots grow the array once when they register. */
+static constexpr int32 ExpectedCharacters = 16;
+
+
+namespace LagCompensation
+{
+	/**
+	 * @brief Gets the current server time of a world, on the same clock clients stamp their shots with.
+	 * @param World The world to read.
+	 * @return The server time in seconds.
+	 */
+	FORCEINLINE double GetServerTime(const UWorld* World)
+	{
+		const AGameStateBase* GameState = World->GetGameState();
+		return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+	}
+
+	/**
+	 * @brief Reads the current hitbox of a character.
+	 * @param Character The character to read.
+	 * @return The hitbox, or an invalid sample if the character has no collision.
+	 */
+	FORCEINLINE FLagCompensationSample MakeSample(const ACharacter* Character)
+	{
+		FLagCompensationSample Sample;
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		if ( Capsule == nullptr || !Character->GetActorEnableCollision() ) { return Sample; }
+
+		Sample.Center = FVector3f(Capsule->GetComponentLocation());
+		Sample.HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+		Sample.Radius = Capsule->GetScaledCapsuleRadius();
+		return Sample;
+	}
+}
+
+
+/**
+ * @brief Rewinds the candidate characters of a shot.
+ * @param InSubsystem The subsystem holding the history.
+ * @param Timestamp The server time the shooter fired at.
+ * @param RayStart The start of the shot.
+ * @param RayEnd The end of the shot.
+ * @param Shooter The character firing, which is never rewound.
+ */
+FLagCompensationRewindScope::FLagCompensationRewindScope( ULagCompensationSubsystem* InSubsystem, const double Timestamp, const FVector& RayStart, const FVector& RayEnd, const AActor* Shooter )
+	: FLagCompensationRewindScope(InSubsystem, Timestamp, RayStart, MakeArrayView(&RayEnd, 1), Shooter) {}
+
+
+/**
+ * @brief Rewinds the candidate characters of a shot with several pellets from one origin.
+ * @param InSubsystem The subsystem holding the history.
+ * @param Timestamp The server time the shooter fired at.
+ * @param RayStart The start shared by every pellet.
+ * @param RayEnds The end of every pellet.
+ * @param Shooter The character firing, which is never rewound.
+ */
+FLagCompensationRewindScope::FLagCompensationRewindScope( ULagCompensationSubsystem* InSubsystem, const double Timestamp, const FVector& RayStart, const TConstArrayView<FVector> RayEnds, const AActor* Shooter ) {
+	if ( InSubsystem && InSubsystem->IsActive() ) { InSubsystem->Rewind(*this, Timestamp, RayStart, RayEnds, Shooter); }
+}
+
+
+/**
+ * @brief Ends the shift of every rewound character. Nothing was moved, so nothing has to be put back.
+ */
+FLagCompensationRewindScope::~FLagCompensationRewindScope() {
+	if ( Hitboxes ) { Hitboxes->ClearRewinds(); }
+}
+
+
+/**
+ * @brief Starts recording a character's hitbox.
+ * Reuses a freed slot if there is one and clears its ring so no stale frames of the previous character are rewound to.
+ * @param Character The character to record.
+ */
+void ULagCompensationSubsystem::RegisterCharacter( ACharacter* Character ) {
+	if ( Character == nullptr || Characters.Contains(Character) ) { return; }
+
+	if ( FreeSlots.Num() > 0 ) {
+		const int32 Slot = FreeSlots.Pop(EAllowShrinking::No);
+		Characters[Slot] = Character;
+		History.ClearSlot(Slot);
+	}
+	else {
+		LLM_SCOPE_BYTAG(CharacterAttribute);
+		Characters.Add(Character);
+		History.AddSlot();
+	}
+}
+
+
+/**
+ * @brief Stops recording a character's hitbox and frees its ring.
+ * @param Character The character to forget.
+ */
+void ULagCompensationSubsystem::UnregisterCharacter( const ACharacter* Character ) {
+	const int32 Slot = Characters.IndexOfByKey(Character);
+	if ( Slot == INDEX_NONE ) { return; }
+
+	Characters[Slot] = nullptr;
+	FreeSlots.Add(Slot);
+}
+
+
+/**
+ * @brief Gets the hitbox of a character at a past time.
+ * @param Character The registered character.
+ * @param Timestamp The server time to look up.
+ * @param OutSample Receives the hitbox.
+ * @return True if the character has a hitbox at that time, false otherwise.
+ */
+bool ULagCompensationSubsystem::GetSampleAt( const ACharacter* Character, const double Timestamp, FLagCompensationSample& OutSample ) const {
+	const int32 Slot = Characters.IndexOfByKey(Character);
+	return Slot != INDEX_NONE && History.GetSampleAt(Slot, Timestamp, OutSample);
+}
+
+
+/**
+ * @brief Gets whether lag compensation is active in this world.
+ * Clients and standalone games trace against what they see, so there is nothing to rewind.
+ * @return True on servers with LastShooter.LagCompensation enabled, false otherwise.
+ */
+bool ULagCompensationSubsystem::IsActive() const {
+	const ENetMode NetMode = GetWorld()->GetNetMode();
+	return (NetMode == NM_DedicatedServer || NetMode == NM_ListenServer) && CVarLagCompensation.GetValueOnGameThread();
+}
+
+
+/**
+ * @brief Gets how far back a shooter can see.
+ * Remote characters reach a client a one-way trip late and its shot reaches the server another one-way trip later,
+ * so the shooter saw them about a round trip ago, plus the time the client spends smoothing them, which its shots
+ * take off their timestamp.
+ * @param Shooter The character firing.
+ * @return The furthest a shot of the shooter may be rewound, in seconds.
+ */
+double ULagCompensationSubsystem::GetMaxRewindSeconds( const AActor* Shooter ) {
+	const APawn* ShooterPawn = Cast<APawn>(Shooter);
+	const APlayerState* PlayerState = ShooterPawn ? ShooterPawn->GetPlayerState() : nullptr;
+	const double PingSeconds = PlayerState ? PlayerState->GetPingInMilliseconds() * 0.001 : 0.0;
+	return PingSeconds + GetProxyRenderDelaySeconds(Shooter) + CVarLagCompensationPingSlack.GetValueOnGameThread();
+}
+
+
+/**
+ * @brief Gets how far behind the latest replicated state a client draws the other characters.
+ * Simulated proxies are smoothed towards every position they receive over the movement component's smoothing time,
+ * so the client sees them that much later than the state that reached it. Every player character shares the
+ * shooter's class, so the shooter's own movement component holds the settings its client smooths the others with.
+ * @param Character A character of the class the client sees.
+ * @return The delay in seconds, or zero if the character is not smoothed.
+ */
+double ULagCompensationSubsystem::GetProxyRenderDelaySeconds( const AActor* Character ) {
+	const ACharacter* AsCharacter = Cast<ACharacter>(Character);
+	const UCharacterMovementComponent* Movement = AsCharacter ? AsCharacter->GetCharacterMovement() : nullptr;
+	if ( Movement == nullptr || Movement->NetworkSmoothingMode == ENetworkSmoothingMode::Disabled ) { return 0.0; }
+	return Movement->NetworkSimulatedSmoothLocationTime;
+}
+
+
+/**
+ * @brief Rewinds the characters near any of a set of rays into a scope.
+ *
+ * The time of the shot is bounded by the shooter's ping, so a client cannot pick an older frame than it could have seen.
+ * The rewound characters are handed to the hitbox layer with the offset of their recorded capsule; their physics
+ * asset is traced in its current pose at that offset, since only the capsule is recorded.
+ * @param Scope The scope that receives the rewound characters.
+ * @param Timestamp The server time the shooter fired at.
+ * @param RayStart The start shared by every ray.
+ * @param RayEnds The end of every ray.
+ * @param Shooter The character firing, which is never rewound.
+ */
+void ULagCompensationSubsystem::Rewind( FLagCompensationRewindScope& Scope, const double Timestamp, const FVector& RayStart, const TConstArrayView<FVector> RayEnds, const AActor* Shooter ) {
+	CHARACTERATTRIBUTE_SCOPE(LagCompensationRewind);
+
+	UHitboxSubsystem* Hitboxes = GetWorld()->GetSubsystem<UHitboxSubsystem>();
+	if ( Hitboxes == nullptr ) { return; }
+
+	const double Margin = CVarLagCompensationCandidateMargin.GetValueOnGameThread();
+	const double RewindTime = FLagCompensationHistory::ClampRewindTime(Timestamp, LagCompensation::GetServerTime(GetWorld()), GetMaxRewindSeconds(Shooter));
+
+	for ( int32 Slot = 0; Slot < Characters.Num(); ++Slot ) {
+		const ACharacter* Character = Characters[Slot];
+		if ( !IsValid(Character) || Character == Shooter ) { continue; }
+
+		FLagCompensationSample Rewound;
+		if ( !History.GetSampleAt(Slot, RewindTime, Rewound) ) { continue; }
+
+		FVector Offset;
+		if ( !FLagCompensationHistory::GetRewindOffset(LagCompensation::MakeSample(Character), Rewound, RayStart, RayEnds, Margin, Offset) ) { continue; }
+
+		Hitboxes->AddRewind(Character, Offset);
+		++Scope.NumRewound;
+
+#if !UE_BUILD_SHIPPING
+		if ( CVarLagCompensationDebug.GetValueOnGameThread() ) {
+			UE_LOG(LogCharacterAttributeModule, Log, TEXT("Rewound %s by %.1f cm to %.3f s (claimed %.3f s)"), *Character->GetName(), Offset.Size(), RewindTime, Timestamp);
+		}
+#endif
+	}
+
+	CSV_CUSTOM_STAT(CharacterAttribute, RewoundCandidates, Scope.NumRewound, ECsvCustomStatOp::Max);
+
+	if ( Scope.NumRewound > 0 ) { Scope.Hitboxes = Hitboxes; }
+}
+
+
+/**
+ * @brief Records the hitbox of every registered character into the next frame of the rings.
+ * @param Time The server time of the frame.
+ */
+void ULagCompensationSubsystem::RecordFrame( const double Time ) {
+	CHARACTERATTRIBUTE_SCOPE(LagCompensationRecord);
+
+	History.BeginFrame(Time);
+	for ( int32 Slot = 0; Slot < Characters.Num(); ++Slot ) {
+		const ACharacter* Character = Characters[Slot];
+		History.SetNewestSample(Slot, IsValid(Character) ? LagCompensation::MakeSample(Character) : FLagCompensationSample());
+	}
+}
+
+
+/**
+ * @brief Records every character on the fixed cadence.
+ * Recording on a fixed cadence rather than every frame keeps the history length independent of the server frame rate.
+ * @param DeltaTime The time since the last frame.
+ */
+void ULagCompensationSubsystem::Tick( const float DeltaTime ) {
+	Super::Tick(DeltaTime);
+
+	TimeUntilRecord -= DeltaTime;
+	if ( TimeUntilRecord > 0.f ) { return; }
+
+	// Carry the overshoot so the cadence does not drift, but never record more than once per frame
+	TimeUntilRecord = FMath::Max(TimeUntilRecord + RecordInterval, 0.f);
+	RecordFrame(LagCompensation::GetServerTime(GetWorld()));
+}
+
+
+/**
+ * @brief Only ticks on servers that have characters to record.
+ * @return True if there is anything to record, false otherwise.
+ */
+bool ULagCompensationSubsystem::IsTickable() const { return Characters.Num() > FreeSlots.Num() && IsActive(); }
+
+
+TStatId ULagCompensationSubsystem::GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(ULagCompensationSubsystem, STATGROUP_Tickables); }
+
+
+/**
+ * @brief Sizes the history from the console variables, which stay fixed for the lifetime of the world.
+ * @param Collection The collection of subsystems being initialized.
+ */
+void ULagCompensationSubsystem::Initialize( FSubsystemCollectionBase& Collection ) {
+	Super::Initialize(Collection);
+
+	const float RecordRate = FMath::Max(CVarLagCompensationRecordRate.GetValueOnGameThread(), 1.f);
+	const float HistorySeconds = FMath::Max(CVarLagCompensationHistorySeconds.GetValueOnGameThread(), 0.f);
+	RecordInterval = 1.f / RecordRate;
+	// One extra frame so the full history window is always bracketed
+	History.Init(FMath::CeilToInt32(HistorySeconds * RecordRate) + 1, ExpectedCharacters);
+
+	LLM_SCOPE_BYTAG(CharacterAttribute);
+	Characters.Reserve(ExpectedCharacters);
+}
+
+
+/**
+ * @brief Forgets every character before the world goes away.
+ */
+void ULagCompensationSubsystem::Deinitialize() {
+	Characters.Empty();
+	FreeSlots.Empty();
+	History.Reset();
+
+	Super::Deinitialize();
+}
+
+
+/**
+ * @brief Lag compensation only applies to worlds that actually play.
+ * @param WorldType The type of the world the subsystem would be created for.
+ * @return True for game and PIE worlds, false otherwise.
+ */
+bool ULagCompensationSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const { return WorldType == EWorldType::Game || WorldType == EWorldType::PIE; }
@@ -0,0 +1,111 @@
+/**
+ * @file LagCompensationHistoryTests.cpp
+ * @brief This file contains the automation tests of the FLagCompensationHistory struct.
+ */
+
+#include "CharacterAttributeModule/LagCompensation/Public/LagCompensationHistory.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace LagCompensationTests
+{
+	/** The rate the subsystem records at by default. */
+	constexpr double RecordInterval = 1.0 / 30.0;
+
+	/** How fast the synthetic target strafes along X, in cm/s. */
+	constexpr double StrafeSpeed = 600.0;
+
+	/**
+	 * @brief Gets the capsule of the synthetic target at a time.
+	 * @param Time The server time.
+	 * @return A standing capsule strafing along X.
+	 */
+	FLagCompensationSample MakeTargetSample(const double Time)
+	{
+		FLagCompensationSample Sample;
+		Sample.Center = FVector3f(static_cast<float>(StrafeSpeed * Time), 0.f, 90.f);
+		Sample.HalfHeight = 90.f;
+		Sample.Radius = 35.f;
+		return Sample;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLagCompensationHistoryLatencyTest, "LastShooter.LagCompensation.History.Latency", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Records a strafing target for one second and rewinds shots fired 100 to 250 ms ago.
+ * Every shot must find the target where it was at that time and rewind it by the distance it has strafed since.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FLagCompensationHistoryLatencyTest::RunTest( const FString& Parameters ) {
+	using namespace LagCompensationTests;
+
+	FLagCompensationHistory History;
+	History.Init(31, 1);
+	const int32 Slot = History.AddSlot();
+
+	double Now = 0.0;
+	for ( int32 Frame = 0; Frame < 31; ++Frame ) {
+		Now = Frame * RecordInterval;
+		History.BeginFrame(Now);
+		History.SetNewestSample(Slot, MakeTargetSample(Now));
+	}
+	const FLagCompensationSample Current = MakeTargetSample(Now);
+
+	for ( const double Latency : { 0.100, 0.150, 0.200, 0.250 } ) {
+		const double RewindTime = FLagCompensationHistory::ClampRewindTime(Now - Latency, Now, Latency + 0.1);
+		TestEqual(FString::Printf(TEXT("%.0f ms is within the ping bound"), Latency * 1000.0), RewindTime, Now - Latency, UE_DOUBLE_KINDA_SMALL_NUMBER);
+
+		FLagCompensationSample Rewound;
+		if ( !TestTrue(FString::Printf(TEXT("%.0f ms has a sample"), Latency * 1000.0), History.GetSampleAt(Slot, RewindTime, Rewound)) ) { continue; }
+
+		const double ExpectedX = StrafeSpeed * RewindTime;
+		TestEqual(FString::Printf(TEXT("%.0f ms is interpolated to where the target was"), Latency * 1000.0), static_cast<double>(Rewound.Center.X), ExpectedX, 0.01);
+
+		// A shot straight through where the shooter saw the target
+		const FVector RayStart(ExpectedX, -2000.0, 90.0);
+		const FVector RayEnd(ExpectedX, 2000.0, 90.0);
+		FVector Offset;
+		TestTrue(FString::Printf(TEXT("%.0f ms rewinds the target it passes through"), Latency * 1000.0), FLagCompensationHistory::GetRewindOffset(Current, Rewound, RayStart, MakeArrayView(&RayEnd, 1), 50.0, Offset));
+		TestEqual(FString::Printf(TEXT("%.0f ms rewinds by the distance strafed since"), Latency * 1000.0), Offset.X, -StrafeSpeed * Latency, 0.01);
+
+		// A shot high over both the old and the current capsule
+		const FVector HighStart(ExpectedX, -2000.0, 1000.0);
+		const FVector HighEnd(ExpectedX, 2000.0, 1000.0);
+		TestFalse(FString::Printf(TEXT("%.0f ms leaves a target far from the shot alone"), Latency * 1000.0), FLagCompensationHistory::GetRewindOffset(Current, Rewound, HighStart, MakeArrayView(&HighEnd, 1), 50.0, Offset));
+	}
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLagCompensationHistoryClampTest, "LastShooter.LagCompensation.History.Clamp", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Checks that a shooter cannot rewind further than its ping, nor into the future.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FLagCompensationHistoryClampTest::RunTest( const FString& Parameters ) {
+	constexpr double Now = 100.0;
+	constexpr double MaxRewindSeconds = 0.1 + 0.1;
+
+	TestEqual(TEXT("A stale timestamp is bounded by the ping"), FLagCompensationHistory::ClampRewindTime(Now - 0.9, Now, MaxRewindSeconds), Now - MaxRewindSeconds, UE_DOUBLE_KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("A timestamp from the future is bounded by now"), FLagCompensationHistory::ClampRewindTime(Now + 0.5, Now, MaxRewindSeconds), Now, UE_DOUBLE_KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("A timestamp within the ping is kept"), FLagCompensationHistory::ClampRewindTime(Now - 0.15, Now, MaxRewindSeconds), Now - 0.15, UE_DOUBLE_KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("A negative bound rewinds nothing"), FLagCompensationHistory::ClampRewindTime(Now - 0.15, Now, -1.0), Now, UE_DOUBLE_KINDA_SMALL_NUMBER);
+
+	// Before anything is recorded there is nothing to rewind to
+	FLagCompensationHistory Empty;
+	Empty.Init(31, 1);
+	const int32 Slot = Empty.AddSlot();
+	FLagCompensationSample Sample;
+	TestFalse(TEXT("An empty history has no sample"), Empty.GetSampleAt(Slot, Now, Sample));
+
+	return true;
+}
+
+#endif
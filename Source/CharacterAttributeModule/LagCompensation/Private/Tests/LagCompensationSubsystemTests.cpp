@@ -0,0 +1,53 @@
+/**
+ * @file LagCompensationSubsystemTests.cpp
+ * @brief This file contains the automation tests of how far back the ULagCompensationSubsystem class rewinds a shooter's shots.
+ */
+
+#include "CharacterAttributeModule/LagCompensation/Public/LagCompensationSubsystem.h"
+#include "CharacterAttributeModule/LagCompensation/Public/LagCompensationHistory.h"
+#include "WorldItemsModule/Testing/Public/GameplayTestWorld.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLagCompensationRewindBoundTest, "LastShooter.LagCompensation.Subsystem.RewindBound", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Checks that a shot stamped with the time the shooter's client drew the other characters at is rewound all the way.
+ * The shooter has no player state, so its round trip is added to the bound here as the server adds its ping.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FLagCompensationRewindBoundTest::RunTest( const FString& Parameters ) {
+	FGameplayTestWorld TestWorld;
+	ACharacter* Shooter = TestWorld.World->SpawnActor<ACharacter>(FVector::ZeroVector, FRotator::ZeroRotator);
+	if ( !TestNotNull(TEXT("The shooter is spawned"), Shooter) ) { return false; }
+
+	UCharacterMovementComponent* Movement = Shooter->GetCharacterMovement();
+	Movement->NetworkSmoothingMode = ENetworkSmoothingMode::Exponential;
+	Movement->NetworkSimulatedSmoothLocationTime = 0.1f;
+	const double RenderDelay = ULagCompensationSubsystem::GetProxyRenderDelaySeconds(Shooter);
+	TestEqual(TEXT("Smoothed characters are drawn the smoothing time behind"), RenderDelay, 0.1, UE_KINDA_SMALL_NUMBER);
+
+	const IConsoleVariable* PingSlack = IConsoleManager::Get().FindConsoleVariable(TEXT("LastShooter.LagCompensation.PingSlack"));
+	if ( !TestNotNull(TEXT("The ping slack exists"), PingSlack) ) { return false; }
+	TestEqual(TEXT("The bound covers the smoothing delay and the slack"), ULagCompensationSubsystem::GetMaxRewindSeconds(Shooter), RenderDelay + PingSlack->GetFloat(), UE_KINDA_SMALL_NUMBER);
+
+	// The client sees the server a one-way trip late, and its shot arrives another one-way trip later
+	const double Now = 10.0;
+	for ( const double RoundTrip : { 0.05, 0.1, 0.2 } ) {
+		const double Timestamp = Now - RoundTrip - RenderDelay;
+		const double RewindTime = FLagCompensationHistory::ClampRewindTime(Timestamp, Now, RoundTrip + ULagCompensationSubsystem::GetMaxRewindSeconds(Shooter));
+		TestEqual(FString::Printf(TEXT("A %.0f ms round trip is rewound to what the shooter saw"), RoundTrip * 1000.0), RewindTime, Timestamp, UE_DOUBLE_KINDA_SMALL_NUMBER);
+	}
+
+	Movement->NetworkSmoothingMode = ENetworkSmoothingMode::Disabled;
+	TestEqual(TEXT("Unsmoothed characters are drawn as they arrive"), ULagCompensationSubsystem::GetProxyRenderDelaySeconds(Shooter), 0.0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file LagCompensationHistory.h
+ * @brief This file contains the declaration of the FLagCompensationSample and FLagCompensationHistory structs.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @struct FLagCompensationSample
+ * @brief The hitbox of one character at one recorded frame: an upright capsule.
+ */
+struct FLagCompensationSample
+{
+	/** The centre of the capsule. */
+	FVector3f Center = FVector3f::ZeroVector;
+
+	/** The half height of the capsule, including the hemispheres. */
+	float HalfHeight = 0.f;
+
+	/** The radius of the capsule. Zero marks a frame the character was not recorded in or had no collision. */
+	float Radius = 0.f;
+
+	/**
+	 * @brief Checks whether the sample holds a hitbox.
+	 * @return True if the character was recorded with collision, false otherwise.
+	 */
+	FORCEINLINE bool IsValid() const { return Radius > 0.f; }
+};
+
+/**
+ * @struct FLagCompensationHistory
+ * @brief The recorded hitboxes of a set of slots: one preallocated ring of samples per slot, sharing the frame times.
+ *
+ * Plain data with no UObject or world dependencies. ULagCompensationSubsystem maps characters to slots and records
+ * them on a fixed cadence; tests can record synthetic frames and look them up the same way.
+ */
+struct CHARACTERATTRIBUTEMODULE_API FLagCompensationHistory
+{
+	/**
+	 * @brief Sizes the rings and forgets everything recorded.
+	 * @param InHistoryLength The number of frames every ring holds.
+	 * @param ExpectedSlots The number of slots to reserve memory for.
+	 */
+	void Init(int32 InHistoryLength, int32 ExpectedSlots);
+
+	/**
+	 * @brief Frees the memory of every ring.
+	 */
+	void Reset();
+
+	/**
+	 * @brief Appends a slot with an empty ring.
+	 * @return The index of the slot.
+	 */
+	int32 AddSlot();
+
+	/**
+	 * @brief Empties the ring of a slot so no frames of its previous owner are looked up.
+	 * @param Slot The slot to clear.
+	 */
+	void ClearSlot(int32 Slot);
+
+	/**
+	 * @brief Starts the next frame of the rings, overwriting the oldest one once the rings are full.
+	 * @param Time The server time of the frame.
+	 */
+	void BeginFrame(double Time);
+
+	/**
+	 * @brief Stores the sample of a slot in the frame started last.
+	 * @param Slot The slot.
+	 * @param Sample The hitbox, or an invalid sample if the slot had none.
+	 */
+	FORCEINLINE void SetNewestSample(const int32 Slot, const FLagCompensationSample& Sample) { Samples[Slot * HistoryLength + NewestFrame] = Sample; }
+
+	/**
+	 * @brief Gets the hitbox of a slot at a past time.
+	 * @param Slot The slot.
+	 * @param Timestamp The server time to look up. Clamped to the recorded history.
+	 * @param OutSample Receives the hitbox, interpolated between the two frames around the time.
+	 * @return True if the slot has a hitbox at that time, false otherwise.
+	 */
+	bool GetSampleAt(int32 Slot, double Timestamp, FLagCompensationSample& OutSample) const;
+
+	/**
+	 * @brief Gets the number of frames every ring holds.
+	 * @return The history length in frames.
+	 */
+	FORCEINLINE int32 GetHistoryLength() const { return HistoryLength; }
+
+	/**
+	 * @brief Bounds the time a shooter claims to have fired at by how late its view can be.
+	 * @param Timestamp The server time the shooter claims.
+	 * @param Now The current server time.
+	 * @param MaxRewindSeconds The furthest the shooter can see into the past: its round trip time plus some slack.
+	 * @return The time to rewind to, between Now - MaxRewindSeconds and Now.
+	 */
+	static double ClampRewindTime(double Timestamp, double Now, double MaxRewindSeconds);
+
+	/**
+	 * @brief Decides whether a shot rewinds a character and by how much.
+	 * The character is rewound if its capsule lies near a ray now or at the time of the shot, so a rewound
+	 * character also blocks a shot that would otherwise hit someone standing behind where it is now.
+	 * @param Current The hitbox of the character now.
+	 * @param Rewound The hitbox of the character at the time of the shot.
+	 * @param RayStart The start shared by every ray.
+	 * @param RayEnds The end of every ray.
+	 * @param Margin The distance from a capsule's surface that still counts as near.
+	 * @param OutOffset Receives how far the hitbox moves from where it is now to where it was.
+	 * @return True if the character is rewound, false otherwise.
+	 */
+	static bool GetRewindOffset(const FLagCompensationSample& Current, const FLagCompensationSample& Rewound, const FVector& RayStart, TConstArrayView<FVector> RayEnds, double Margin, FVector& OutOffset);
+
+private:
+	/**
+	 * @brief Gets the recorded sample of a slot in a frame.
+	 * @param Slot The slot.
+	 * @param Frame The frame index in the ring.
+	 * @return The sample.
+	 */
+	FORCEINLINE const FLagCompensationSample& GetSample(const int32 Slot, const int32 Frame) const { return Samples[Slot * HistoryLength + Frame]; }
+
+	/** The ring of every slot, back to back: the sample of slot S in frame F is at S * HistoryLength + F. */
+	TArray<FLagCompensationSample> Samples;
+
+	/** The server time of every frame in the rings. */
+	TArray<double> FrameTimes;
+
+	/** The frame recorded last, or INDEX_NONE before the first one. */
+	int32 NewestFrame = INDEX_NONE;
+
+	/** The number of frames recorded so far, up to HistoryLength. */
+	int32 NumFrames = 0;
+
+	/** The number of frames each ring holds. */
+	int32 HistoryLength = 0;
+};
@@ -0,0 +1,182 @@
+/**
+ * @file LagCompensationSubsystem.h
+ * @brief This file contains the declaration of the ULagCompensationSubsystem class.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CharacterAttributeModule/LagCompensation/Public/LagCompensationHistory.h"
+#include "LagCompensationSubsystem.generated.h"
+
+class ACharacter;
+class UHitboxSubsystem;
+class ULagCompensationSubsystem;
+
+/**
+ * @struct FLagCompensationRewindScope
+ * @brief Traces the characters near a shot where the shooter saw them for as long as the scope lives.
+ *
+ * No actor is moved: the hitbox layer traces every rewound character with its hitbox shifted to the recorded
+ * capsule, so no overlap, physics or movement event fires. Weapon rays traced inside the scope go through the hitbox
+ * layer for that reason. The shift ends with the scope.
+ */
+struct CHARACTERATTRIBUTEMODULE_API FLagCompensationRewindScope
+{
+	/**
+	 * @brief Rewinds the candidate characters of a shot.
+	 * @param InSubsystem The subsystem holding the history. May be null, in which case nothing is rewound.
+	 * @param Timestamp The server time the shooter fired at.
+	 * @param RayStart The start of the shot.
+	 * @param RayEnd The end of the shot.
+	 * @param Shooter The character firing, which is never rewound.
+	 */
+	FLagCompensationRewindScope(ULagCompensationSubsystem* InSubsystem, double Timestamp, const FVector& RayStart, const FVector& RayEnd, const AActor* Shooter);
+
+	/**
+	 * @brief Rewinds the candidate characters of a shot with several pellets from one origin.
+	 * @param InSubsystem The subsystem holding the history. May be null, in which case nothing is rewound.
+	 * @param Timestamp The server time the shooter fired at.
+	 * @param RayStart The start shared by every pellet.
+	 * @param RayEnds The end of every pellet.
+	 * @param Shooter The character firing, which is never rewound.
+	 */
+	FLagCompensationRewindScope(ULagCompensationSubsystem* InSubsystem, double Timestamp, const FVector& RayStart, TConstArrayView<FVector> RayEnds, const AActor* Shooter);
+
+	/**
+	 * @brief Ends the shift of every rewound character.
+	 */
+	~FLagCompensationRewindScope();
+
+	FLagCompensationRewindScope(const FLagCompensationRewindScope&) = delete;
+	FLagCompensationRewindScope& operator=(const FLagCompensationRewindScope&) = delete;
+
+	/**
+	 * @brief Gets the number of characters the scope rewound.
+	 * @return The number of rewound characters.
+	 */
+	FORCEINLINE int32 GetNumRewound() const { return NumRewound; }
+
+private:
+	friend class ULagCompensationSubsystem;
+
+	/** The number of rewound characters. */
+	int32 NumRewound = 0;
+
+	/** The hitbox layer tracing the rewound characters, or nullptr if nothing was rewound. */
+	UHitboxSubsystem* Hitboxes = nullptr;
+};
+
+/**
+ * @class ULagCompensationSubsystem
+ * @brief Keeps a short history of every character's hitbox on the server so shots can be validated where the shooter saw them.
+ *
+ * Characters are recorded on a fixed cadence into an FLagCompensationHistory, one ring per character, so memory is
+ * bounded by the history length times the number of characters. Validating a shot rewinds only the characters whose
+ * capsule, now or at the time of the shot, lies near the ray, and never further back than the shooter's ping.
+ */
+UCLASS()
+class CHARACTERATTRIBUTEMODULE_API ULagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief Starts recording a character's hitbox.
+	 * @param Character The character to record.
+	 */
+	void RegisterCharacter(ACharacter* Character);
+
+	/**
+	 * @brief Stops recording a character's hitbox and frees its ring.
+	 * @param Character The character to forget.
+	 */
+	void UnregisterCharacter(const ACharacter* Character);
+
+	/**
+	 * @brief Gets the hitbox of a character at a past time.
+	 * @param Character The registered character.
+	 * @param Timestamp The server time to look up. Clamped to the recorded history.
+	 * @param OutSample Receives the hitbox, interpolated between the two frames around the time.
+	 * @return True if the character has a hitbox at that time, false otherwise.
+	 */
+	bool GetSampleAt(const ACharacter* Character, double Timestamp, FLagCompensationSample& OutSample) const;
+
+	/**
+	 * @brief Gets whether lag compensation is active in this world.
+	 * @return True on servers with LastShooter.LagCompensation enabled, false otherwise.
+	 */
+	bool IsActive() const;
+
+	/**
+	 * @brief Gets how far back a shooter can see: its round trip time, the time its client draws other characters
+	 * behind the state it received, and LastShooter.LagCompensation.PingSlack.
+	 * @param Shooter The character firing.
+	 * @return The furthest a shot of the shooter may be rewound, in seconds.
+	 */
+	static double GetMaxRewindSeconds(const AActor* Shooter);
+
+	/**
+	 * @brief Gets how far behind the latest replicated state a client draws the other characters.
+	 * @param Character A character of the class the client sees, whose movement component holds the smoothing settings.
+	 * @return The delay in seconds, or zero if the character is not smoothed.
+	 */
+	static double GetProxyRenderDelaySeconds(const AActor* Character);
+
+	/**
+	 * @brief Records every character on the fixed cadence.
+	 * @param DeltaTime The time since the last frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * @brief Sizes the history from the console variables, which stay fixed for the lifetime of the world.
+	 * @param Collection The collection of subsystems being initialized.
+	 */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	friend struct FLagCompensationRewindScope;
+
+	/**
+	 * @brief Rewinds the characters near any of a set of rays into a scope.
+	 * @param Scope The scope that receives the rewound characters.
+	 * @param Timestamp The server time the shooter fired at. Bounded by the shooter's ping.
+	 * @param RayStart The start shared by every ray.
+	 * @param RayEnds The end of every ray.
+	 * @param Shooter The character firing, which is never rewound.
+	 */
+	void Rewind(FLagCompensationRewindScope& Scope, double Timestamp, const FVector& RayStart, TConstArrayView<FVector> RayEnds, const AActor* Shooter);
+
+	/**
+	 * @brief Records the hitbox of every registered character into the next frame of the rings.
+	 * @param Time The server time of the frame.
+	 */
+	void RecordFrame(double Time);
+
+	/** The registered characters by slot. Freed slots hold nullptr until reused. */
+	UPROPERTY()
+	TArray<ACharacter*> Characters;
+
+	/** The slots freed by unregistered characters. */
+	TArray<int32> FreeSlots;
+
+	/** The recorded hitboxes, one ring per slot. */
+	FLagCompensationHistory History;
+
+	/** Seconds between recorded frames. */
+	float RecordInterval = 1.f / 30.f;
+
+	/** Seconds until the next frame is recorded. */
+	float TimeUntilRecord = 0.f;
+};
@@ -2,6 +2,7 @@
 
 #include "CharacterAttributeModule.h"
 #include "Logging.h"
+#include "Profiling.h"
 
 #include "Modules/ModuleManager.h"
 
@@ -9,6 +10,13 @@
 
 void FCharacterAttributeModule::StartupModule()
 {
+#if CSV_PROFILER
+	// Gameplay CSV metrics are opt-in so regular captures stay comparable
+	if (FParse::Param(FCommandLine::Get(), TEXT("GameplayCsv")))
+	{
+		FCsvProfiler::Get()->EnableCategoryByString(TEXT("CharacterAttribute"));
+	}
+#endif
 }
 
 void FCharacterAttributeModule::ShutdownModule()
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Profiling.h"
+
+UE_TRACE_CHANNEL_DEFINE(CharacterAttributeChannel);
+
+CSV_DEFINE_CATEGORY(CharacterAttribute, false);
+
+LLM_DEFINE_TAG(CharacterAttribute);
+LLM_DEFINE_TAG(CharacterAttribute_Weapons, TEXT("Weapons"), TEXT("CharacterAttribute"));
+LLM_DEFINE_TAG(CharacterAttribute_WeaponVFX, TEXT("WeaponVFX"), TEXT("CharacterAttribute"));
+
+DEFINE_STAT(STAT_FireWeapon);
+DEFINE_STAT(STAT_WeaponTrace);
+DEFINE_STAT(STAT_TraceUnderCrosshair);
+DEFINE_STAT(STAT_DynamicCrosshair);
+DEFINE_STAT(STAT_EquipWeapon);
+DEFINE_STAT(STAT_WeaponHandlingSubsystemTick);
+DEFINE_STAT(STAT_ServerFire);
+DEFINE_STAT(STAT_LagCompensationRecord);
+DEFINE_STAT(STAT_LagCompensationRewind);
+DEFINE_STAT(STAT_HitboxTrace);
+DEFINE_STAT(STAT_FireRequestBytes);
+DEFINE_STAT(STAT_FireCosmeticBytesPerShot);
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.h"
+
+/** Insights channel for the weapon handling hot paths. Enable with -trace=cpu,CharacterAttribute. */
+UE_TRACE_CHANNEL_EXTERN(CharacterAttributeChannel);
+
+DECLARE_STATS_GROUP(TEXT("CharacterAttribute"), STATGROUP_CharacterAttribute, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FireWeapon"), STAT_FireWeapon, STATGROUP_CharacterAttribute, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("WeaponTrace"), STAT_WeaponTrace, STATGROUP_CharacterAttribute, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TraceUnderCrosshair"), STAT_TraceUnderCrosshair, STATGROUP_CharacterAttribute, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("DynamicCrosshair"), STAT_DynamicCrosshair, STATGROUP_CharacterAttribute, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("EquipWeapon"), STAT_EquipWeapon, STATGROUP_CharacterAttribute, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("WeaponHandlingSubsystem Tick"), STAT_WeaponHandlingSubsystemTick, STATGROUP_CharacterAttribute, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ServerFire"), STAT_ServerFire, STATGROUP_CharacterAttribute, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LagCompensation Record"), STAT_LagCompensationRecord, STATGROUP_CharacterAttribute, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LagCompensation Rewind"), STAT_LagCompensationRewind, STATGROUP_CharacterAttribute, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hitbox Trace"), STAT_HitboxTrace, STATGROUP_CharacterAttribute, );
+
+/** Bytes of the last fire request a client sent, excluding RPC headers. */
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Fire Request (bytes)"), STAT_FireRequestBytes, STATGROUP_CharacterAttribute, );
+
+/** Bytes per shot of the last batch of fire cosmetics the server multicast, excluding RPC headers. */
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Fire Cosmetic (bytes per shot)"), STAT_FireCosmeticBytesPerShot, STATGROUP_CharacterAttribute, );
+
+/** CSV category for per-frame weapon metrics. Off by default, enabled by -GameplayCsv. */
+CSV_DECLARE_CATEGORY_EXTERN(CharacterAttribute);
+
+/** LLM tags for weapon handling allocations. Visible with -llm in memreport and with -trace=memtag in Insights. */
+LLM_DECLARE_TAG(CharacterAttribute);
+LLM_DECLARE_TAG(CharacterAttribute_Weapons);
+LLM_DECLARE_TAG(CharacterAttribute_WeaponVFX);
+
+/**
+ * Times the enclosing scope under STAT_<Name> (cycles and call count in `stat CharacterAttribute`)
+ * and as a named CPU event on the CharacterAttribute trace channel, which costs a single branch while the channel is off.
+ */
+#define CHARACTERATTRIBUTE_SCOPE(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, CharacterAttributeChannel)
@@ -0,0 +1,176 @@
+/**
+ * @file WeaponFireAllocationTests.cpp
+ * @brief This file contains the automation tests that firing a weapon makes no heap allocations on the server, the client or a standalone game.
+ */
+
+#include "CharacterAttributeModule/WeaponHandling/Private/Tests/WeaponHandlingTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace WeaponFireAllocationTests
+{
+	constexpr int32 NumWarmUpShots = 16;
+	constexpr int32 NumShots = 1000;
+
+	/** Where the shots leave the barrel, relative to the shooter. */
+	const FVector BarrelOffset(50.0, 0.0, 60.0);
+
+	/**
+	 * @brief Makes an effect template for the muzzle flash, beam and impact of the shots.
+	 * It has no emitters, so it costs nothing to play, but its components still go through the world's particle pool.
+	 * @return The template.
+	 */
+	UParticleSystem* MakeEffectTemplate() { return NewObject<UParticleSystem>(GetTransientPackage()); }
+
+	/**
+	 * @brief Gets the aim of a shot.
+	 * Alternates the aim so the pellets are not traced along the same ray every time.
+	 * @param Shot The number of the shot.
+	 * @return The unit direction the shot is aimed at.
+	 */
+	FVector GetAimDirection(const int32 Shot) { return FRotator(Shot % 2 == 0 ? 0.0 : 30.0, 0.0, 0.0).Vector(); }
+
+	/**
+	 * @brief Fires warm-up shots, then counts the heap allocations the game thread makes over NumShots shots.
+	 *
+	 * A few shots are fired first so one-off growth, such as the quantising buffer and the first trace, is not counted.
+	 * The world ticks for one fire interval between shots, outside the count, so the fire cooldown runs out, the shot
+	 * effects finish and go back to the particle pool, and the server earns the fire rate it accepts remote shots at.
+	 * @param TestWorld The world the shots are fired in.
+	 * @param FireInterval The time between two shots.
+	 * @param FireShot Fires one shot and returns whether it went off.
+	 * @param OutNumFired Receives the number of counted shots that went off.
+	 * @return The number of allocations made while firing the counted shots.
+	 */
+	int32 CountShotAllocations(const FWeaponHandlingTestWorld& TestWorld, const float FireInterval, const TFunctionRef<bool(int32)> FireShot, int32& OutNumFired)
+	{
+		for ( int32 Shot = 0; Shot < NumWarmUpShots; ++Shot ) {
+			FireShot(Shot);
+			TestWorld.World->Tick(LEVELTICK_All, FireInterval);
+		}
+
+		OutNumFired = 0;
+		int32 NumAllocations = 0;
+		for ( int32 Shot = NumWarmUpShots; Shot < NumWarmUpShots + NumShots; ++Shot ) {
+			bool bFired;
+			{
+				const FScopedThreadAllocationCounter Counter;
+				bFired = FireShot(Shot);
+				NumAllocations += Counter.GetNum();
+			}
+			if ( bFired ) { ++OutNumFired; }
+			TestWorld.World->Tick(LEVELTICK_All, FireInterval);
+		}
+		return NumAllocations;
+	}
+
+	/**
+	 * @brief Fires a shot from a handler the way the owning pawn does.
+	 * @param Handler The handler to fire.
+	 * @param Shot The number of the shot.
+	 * @return True if the shot went off, which writes its trace end.
+	 */
+	bool FireHandler(UWeaponHandlingComponent* Handler, const int32 Shot)
+	{
+		const FVector TraceStart = Handler->GetOwner()->GetActorLocation() + BarrelOffset;
+		const FTransform Aim(GetAimDirection(Shot).Rotation(), TraceStart);
+		FVector TraceEnd = TraceStart;
+		Handler->SetShouldFireWeapon(true);
+		Handler->FireWeapon(Aim, TraceStart, TraceEnd);
+		return TraceEnd != TraceStart;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponFireAllocationTest, "LastShooter.WeaponHandling.Fire.NoAllocations", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Fires 1,000 shots from a standalone rifle with pooled effects and counts the heap allocations the game thread makes.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FWeaponFireAllocationTest::RunTest( const FString& Parameters ) {
+	using namespace WeaponFireAllocationTests;
+
+	FWeaponHandlingTestWorld TestWorld;
+	UWeaponHandlingComponent* Handler = TestWorld.SpawnArmedHandler(FVector::ZeroVector, EPlayerArmedState::EPAS_Rifle, MakeEffectTemplate());
+	if ( !TestNotNull(TEXT("The handler is spawned"), Handler) ) { return false; }
+
+	int32 NumFired;
+	const int32 NumAllocations = CountShotAllocations(TestWorld, FWeaponHandlingTestWorld::GetFireInterval(Handler), [Handler]( const int32 Shot ) { return FireHandler(Handler, Shot); }, NumFired);
+
+	TestEqual(TEXT("Every shot is fired"), NumFired, NumShots);
+	TestEqual(TEXT("Firing makes no heap allocations"), NumAllocations, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponClientFireAllocationTest, "LastShooter.WeaponHandling.Fire.ClientNoAllocations", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Fires 1,000 shots from a client's own rifle with pooled effects and counts the heap allocations the game thread makes.
+ *
+ * The shooter is the autonomous proxy of a client, so every shot takes the client path: it is played straight away,
+ * measured for the fire request stats and sent through the ServerFire RPC. There is no server connection, so the RPC
+ * goes no further than the call; FWeaponServerFireAllocationTest covers what the server does with it.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FWeaponClientFireAllocationTest::RunTest( const FString& Parameters ) {
+	using namespace WeaponFireAllocationTests;
+
+	FWeaponHandlingTestWorld TestWorld;
+	UWeaponHandlingComponent* Handler = TestWorld.SpawnArmedHandler(FVector::ZeroVector, EPlayerArmedState::EPAS_Rifle, MakeEffectTemplate());
+	if ( !TestNotNull(TEXT("The handler is spawned"), Handler) ) { return false; }
+	Handler->GetOwner()->SetRole(ROLE_AutonomousProxy);
+	TestTrue(TEXT("The shooter is a client's own pawn"), Handler->GetOwnerRole() == ROLE_AutonomousProxy);
+
+	int32 NumFired;
+	const int32 NumAllocations = CountShotAllocations(TestWorld, FWeaponHandlingTestWorld::GetFireInterval(Handler), [Handler]( const int32 Shot ) { return FireHandler(Handler, Shot); }, NumFired);
+
+	TestEqual(TEXT("Every shot is fired"), NumFired, NumShots);
+	TestEqual(TEXT("Firing on a client makes no heap allocations"), NumAllocations, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponServerFireAllocationTest, "LastShooter.WeaponHandling.Fire.ServerNoAllocations", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Sends 1,000 client shots to a listen server's rifle and counts the heap allocations the game thread makes.
+ *
+ * Each shot arrives through the ServerFire RPC the way the net driver delivers it, at the fire rate, with the request
+ * the client builds. The server judges it, rewinds the recorded target in front of the shooter, traces it, plays it for
+ * the host with pooled effects and queues it for the multicast. No client connects, so the multicast has nobody to reach.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FWeaponServerFireAllocationTest::RunTest( const FString& Parameters ) {
+	using namespace WeaponFireAllocationTests;
+
+	// Port 0 binds whichever port the OS has free, so parallel runs and a running game never collide
+	FURL ListenURL;
+	ListenURL.Port = 0;
+	FWeaponHandlingTestWorld TestWorld(&ListenURL);
+	if ( !TestTrue(TEXT("The server listens"), TestWorld.bIsListening) ) { return false; }
+
+	UWeaponHandlingComponent* Handler = TestWorld.SpawnArmedHandler(FVector::ZeroVector, EPlayerArmedState::EPAS_Rifle, MakeEffectTemplate());
+	// A second character stands in the line of fire, so the shots have someone to rewind and hit
+	UWeaponHandlingComponent* Target = TestWorld.SpawnArmedHandler(FVector(600.0, 0.0, 0.0));
+	if ( !TestNotNull(TEXT("The handler is spawned"), Handler) || !TestNotNull(TEXT("The target is spawned"), Target) ) { return false; }
+
+	auto SendShot = [Handler, &TestWorld]( const int32 Shot ) {
+		const FVector ViewOrigin = Handler->GetOwner()->GetActorLocation() + BarrelOffset;
+		const uint16 ShotIndex = static_cast<uint16>(Shot);
+		FWeaponHandlingTestWorld::ServerFire(Handler, TestWorld.MakeFireRequest(Handler, ViewOrigin, GetAimDirection(Shot), ShotIndex));
+		return FWeaponHandlingTestWorld::GetLastAcceptedShotIndex(Handler) == ShotIndex;
+	};
+
+	int32 NumAccepted;
+	const int32 NumAllocations = CountShotAllocations(TestWorld, FWeaponHandlingTestWorld::GetFireInterval(Handler), SendShot, NumAccepted);
+
+	TestEqual(TEXT("The server accepts every shot sent at the fire rate"), NumAccepted, NumShots);
+	TestEqual(TEXT("Judging and tracing client shots makes no heap allocations"), NumAllocations, 0);
+	return true;
+}
+
+#endif
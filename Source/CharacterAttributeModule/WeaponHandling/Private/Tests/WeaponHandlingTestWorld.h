@@ -0,0 +1,208 @@
+/**
+ * @file WeaponHandlingTestWorld.h
+ * @brief This file contains the FWeaponHandlingTestWorld and FScopedThreadAllocationCounter helpers of the weapon handling automation tests.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingComponent.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingTickState.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponFireNet.h"
+#include "WorldItemsModule/Testing/Public/GameplayTestWorld.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "HAL/MallocBase.h"
+#include "Particles/ParticleSystem.h"
+
+/**
+ * @struct FWeaponHandlingTestWorld
+ * @brief A game world that has begun play, with helpers to spawn weapon handlers in it and drive them as a server would.
+ */
+struct FWeaponHandlingTestWorld : FGameplayTestWorld
+{
+	/**
+	 * @brief Creates a game world and begins play in it.
+	 * @param ListenURL The URL to listen on before play begins, or nullptr for a standalone world.
+	 */
+	explicit FWeaponHandlingTestWorld(const FURL* ListenURL = nullptr) : FGameplayTestWorld(ListenURL) {}
+
+	/**
+	 * @brief Spawns a character holding a weapon handling component armed with a weapon.
+	 * @param Location Where the character stands.
+	 * @param ArmedState The weapon the component is armed with.
+	 * @param EffectTemplate The particle system played for the muzzle flash, beam and impact of every shot, or nullptr for none.
+	 * @return The component, registered and past BeginPlay.
+	 */
+	UWeaponHandlingComponent* SpawnArmedHandler(const FVector& Location, const EPlayerArmedState ArmedState = EPlayerArmedState::EPAS_Rifle, UParticleSystem* EffectTemplate = nullptr) const
+	{
+		ACharacter* Character = World->SpawnActor<ACharacter>(Location, FRotator::ZeroRotator);
+		UWeaponHandlingComponent* Handler = NewObject<UWeaponHandlingComponent>(Character);
+		// Set before play begins, so the effects are pooled the way a configured weapon's are
+		Handler->MuzzleFlash = EffectTemplate;
+		Handler->BeamParticle = EffectTemplate;
+		Handler->ImpactParticle = EffectTemplate;
+		Handler->RegisterComponent();
+		Handler->SetPlayerArmedState(ArmedState);
+		return Handler;
+	}
+
+	/**
+	 * @brief Builds the request a client would send for a shot of a handler.
+	 * @param Handler The handler the shot is fired from.
+	 * @param ViewOrigin The start of the aim ray.
+	 * @param ViewDirection The unit direction of the aim ray.
+	 * @param ShotIndex The index of the shot in the weapon's spread stream.
+	 * @return The quantised request.
+	 */
+	FWeaponFireRequest MakeFireRequest(const UWeaponHandlingComponent* Handler, const FVector& ViewOrigin, const FVector& ViewDirection, const uint16 ShotIndex) const
+	{
+		FWeaponFireRequest Request;
+		Request.Timestamp = static_cast<float>(World->GetTimeSeconds());
+		Request.ViewOrigin = ViewOrigin;
+		Request.ViewDirection = ViewDirection;
+		Request.ShotIndex = ShotIndex;
+		Request.SetSpreadMultiplier(Handler->GetTickState().Model.CrosshairSpreadMultiplier);
+		Request.SetArchetype(Handler->GetTickState().Model.Archetype);
+		Request.Quantize();
+		return Request;
+	}
+
+	/**
+	 * @brief Calls the server RPC of a handler, as the net driver does when a client's shot arrives.
+	 * @param Handler The handler on the server.
+	 * @param Request The shot the client sent.
+	 */
+	static void ServerFire(UWeaponHandlingComponent* Handler, const FWeaponFireRequest& Request) { Handler->ServerFire(Request); }
+
+	/**
+	 * @brief Gets the time between two shots of a handler.
+	 * @param Handler The handler.
+	 * @return The fire interval in seconds.
+	 */
+	static float GetFireInterval(const UWeaponHandlingComponent* Handler) { return static_cast<float>(Handler->GetTickState().Model.FireIntervalSteps) * FWeaponModel::StepSeconds; }
+
+	/**
+	 * @brief Gets the index of the last shot a server accepted from a handler's client.
+	 * @param Handler The handler on the server.
+	 * @return The shot index, or INDEX_NONE before the first accepted shot.
+	 */
+	static int32 GetLastAcceptedShotIndex(const UWeaponHandlingComponent* Handler) { return Handler->GetTickState().Model.LastAcceptedShotIndex; }
+};
+
+/**
+ * @class FThreadAllocationCountingMalloc
+ * @brief A proxy in front of the engine allocator that counts the allocations of the threads currently asking it to.
+ *
+ * It is put in front of GMalloc the first time a counter is used and never taken out, so no thread is ever left calling
+ * an allocator that has gone away. The count lives in a thread-local slot, so threads that are not counting are never
+ * counted and never touch the counting thread's state.
+ */
+class FThreadAllocationCountingMalloc final : public FMalloc
+{
+public:
+	/**
+	 * @brief Puts the proxy in front of GMalloc unless it already is.
+	 */
+	static void Install()
+	{
+		static FThreadAllocationCountingMalloc* const Proxy = []()
+		{
+			FThreadAllocationCountingMalloc* NewProxy = new FThreadAllocationCountingMalloc(GMalloc);
+			GMalloc = NewProxy;
+			return NewProxy;
+		}();
+		(void)Proxy;
+	}
+
+	virtual void* Malloc(const SIZE_T Count, const uint32 Alignment) override
+	{
+		CountAllocation();
+		return Inner->Malloc(Count, Alignment);
+	}
+
+	virtual void* TryMalloc(const SIZE_T Count, const uint32 Alignment) override
+	{
+		CountAllocation();
+		return Inner->TryMalloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, const SIZE_T Count, const uint32 Alignment) override
+	{
+		// Reallocating to nothing frees
+		if (Count > 0) { CountAllocation(); }
+		return Inner->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void* TryRealloc(void* Original, const SIZE_T Count, const uint32 Alignment) override
+	{
+		if (Count > 0) { CountAllocation(); }
+		return Inner->TryRealloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override { Inner->Free(Original); }
+	virtual SIZE_T QuantizeSize(const SIZE_T Count, const uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(const bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual void UpdateStats() override { Inner->UpdateStats(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+	virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+	virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+	virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+private:
+	friend class FScopedThreadAllocationCounter;
+
+	explicit FThreadAllocationCountingMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+	FORCEINLINE static void CountAllocation()
+	{
+		if (ActiveCount) { ++*ActiveCount; }
+	}
+
+	/** The allocator the proxy was put in front of. */
+	FMalloc* Inner;
+
+	/** The count of the innermost counter in scope on this thread, or nullptr if the thread is not counting. */
+	static inline thread_local int32* ActiveCount = nullptr;
+};
+
+/**
+ * @class FScopedThreadAllocationCounter
+ * @brief Counts the heap allocations the calling thread makes while in scope.
+ * Allocations made by other threads at the same time, such as background engine work, are not counted.
+ */
+class FScopedThreadAllocationCounter
+{
+public:
+	UE_NONCOPYABLE(FScopedThreadAllocationCounter);
+
+	FScopedThreadAllocationCounter() : Previous(FThreadAllocationCountingMalloc::ActiveCount)
+	{
+		FThreadAllocationCountingMalloc::Install();
+		FThreadAllocationCountingMalloc::ActiveCount = &Num;
+	}
+
+	~FScopedThreadAllocationCounter() { FThreadAllocationCountingMalloc::ActiveCount = Previous; }
+
+	/**
+	 * @brief Gets the number of allocations and reallocations made by the thread so far.
+	 * @return The count.
+	 */
+	int32 GetNum() const { return Num; }
+
+private:
+	/** The allocations counted so far. */
+	int32 Num = 0;
+
+	/** The counter that was in scope on this thread before this one, restored when this one goes out of scope. */
+	int32* Previous;
+};
+
+#endif
@@ -0,0 +1,338 @@
+/**
+ * @file WeaponModelTests.cpp
+ * @brief This file contains the automation tests of the FWeaponModel struct.
+ */
+
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponModel.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponFireNet.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace WeaponModelTests
+{
+	/**
+	 * @brief Makes a model armed with a rifle at the default fire rate.
+	 * @return The model, ready to fire.
+	 */
+	FWeaponModel MakeArmedModel()
+	{
+		FWeaponModel Model;
+		Model.SetArchetype(EWeaponArchetype::Rifle);
+		Model.MaxSpeed = 600.f;
+		return Model;
+	}
+
+	/**
+	 * @brief Steps a model until it settles.
+	 * @param Model The model to step.
+	 * @param bIntegrateSpread Whether the crosshair spread is integrated.
+	 * @param MaxSteps The most steps to take.
+	 * @return The number of steps taken, or MaxSteps if the model never settled.
+	 */
+	int32 StepUntilSettled(FWeaponModel& Model, const bool bIntegrateSpread, const int32 MaxSteps)
+	{
+		int32 Steps = 0;
+		while ( Steps < MaxSteps && !Model.IsSettled(bIntegrateSpread) ) {
+			Model.Step(bIntegrateSpread);
+			++Steps;
+		}
+		return Steps;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponModelTryFireTest, "LastShooter.WeaponHandling.Model.TryFire", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Checks that a shot needs a weapon and a ready trigger, numbers the shots and starts the cooldown and spread window.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FWeaponModelTryFireTest::RunTest( const FString& Parameters ) {
+	uint16 ShotIndex = 0;
+
+	FWeaponModel Unarmed;
+	TestFalse(TEXT("An unarmed handler does not fire"), Unarmed.TryFire(ShotIndex));
+	TestEqual(TEXT("A refused shot takes no index"), static_cast<int32>(Unarmed.NextShotIndex), 0);
+
+	FWeaponModel Model = WeaponModelTests::MakeArmedModel();
+	if ( !TestTrue(TEXT("An armed, ready handler fires"), Model.TryFire(ShotIndex)) ) { return false; }
+	TestEqual(TEXT("The first shot takes index 0"), static_cast<int32>(ShotIndex), 0);
+	TestFalse(TEXT("A shot clears the trigger"), Model.bReadyToFire);
+	TestEqual(TEXT("A shot starts the cooldown"), Model.FireCooldownSteps, Model.FireIntervalSteps);
+	TestEqual(TEXT("A shot opens the spread window"), Model.FiringSpreadSteps, Model.FiringSpreadWindowSteps);
+	TestTrue(TEXT("A shot counts as firing"), Model.IsFiringWeapon());
+
+	TestFalse(TEXT("No second shot during the cooldown"), Model.TryFire(ShotIndex));
+	TestEqual(TEXT("The refused shot leaves the index alone"), static_cast<int32>(Model.NextShotIndex), 1);
+
+	// Releasing the trigger re-arms the weapon at once
+	Model.bReadyToFire = true;
+	TestTrue(TEXT("A released trigger fires again"), Model.TryFire(ShotIndex));
+	TestEqual(TEXT("The second shot takes index 1"), static_cast<int32>(ShotIndex), 1);
+
+	// The index wraps around in 16 bits
+	Model.bReadyToFire = true;
+	Model.NextShotIndex = MAX_uint16;
+	Model.TryFire(ShotIndex);
+	TestEqual(TEXT("The last index is used"), static_cast<int32>(ShotIndex), static_cast<int32>(MAX_uint16));
+	TestEqual(TEXT("The index wraps to 0"), static_cast<int32>(Model.NextShotIndex), 0);
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponModelAcceptRemoteShotTest, "LastShooter.WeaponHandling.Model.AcceptRemoteShot", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Checks that the server refuses remote shots from an unarmed handler, shots past the fire rate and replayed indices.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FWeaponModelAcceptRemoteShotTest::RunTest( const FString& Parameters ) {
+	FWeaponModel Unarmed;
+	TestFalse(TEXT("An unarmed handler's shot is refused"), Unarmed.AcceptRemoteShot(0, 1.0));
+
+	FWeaponModel Model = WeaponModelTests::MakeArmedModel();
+	const double Interval = Model.FireIntervalSteps * FWeaponModel::StepSeconds;
+	double Now = 10.0;
+
+	TestTrue(TEXT("The first shot is accepted"), Model.AcceptRemoteShot(5, Now));
+	TestTrue(TEXT("A shot arriving in the same frame is accepted"), Model.AcceptRemoteShot(6, Now));
+
+	Now += Interval;
+	TestFalse(TEXT("A replayed index is refused"), Model.AcceptRemoteShot(6, Now));
+	TestFalse(TEXT("An older index is refused"), Model.AcceptRemoteShot(4, Now));
+	TestTrue(TEXT("A newer index may skip shots lost on the way"), Model.AcceptRemoteShot(9, Now));
+
+	// Indices compare in 16 bits, so the stream may wrap around
+	Model.LastAcceptedShotIndex = MAX_uint16;
+	Now += Interval;
+	TestTrue(TEXT("The index after the last one wraps to 0"), Model.AcceptRemoteShot(0, Now));
+	Now += Interval;
+	TestFalse(TEXT("An index from before the wrap is refused"), Model.AcceptRemoteShot(MAX_uint16 - 1, Now));
+
+	// The archetype and its fire rate outlive a respawn, the accepted shots do not
+	Model.Reset();
+	TestTrue(TEXT("A reset handler accepts any first shot"), Model.AcceptRemoteShot(0, Now));
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponModelRemoteFireRateTest, "LastShooter.WeaponHandling.Model.RemoteFireRate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Checks that shots bunched into one server frame get through, and that the sustained rate stays at the fire rate.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FWeaponModelRemoteFireRateTest::RunTest( const FString& Parameters ) {
+	FWeaponModel Model = WeaponModelTests::MakeArmedModel();
+	const double Interval = Model.FireIntervalSteps * FWeaponModel::StepSeconds;
+	uint16 ShotIndex = 0;
+
+	// A burst held back by a lost packet arrives all at once
+	const double Now = 10.0;
+	int32 NumAccepted = 0;
+	for ( int32 Shot = 0; Shot < FWeaponModel::RemoteShotBurst; ++Shot ) {
+		NumAccepted += Model.AcceptRemoteShot(ShotIndex++, Now) ? 1 : 0;
+	}
+	TestEqual(TEXT("A full burst arriving in the same frame is accepted"), NumAccepted, FWeaponModel::RemoteShotBurst);
+	TestFalse(TEXT("A shot past the burst in the same frame is refused"), Model.AcceptRemoteShot(ShotIndex++, Now));
+
+	// Shots sent twice as fast as the weapon fires are held to the fire rate once the burst is spent
+	constexpr int32 NumFastShots = 200;
+	NumAccepted = 0;
+	for ( int32 Shot = 1; Shot <= NumFastShots; ++Shot ) {
+		NumAccepted += Model.AcceptRemoteShot(ShotIndex++, Now + Shot * Interval * 0.5) ? 1 : 0;
+	}
+	TestTrue(TEXT("Fast shots are held to the fire rate"), FMath::Abs(NumAccepted - NumFastShots / 2) <= 1);
+
+	// Shots at the fire rate, delivered in pairs, are all accepted
+	const double PairStart = Now + (NumFastShots + 2) * Interval * 0.5 + Interval * FWeaponModel::RemoteShotBurst;
+	NumAccepted = 0;
+	for ( int32 Pair = 0; Pair < 50; ++Pair ) {
+		const double Arrival = PairStart + Pair * Interval * 2.0;
+		NumAccepted += Model.AcceptRemoteShot(ShotIndex++, Arrival) ? 1 : 0;
+		NumAccepted += Model.AcceptRemoteShot(ShotIndex++, Arrival) ? 1 : 0;
+	}
+	TestEqual(TEXT("Shots at the fire rate arriving in pairs are all accepted"), NumAccepted, 100);
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponModelRemoteSpreadFloorTest, "LastShooter.WeaponHandling.Model.RemoteSpreadFloor", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Checks that the server never refuses the spread of an honest client that jumps while firing, whichever of its
+ * movement and its shots reaches the server first, and that it refuses a tight spread claimed in mid-air.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FWeaponModelRemoteSpreadFloorTest::RunTest( const FString& Parameters ) {
+	// A round trip of 100 ms plus the default ping slack
+	constexpr double LeadSeconds = 0.2;
+	// Claims travel quantised to 1/32
+	constexpr float QuantisationSlack = 1.f / 32.f;
+
+	struct FArrival
+	{
+		double Time;
+		bool bIsShot;
+		bool bInAir;
+		uint16 ShotIndex;
+		float Claim;
+	};
+
+	for ( const double ShotDelay : { 0.05, 0.15 } ) {
+		const double MovementDelay = 0.2 - ShotDelay;
+
+		// The client aims, stands still, fires at the fire rate and jumps for 0.6 seconds in the middle
+		FWeaponModel Client = WeaponModelTests::MakeArmedModel();
+		Client.bIsAiming = true;
+		WeaponModelTests::StepUntilSettled(Client, true, 240);
+
+		TArray<FArrival> Arrivals;
+		for ( int32 Step = 0; Step < 180; ++Step ) {
+			const double Time = Step * FWeaponModel::StepSeconds;
+			const bool bInAir = Step >= 60 && Step < 96;
+			if ( bInAir != Client.bIsInAir ) {
+				Client.bIsInAir = bInAir;
+				Arrivals.Add({ Time + MovementDelay, false, bInAir, 0, 0.f });
+			}
+
+			FWeaponFireRequest Request;
+			Request.SetSpreadMultiplier(Client.CrosshairSpreadMultiplier);
+			uint16 ShotIndex;
+			if ( Client.TryFire(ShotIndex) ) { Arrivals.Add({ Time + ShotDelay, true, false, ShotIndex, Request.GetSpreadMultiplier() }); }
+
+			Client.Step(true);
+		}
+		Arrivals.StableSort([]( const FArrival& A, const FArrival& B ) { return A.Time < B.Time; });
+
+		FWeaponModel Server = WeaponModelTests::MakeArmedModel();
+		int32 NumRefused = 0;
+		for ( const FArrival& Arrival : Arrivals ) {
+			if ( !Arrival.bIsShot ) {
+				Server.SetRemoteInAir(Arrival.bInAir, Arrival.Time);
+				continue;
+			}
+			if ( Arrival.Claim < Server.GetRemoteSpreadFloor(Arrival.Time, LeadSeconds) - QuantisationSlack ) { ++NumRefused; }
+			Server.AcceptRemoteShot(Arrival.ShotIndex, Arrival.Time);
+		}
+		TestEqual(*FString::Printf(TEXT("No honest shot is refused with shots %.0f ms behind the movement"), (ShotDelay - MovementDelay) * 1000.0), NumRefused, 0);
+	}
+
+	// A handler at rest may claim the tightest spread there is
+	FWeaponModel Server = WeaponModelTests::MakeArmedModel();
+	TestEqual(TEXT("A handler at rest has the lowest floor"), Server.GetRemoteSpreadFloor(0.0, LeadSeconds), FWeaponModel::ClampSpreadMultiplier(-1.f), 1.e-4f);
+
+	// After a second in the air the claim of a still, aiming handler is far below anything it can have
+	Server.SetRemoteInAir(true, 0.0);
+	TestTrue(TEXT("A tight spread claimed in mid-air is below the floor by more than the default tolerance"), FWeaponModel::ClampSpreadMultiplier(-1.f) < Server.GetRemoteSpreadFloor(1.0, LeadSeconds) - 0.25f);
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponModelStepTest, "LastShooter.WeaponHandling.Model.Step", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Checks that stepping re-arms the weapon on the exact step, closes the spread window and blends the spread.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FWeaponModelStepTest::RunTest( const FString& Parameters ) {
+	FWeaponModel Model = WeaponModelTests::MakeArmedModel();
+	Model.FireIntervalSteps = 4;
+	Model.FiringSpreadWindowSteps = 2;
+
+	uint16 ShotIndex;
+	Model.TryFire(ShotIndex);
+
+	TestEqual(TEXT("Step 1 raises nothing"), static_cast<int32>(Model.Step(false)), 0);
+	TestEqual(TEXT("Step 2 closes the spread window"), static_cast<int32>(Model.Step(false)), static_cast<int32>(FWeaponModel::Event_FiringSpreadElapsed));
+	TestEqual(TEXT("Step 3 raises nothing"), static_cast<int32>(Model.Step(false)), 0);
+	TestFalse(TEXT("The weapon is not ready before the cooldown runs out"), Model.bReadyToFire);
+	TestEqual(TEXT("Step 4 ends the cooldown"), static_cast<int32>(Model.Step(false)), static_cast<int32>(FWeaponModel::Event_FireCooldownElapsed));
+	TestTrue(TEXT("The end of the cooldown re-arms the weapon"), Model.bReadyToFire);
+	TestEqual(TEXT("A settled model raises nothing"), static_cast<int32>(Model.Step(false)), 0);
+
+	// The default fire rate of 0.05 seconds is three steps
+	TestEqual(TEXT("0.05 seconds is three steps"), FWeaponModel::SecondsToSteps(0.05f), 3);
+	TestEqual(TEXT("Part of a step rounds up"), FWeaponModel::SecondsToSteps(FWeaponModel::StepSeconds * 1.5f), 2);
+
+	// Without integration the spread is left alone
+	Model.bIsInAir = true;
+	const float SpreadBefore = Model.CrosshairSpreadMultiplier;
+	Model.Step(false);
+	TestEqual(TEXT("Unviewed handlers keep their spread"), Model.CrosshairSpreadMultiplier, SpreadBefore);
+
+	// Jumping widens the crosshair towards its target without overshooting it
+	float Previous = Model.InAirCrosshairMultiplier;
+	bool bMonotonic = true;
+	for ( int32 Step = 0; Step < 120; ++Step ) {
+		Model.Step(true);
+		bMonotonic &= Model.InAirCrosshairMultiplier >= Previous && Model.InAirCrosshairMultiplier <= 3.f;
+		Previous = Model.InAirCrosshairMultiplier;
+	}
+	TestTrue(TEXT("The in-air spread rises without overshooting"), bMonotonic);
+	TestEqual(TEXT("Two seconds in the air reach the in-air spread"), Model.InAirCrosshairMultiplier, 3.f, 1.e-2f);
+	TestTrue(TEXT("The total stays in the range the server accepts"), Model.CrosshairSpreadMultiplier == FWeaponModel::ClampSpreadMultiplier(Model.CrosshairSpreadMultiplier));
+
+	// Running at full speed adds the whole accelerating spread at once
+	Model.PlayerSpeed = Model.MaxSpeed;
+	Model.Step(true);
+	TestEqual(TEXT("Full speed adds the accelerating spread"), Model.AcceleratingCrosshairMultiplier, 1.f);
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponModelIsSettledTest, "LastShooter.WeaponHandling.Model.IsSettled", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Checks that a model reports settled exactly when stepping would no longer change it.
+ * UWeaponHandlingSubsystem withdraws handlers once they settle, so settling too early freezes a cooldown or the crosshair.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FWeaponModelIsSettledTest::RunTest( const FString& Parameters ) {
+	using namespace WeaponModelTests;
+
+	FWeaponModel Model = MakeArmedModel();
+	TestTrue(TEXT("A fresh model is settled"), Model.IsSettled(true));
+
+	uint16 ShotIndex;
+	Model.TryFire(ShotIndex);
+	TestFalse(TEXT("A cooling down model is not settled"), Model.IsSettled(false));
+
+	// Without integration the model settles as soon as the cooldown and the spread window run out
+	FWeaponModel Unviewed = Model;
+	const int32 UnviewedSteps = StepUntilSettled(Unviewed, false, 600);
+	TestEqual(TEXT("An unviewed model settles with its cooldowns"), UnviewedSteps, FMath::Max(Model.FireIntervalSteps, Model.FiringSpreadWindowSteps));
+	TestTrue(TEXT("The settled model is ready to fire"), Unviewed.bReadyToFire);
+
+	// A viewed model also waits for the firing kick to decay
+	const int32 ViewedSteps = StepUntilSettled(Model, true, 600);
+	TestTrue(TEXT("A viewed model settles after its cooldowns"), ViewedSteps >= UnviewedSteps && ViewedSteps < 600);
+
+	// A settled model stays put
+	const FWeaponModel Settled = Model;
+	Model.Step(true);
+	TestEqual(TEXT("Stepping a settled model leaves the spread alone"), Model.CrosshairSpreadMultiplier, Settled.CrosshairSpreadMultiplier, 1.e-3f);
+
+	// Changing an input unsettles a viewed model, but not an unviewed one
+	Model.bIsAiming = true;
+	TestFalse(TEXT("Aiming unsettles a viewed model"), Model.IsSettled(true));
+	TestTrue(TEXT("Aiming leaves an unviewed model settled"), Model.IsSettled(false));
+	TestTrue(TEXT("The aiming blend settles"), StepUntilSettled(Model, true, 600) < 600);
+	TestEqual(TEXT("Aiming settles at the aiming spread"), Model.AimingCrosshairMultiplier, -0.5f, 1.e-3f);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * @file WeaponArchetypeTraits.cpp
+ * @brief This file contains the fire kernels of every weapon archetype.
+ */
+
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponArchetypeTraits.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponSpread.h"
+
+namespace WeaponFireKernel
+{
+	/**
+	 * @brief Gets the cone half angle of a shot fired by an archetype.
+	 * @tparam Archetype The archetype of the weapon.
+	 * @param SpreadMultiplier The crosshair spread multiplier when the shot was fired.
+	 * @return The half angle in degrees.
+	 */
+	template<EWeaponArchetype Archetype>
+	float GetShotHalfAngleDegrees(const float SpreadMultiplier)
+	{
+		using FTraits = TWeaponArchetypeTraits<Archetype>;
+		return FTraits::MinHalfAngleDegrees + FTraits::HalfAngleDegreesPerSpread * FMath::Max(SpreadMultiplier, 0.f);
+	}
+
+	/**
+	 * @brief Generates the pellet directions of a shot fired by an archetype.
+	 * @tparam Archetype The archetype of the weapon.
+	 * @param AimDirection The unit direction the shot is aimed at.
+	 * @param Seed The seed of the weapon.
+	 * @param ShotIndex The index of the shot in the weapon's spread stream.
+	 * @param SpreadMultiplier The crosshair spread multiplier when the shot was fired.
+	 * @param OutDirections Receives the unit direction of every pellet.
+	 * @return The number of pellets the shot fires.
+	 */
+	template<EWeaponArchetype Archetype>
+	int32 GenerateShot(const FVector& AimDirection, const uint32 Seed, const uint32 ShotIndex, const float SpreadMultiplier, FVector* OutDirections)
+	{
+		constexpr int32 NumPellets = TWeaponArchetypeTraits<Archetype>::NumPellets;
+		WeaponSpread::GeneratePelletDirections<NumPellets>(AimDirection, Seed, ShotIndex, GetShotHalfAngleDegrees<Archetype>(SpreadMultiplier), OutDirections);
+		return NumPellets;
+	}
+
+	/**
+	 * @brief Generates the kernel of an archetype from its traits.
+	 * @tparam Archetype The archetype of the weapon.
+	 * @return The kernel of the archetype.
+	 */
+	template<EWeaponArchetype Archetype>
+	constexpr FWeaponFireKernel MakeKernel()
+	{
+		using FTraits = TWeaponArchetypeTraits<Archetype>;
+		return { FTraits::NumPellets, FTraits::TraceLength, &GetShotHalfAngleDegrees<Archetype>, &GenerateShot<Archetype> };
+	}
+
+	/** The kernel of every archetype, indexed by EWeaponArchetype. */
+	static constexpr FWeaponFireKernel Kernels[] = {
+		MakeKernel<EWeaponArchetype::Unarmed>(),
+		MakeKernel<EWeaponArchetype::Pistol>(),
+		MakeKernel<EWeaponArchetype::Rifle>(),
+		MakeKernel<EWeaponArchetype::Shotgun>(),
+	};
+	static_assert(UE_ARRAY_COUNT(Kernels) == static_cast<SIZE_T>(EWeaponArchetype::Count), "Every weapon archetype needs a fire kernel");
+}
+
+
+/**
+ * @brief Gets the fire kernel of a weapon archetype.
+ * Unknown archetypes fire like an unarmed handler.
+ * @param Archetype The archetype of the weapon.
+ * @return The kernel of the archetype.
+ */
+const FWeaponFireKernel& WeaponFireKernel::Get( const EWeaponArchetype Archetype ) {
+	const SIZE_T Index = static_cast<SIZE_T>(Archetype);
+	return Kernels[Index < UE_ARRAY_COUNT(Kernels) ? Index : 0];
+}
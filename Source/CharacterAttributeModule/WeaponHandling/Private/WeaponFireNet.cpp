@@ -0,0 +1,89 @@
+/**
+ * @file WeaponFireNet.cpp
+ * @brief This file contains the implementation of the FWeaponFireRequest and FWeaponFireCosmetic structs.
+ */
+
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponFireNet.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace WeaponFireNet
+{
+	/**
+	 * @brief Serialises a struct into a scratch bit writer to measure it.
+	 * The writer is kept by the thread and reset for every measure, so the shots and flushes measured for the stats
+	 * do not allocate a writer each.
+	 * @param Value The struct to measure. Not modified; NetSerialize only reads while saving.
+	 * @return The serialised size in bits.
+	 */
+	template <typename StructType>
+	int64 MeasureBits(const StructType& Value)
+	{
+		static thread_local FBitWriter Writer(256, true);
+		Writer.Reset();
+
+		bool bSuccess = true;
+		const_cast<StructType&>(Value).NetSerialize(Writer, nullptr, bSuccess);
+		return Writer.GetNumBits();
+	}
+}
+
+
+/**
+ * @brief Rounds the aim ray the way the network will by writing the request out and reading it back.
+ * The rounding is done by NetSerialize, not by the archive, so a byte buffer kept by the thread serves as well as a
+ * bunch and quantising a shot stops allocating once the buffer has grown to fit one request.
+ */
+void FWeaponFireRequest::Quantize() {
+	static thread_local TArray<uint8> Scratch;
+	Scratch.Reset();
+
+	bool bSuccess = true;
+	FMemoryWriter Writer(Scratch);
+	NetSerialize(Writer, nullptr, bSuccess);
+
+	FMemoryReader Reader(Scratch);
+	NetSerialize(Reader, nullptr, bSuccess);
+}
+
+
+bool FWeaponFireRequest::NetSerialize( FArchive& Ar, UPackageMap* Map, bool& bOutSuccess ) {
+	Ar << Timestamp;
+	ViewOrigin.NetSerialize(Ar, Map, bOutSuccess);
+	ViewDirection.NetSerialize(Ar, Map, bOutSuccess);
+	Ar << ShotIndex;
+	Ar << QuantizedSpread;
+
+	static_assert(static_cast<uint8>(EWeaponArchetype::Count) <= 4, "The archetype of a shot is sent in two bits");
+	Ar.SerializeBits(&Archetype, 2);
+	return true;
+}
+
+
+/**
+ * @brief Measures the request as it is written to a bunch.
+ * @return The serialised size in bits.
+ */
+int64 FWeaponFireRequest::GetSerializedBits() const { return WeaponFireNet::MeasureBits(*this); }
+
+
+bool FWeaponFireCosmetic::NetSerialize( FArchive& Ar, UPackageMap* Map, bool& bOutSuccess ) {
+	TraceEnd.NetSerialize(Ar, Map, bOutSuccess);
+
+	uint8 Bits = (bHit ? 1 : 0) | (bFollowUpPellet ? 2 : 0);
+	Ar.SerializeBits(&Bits, 2);
+	bHit = (Bits & 1) != 0;
+	bFollowUpPellet = (Bits & 2) != 0;
+
+	// Misses only need to know where the beam ends
+	if ( bHit ) { ImpactNormal.NetSerialize(Ar, Map, bOutSuccess); }
+	return true;
+}
+
+
+/**
+ * @brief Measures the cosmetic as it is written to a bunch.
+ * @return The serialised size in bits.
+ */
+int64 FWeaponFireCosmetic::GetSerializedBits() const { return WeaponFireNet::MeasureBits(*this); }
@@ -4,94 +4,284 @@
  */
 
 #include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingComponent.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingSubsystem.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponModel.h"
+#include "CharacterAttributeModule/LagCompensation/Public/LagCompensationSubsystem.h"
+#include "CharacterAttributeModule/Hitbox/Public/HitboxSubsystem.h"
+#include "CharacterAttributeModule/Private/Profiling.h"
 #include "Camera/CameraComponent.h"
+#include "Engine/AssetManager.h"
 #include "Engine/SkeletalMeshSocket.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Sound/SoundCue.h"
+#include "WorldItemsModule/ItemPool/Public/ItemPoolSubsystem.h"
 #include "WorldItemsModule/Weapon/Public/Weapon.h"
 
 
+/** The beam particle parameter that receives the end of the weapon trace. Hashed once instead of per shot. */
+static const FName BeamTargetParameterName(TEXT("Target"));
+
+static TAutoConsoleVariable<float> CVarWeaponSpreadTolerance(
+	TEXT("LastShooter.Weapon.SpreadTolerance"),
+	0.25f,
+	TEXT("How far below the server's floor for a client's crosshair spread a shot may claim before the server refuses it."),
+	ECVF_Default);
+
+#if !UE_BUILD_SHIPPING
+static TAutoConsoleVariable<bool> CVarWeaponFireDebug(
+	TEXT("LastShooter.Weapon.DebugFire"),
+	false,
+	TEXT("Draws weapon trace lines and prints hit actors on screen for every shot, and prints pickup overlaps and equips."),
+	ECVF_Cheat);
+#endif
+
+
 /**
  * @brief Sets default values for this component's properties.
- * Initializes the component with default values for camera field of view, aiming state, and bullet spread multipliers.
- * Also sets the component to be initialized when the game starts and to be ticked every frame.
+ * Initializes the component with default values for camera field of view, aiming state, and fire rate.
+ * The component never ticks itself; UWeaponHandlingSubsystem advances it while it has pending work.
  */
-UWeaponHandlingComponent::UWeaponHandlingComponent() : DefaultCameraFOV(90), CurrentCameraFOV(DefaultCameraFOV), ZoomedCameraFOV(45), ZoomInterpSpeed(20), bIsAiming(false),
-
-//Crosshair multipliers default values for bullet spread
-AcceleratingCrosshairMultiplier(0), InAirCrosshairMultiplier(0), WeaponFireWeaponCrosshairMultiplier(0), AimingCrosshairMultiplier(0),bIsFiringWeapon(false),
+UWeaponHandlingComponent::UWeaponHandlingComponent() : bCosmeticTickRegistered(false), DefaultCameraFOV(90), ZoomedCameraFOV(45), ZoomInterpSpeed(20), bIsAiming(false),
 
 //Weapon fire rate
-bShouldFireWeapon(true), WeaponFireRate(0.05),
+WeaponFireRate(0.05),
 
 //Weapon Armed State
 bIsArmed(false), bIsArmedPistol(false), bIsArmedRifle(false), bIsArmedShotGun(false) {
-	// Set this component to be initialized when the game starts, and to be ticked every frame.
-	// You can turn these features off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
+	// Per-frame work is batched by UWeaponHandlingSubsystem instead of a per-component tick function
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// Carries the fire RPCs; the component has no replicated properties
+	SetIsReplicatedByDefault(true);
 }
 
 
 /**
  * @brief Called when the game starts.
- * Calls the parent class's BeginPlay function.
+ * Caches the weapon handling subsystem and seeds the tick state from the configured field of view.
+ * The owning character joins the hitbox layer, and on servers its hitbox starts being recorded for lag compensation and
+ * its movement mode is followed for the crosshair spread its client may claim.
+ * Machines that play shots pool the shot effects up front, so firing never constructs a particle component.
  */
-void UWeaponHandlingComponent::BeginPlay() { Super::BeginPlay(); }
+void UWeaponHandlingComponent::BeginPlay() {
+	Super::BeginPlay();
+
+	WeaponHandlingSubsystem = GetWorld()->GetSubsystem<UWeaponHandlingSubsystem>();
+
+	HitboxSubsystem = GetWorld()->GetSubsystem<UHitboxSubsystem>();
+	if ( HitboxSubsystem ) { HitboxSubsystem->RegisterCharacter(Cast<ACharacter>(GetOwner())); }
+
+	const ENetMode NetMode = GetNetMode();
+	if ( GetOwnerRole() == ROLE_Authority && (NetMode == NM_DedicatedServer || NetMode == NM_ListenServer) ) {
+		LagCompensationSubsystem = GetWorld()->GetSubsystem<ULagCompensationSubsystem>();
+		if ( LagCompensationSubsystem ) { LagCompensationSubsystem->RegisterCharacter(Cast<ACharacter>(GetOwner())); }
+
+		// The server follows the character's movement to judge the crosshair spread its client claims
+		if ( ACharacter* Character = Cast<ACharacter>(GetOwner()) ) { Character->MovementModeChangedDelegate.AddDynamic(this, &UWeaponHandlingComponent::HandleOwnerMovementModeChanged); }
+	}
+
+	TickState.CurrentCameraFOV = DefaultCameraFOV;
+	TickState.TargetCameraFOV = DefaultCameraFOV;
+	TickState.ZoomInterpSpeed = ZoomInterpSpeed;
+	TickState.Model.FireIntervalSteps = FWeaponModel::SecondsToSteps(WeaponFireRate);
+	TickState.SnapPresentation();
+
+	// Ignore the owner until a weapon is equipped
+	RefreshWeaponTraceParams(nullptr);
+
+	// A full batch is flushed before it grows past this
+	PendingFireCosmetics.Reserve(MaxBatchedShots);
+
+#if !UE_SERVER
+	if ( WeaponHandlingSubsystem && !IsRunningDedicatedServer() ) {
+		for ( UParticleSystem* Effect : { MuzzleFlash, BeamParticle, ImpactParticle } ) { WeaponHandlingSubsystem->PrewarmEffect(Effect, PrewarmedEffectCount); }
+	}
+#endif
+
+	// The cosmetic tick may have been registered before play began
+	RefreshTickEnrolment();
+}
 
 
 /**
- * @brief Called every frame.
- * Calls the parent class's TickComponent function.
- * @param DeltaTime The time since the last frame.
- * @param TickType The type of tick this frame.
- * @param ThisTickFunction The tick function that caused this to run.
+ * @brief Called when the component is removed from play.
+ * Withdraws the component from the batched update, the hitbox layer, the hitbox history and the character's movement
+ * events so nothing touches a dead component.
+ * @param EndPlayReason The reason play ended.
  */
-void UWeaponHandlingComponent::TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction ) { Super::TickComponent(DeltaTime, TickType, ThisTickFunction); }
+void UWeaponHandlingComponent::EndPlay( const EEndPlayReason::Type EndPlayReason ) {
+	if ( WeaponHandlingSubsystem ) { WeaponHandlingSubsystem->Withdraw(this); }
+	if ( LagCompensationSubsystem ) { LagCompensationSubsystem->UnregisterCharacter(Cast<ACharacter>(GetOwner())); }
+	if ( ACharacter* Character = Cast<ACharacter>(GetOwner()) ) { Character->MovementModeChangedDelegate.RemoveDynamic(this, &UWeaponHandlingComponent::HandleOwnerMovementModeChanged); }
+	if ( HitboxSubsystem ) { HitboxSubsystem->UnregisterCharacter(Cast<ACharacter>(GetOwner())); }
+
+	Super::EndPlay(EndPlayReason);
+}
+
+
+/**
+ * @brief Gets the live tick state.
+ * @return The slot in UWeaponHandlingSubsystem while enrolled, the component's own copy otherwise.
+ */
+FWeaponHandlingTickState& UWeaponHandlingComponent::GetMutableTickState() {
+	return TickSlot != INDEX_NONE ? WeaponHandlingSubsystem->GetState(TickSlot) : TickState;
+}
+
+
+/**
+ * @brief Gets the live tick state.
+ * @return The slot in UWeaponHandlingSubsystem while enrolled, the component's own copy otherwise.
+ */
+const FWeaponHandlingTickState& UWeaponHandlingComponent::GetTickState() const {
+	return TickSlot != INDEX_NONE ? WeaponHandlingSubsystem->GetState(TickSlot) : TickState;
+}
+
+
+/**
+ * @brief Enrols the component with UWeaponHandlingSubsystem if its tick state has pending work.
+ * Already enrolled components stay enrolled until the subsystem sees their state settle.
+ */
+void UWeaponHandlingComponent::RefreshTickEnrolment() {
+	if ( TickSlot == INDEX_NONE && WeaponHandlingSubsystem && TickState.HasPendingWork() ) { WeaponHandlingSubsystem->Enrol(this); }
+}
+
+
+/**
+ * @brief Reacts to the state advanced by UWeaponHandlingSubsystem this frame.
+ * The weapon model re-arms itself when its cooldown runs out, so only the blended field of view is pushed to the camera.
+ * @param State The advanced state of this component.
+ * @param Events The FWeaponModel::Event_* flags raised this frame.
+ */
+void UWeaponHandlingComponent::HandleTickEvents( const FWeaponHandlingTickState& State, const uint8 Events ) {
+	if ( State.bDrivesCamera ) { ChangeCameraFOV(State.PresentedCameraFOV); }
+}
+
+
+/**
+ * @brief Gets whether the weapon fire debug output is enabled.
+ * @return True if LastShooter.Weapon.DebugFire is set in a non-shipping client build, false otherwise.
+ */
+bool UWeaponHandlingComponent::IsFireDebugEnabled() {
+#if !UE_BUILD_SHIPPING && !UE_SERVER
+	// Nobody sees debug draws on a headless server
+	return !IsRunningDedicatedServer() && CVarWeaponFireDebug.GetValueOnGameThread();
+#else
+	return false;
+#endif
+}
+
+
+/**
+ * @brief Rebuilds the cached trace query params.
+ * Ignores the owner and the equipped weapon so neither trace collides with the shooter.
+ * @param EquippedWeapon The weapon currently held, or nullptr when unarmed.
+ */
+void UWeaponHandlingComponent::RefreshWeaponTraceParams( const AWeapon* EquippedWeapon ) {
+	WeaponTraceParams = FCollisionQueryParams(SCENE_QUERY_STAT(WeaponTrace), false, GetOwner());
+	if ( EquippedWeapon ) { WeaponTraceParams.AddIgnoredActor(EquippedWeapon); }
+	WorldTraceParamsSerial = MAX_uint32;
+}
+
+
+/**
+ * @brief Gets the aim ray of the owning controller.
+ * The ray goes through the center of the screen (crosshair location) for players and out of the pawn's eyes for AI.
+ * @param OutOrigin Receives the origin of the ray.
+ * @param OutDirection Receives the unit direction of the ray.
+ * @return True if the owner is controlled, false otherwise.
+ */
+bool UWeaponHandlingComponent::GetAimViewPoint( FVector& OutOrigin, FVector& OutDirection ) const {
+	// Trace from the owning controller's view point so bots and headless runs aim like players do
+	const APawn* OwnerPawn = Cast<APawn>(GetOwner());
+	const AController* OwnerController = OwnerPawn ? OwnerPawn->GetController() : nullptr;
+	if ( OwnerController == nullptr ) { return false; }
+
+	FRotator ViewRotation;
+	OwnerController->GetPlayerViewPoint(OutOrigin, ViewRotation);
+	OutDirection = ViewRotation.Vector();
+	return true;
+}
 
 
 /**
  * @brief Traces under the crosshair.
- * Performs a line trace from the center of the screen (crosshair location) and checks if it hits anything.
+ * Performs a line trace along the owning controller's aim ray and checks if it hits anything.
+ * The owner and the equipped weapon are ignored through the cached WeaponTraceParams.
  * @param TraceHitResult The result of the trace.
  * @param TraceEndLocation The end location of the trace.
- * @param ActorsToIgnore
  * @return True if the trace hit something, false otherwise.
- *
- * Todo: Add in a layer of abstraction to take in an array of actors to allow for ignoring of certain typoes of actors like the
- *		 player character and the weapon they are holding to avert the self collision that is currently happening with the weapon
- */
-bool UWeaponHandlingComponent::TraceUnderCrosshair( FHitResult& TraceHitResult, FVector& TraceEndLocation, TArray<AActor*>& ActorsToIgnore ) const {
-	// Get the viewport size
-	FVector2D ViewportSize;
-	GetWorld()->GetGameViewport()->GetViewportSize(ViewportSize);
-
-	// Calculate the crosshair location in the middle of the screen
-	const FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
-	FVector CrosshairWorldPosition;
-	FVector CrosshairWorldDirection;
-
-	// Convert the crosshair location from screen space to world space
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation, CrosshairWorldPosition, CrosshairWorldDirection);
-
-	if ( bScreenToWorld ) {
-		// Perform a line trace from the crosshair position into the world
-		const FVector TraceStart = CrosshairWorldPosition;
-		const FVector TraceEnd = TraceStart + CrosshairWorldDirection * 50000.f;
-		TraceEndLocation = TraceEnd;
-
-		FCollisionQueryParams TraceParams;
-		for (AActor* Actor : ActorsToIgnore) {
-			TraceParams.AddIgnoredActor(Actor);
-		}
-		
-		// Perform the line trace
-		GetWorld()->LineTraceSingleByChannel(TraceHitResult, TraceStart, TraceEnd, ECollisionChannel::ECC_Visibility, TraceParams);
-		if ( TraceHitResult.bBlockingHit ) {
-			// If the trace hit something, update the end location and return true
-			TraceEndLocation = TraceHitResult.Location;
-			return true;
-		}
+ */
+bool UWeaponHandlingComponent::TraceUnderCrosshair( FHitResult& TraceHitResult, FVector& TraceEndLocation ) const {
+	FVector ViewOrigin;
+	FVector ViewDirection;
+	return GetAimViewPoint(ViewOrigin, ViewDirection) && TraceAlongView(ViewOrigin, ViewDirection, TraceHitResult, TraceEndLocation);
+}
+
+
+/**
+ * @brief Traces one weapon ray against the world and the characters.
+ * While the hitbox layer is enabled the scene query ignores the characters registered with it, which the layer
+ * resolves by tracing the physics assets of the few the ray passes near. Other pawns are still hit by the scene query.
+ * The nearer of the two hits wins.
+ * A lag compensation rewind always goes through the layer, which is the only place the rewound hitboxes exist.
+ * @param TraceStart The start of the ray.
+ * @param TraceEnd The end of the ray.
+ * @param OutHit Receives the nearest hit.
+ * @return True if the ray hit something, false otherwise.
+ */
+bool UWeaponHandlingComponent::TraceWeaponRay( const FVector& TraceStart, const FVector& TraceEnd, FHitResult& OutHit ) const {
+	if ( HitboxSubsystem == nullptr || (!UHitboxSubsystem::IsEnabled() && !HitboxSubsystem->IsRewinding()) ) {
+		return GetWorld()->LineTraceSingleByChannel(OutHit, TraceStart, TraceEnd, ECollisionChannel::ECC_Visibility, WeaponTraceParams);
+	}
+
+	// Only rebuilt when a character joins or leaves the layer, never per ray
+	if ( WorldTraceParamsSerial != HitboxSubsystem->GetRegistrationSerial() ) {
+		WorldTraceParams = WeaponTraceParams;
+		HitboxSubsystem->AddIgnoredCharacters(WorldTraceParams);
+		WorldTraceParamsSerial = HitboxSubsystem->GetRegistrationSerial();
+	}
+	GetWorld()->LineTraceSingleByChannel(OutHit, TraceStart, TraceEnd, ECollisionChannel::ECC_Visibility, WorldTraceParams);
+
+	FHitResult CharacterHit;
+	if ( HitboxSubsystem->TraceCharacters(TraceStart, TraceEnd, WeaponTraceParams, CharacterHit) && (!OutHit.bBlockingHit || CharacterHit.Time < OutHit.Time) ) {
+		OutHit = CharacterHit;
+	}
+	return OutHit.bBlockingHit;
+}
+
+
+/**
+ * @brief Traces along an aim ray.
+ * The ray is given rather than read from the controller so the server can trace the ray a client sent.
+ * @param ViewOrigin The origin of the aim ray.
+ * @param ViewDirection The unit direction of the aim ray.
+ * @param TraceHitResult The result of the trace.
+ * @param TraceEndLocation The end location of the trace.
+ * @return True if the trace hit something, false otherwise.
+ */
+bool UWeaponHandlingComponent::TraceAlongView( const FVector& ViewOrigin, const FVector& ViewDirection, FHitResult& TraceHitResult, FVector& TraceEndLocation ) const {
+	CHARACTERATTRIBUTE_SCOPE(TraceUnderCrosshair);
+	CSV_CUSTOM_STAT(CharacterAttribute, TracesIssued, 1, ECsvCustomStatOp::Accumulate);
+
+	// Perform a line trace from the crosshair position into the world
+	const FVector TraceStart = ViewOrigin;
+	const FVector TraceEnd = TraceStart + ViewDirection * GetTickState().Model.GetKernel().TraceLength;
+	TraceEndLocation = TraceEnd;
+
+	// Perform the line trace
+	TraceWeaponRay(TraceStart, TraceEnd, TraceHitResult);
+	if ( TraceHitResult.bBlockingHit ) {
+		// If the trace hit something, update the end location and return true
+		TraceEndLocation = TraceHitResult.Location;
+		return true;
 	}
 	// If the trace didn't hit anything, return false
 	return false;
@@ -103,13 +293,32 @@ bool UWeaponHandlingComponent::TraceUnderCrosshair( FHitResult& TraceHitResult,
  * Performs a line trace from the weapon to the location under the crosshair and checks if it hits anything.
  * @param TraceStart The start location of the trace.
  * @param TraceEnd The end location of the trace.
- * @param TraceHitResult
- * @param ActorsToIgnore
+ * @param TraceHitResult The result of the crosshair trace.
  * @return True if the trace hit something, false otherwise.
  */
-bool UWeaponHandlingComponent::WeaponTrace( const FVector& TraceStart, FVector& TraceEnd, FHitResult& TraceHitResult, TArray<AActor*>& ActorsToIgnore ) const {
+bool UWeaponHandlingComponent::WeaponTrace( const FVector& TraceStart, FVector& TraceEnd, FHitResult& TraceHitResult ) const {
+	FVector ViewOrigin;
+	FVector ViewDirection;
+	if ( !GetAimViewPoint(ViewOrigin, ViewDirection) ) { return false; }
+
+	return WeaponTraceAlongView(ViewOrigin, ViewDirection, TraceStart, TraceEnd, TraceHitResult);
+}
+
+
+/**
+ * @brief Performs a weapon trace from the barrel towards whatever an aim ray hits.
+ * @param ViewOrigin The origin of the aim ray.
+ * @param ViewDirection The unit direction of the aim ray.
+ * @param TraceStart The start location of the barrel trace.
+ * @param TraceEnd The end location of the trace.
+ * @param TraceHitResult The result of the crosshair trace.
+ * @return True if the trace hit something, false otherwise.
+ */
+bool UWeaponHandlingComponent::WeaponTraceAlongView( const FVector& ViewOrigin, const FVector& ViewDirection, const FVector& TraceStart, FVector& TraceEnd, FHitResult& TraceHitResult ) const {
+	CHARACTERATTRIBUTE_SCOPE(WeaponTrace);
+
 	// Perform a trace under the crosshair
-	bool bCrosshairHit = TraceUnderCrosshair(TraceHitResult, TraceEnd, ActorsToIgnore);
+	bool bCrosshairHit = TraceAlongView(ViewOrigin, ViewDirection, TraceHitResult, TraceEnd);
 
 	if ( bCrosshairHit ) {
 		// If the crosshair trace hit something, update the end location
@@ -122,12 +331,12 @@ bool UWeaponHandlingComponent::WeaponTrace( const FVector& TraceStart, FVector&
 	const FVector StartToEnd = TraceEnd - TraceStart;
 	const FVector WeaponTraceEnd = TraceStart + StartToEnd * 1.25f;
 
-	
-	
-	GetWorld()->LineTraceSingleByChannel(WeaponTraceHit, WeaponTraceStart, WeaponTraceEnd, ECollisionChannel::ECC_Visibility);
+	// The barrel trace shares the crosshair trace's ignores so the shooter and their weapon are never hit
+	CSV_CUSTOM_STAT(CharacterAttribute, TracesIssued, 1, ECsvCustomStatOp::Accumulate);
+	TraceWeaponRay(WeaponTraceStart, WeaponTraceEnd, WeaponTraceHit);
 
 	//Todo: Fix the anim montage so the gun is always pointing in the direction you want to shoot so the trace works as intended. Motion matching skill issue
-	DrawDebugLine(GetWorld(), GetOwner()->GetActorLocation(), WeaponTraceHit.ImpactPoint, FColor::Red, false, 1.0f, 0, 5.0f);
+	if ( IsFireDebugEnabled() ) { DrawDebugLine(GetWorld(), GetOwner()->GetActorLocation(), WeaponTraceHit.ImpactPoint, FColor::Red, false, 1.0f, 0, 5.0f); }
 			
 	if ( WeaponTraceHit.bBlockingHit ) {
 		// If the weapon trace hit something, update the end location and return true
@@ -140,74 +349,113 @@ bool UWeaponHandlingComponent::WeaponTrace( const FVector& TraceStart, FVector&
 
 
 /**
- * @brief Changes the camera field of view based on whether the character is aiming or not.
- * @param DeltaTime The time since the last frame.
+ * @brief Registers the cosmetic per-frame work for the locally viewed pawn.
+ * @param InViewCamera The camera whose field of view follows the aiming state.
  */
-void UWeaponHandlingComponent::ChangeCameraFOV( float DeltaTime ) {
-	// Get the camera component
-	UCameraComponent* Camera = Cast<UCameraComponent>(GetOwner()->GetComponentByClass(UCameraComponent::StaticClass()));
-	if ( Camera ) {
-		// If the character is aiming, interpolate the camera field of view towards the zoomed field of view
-		// Otherwise, interpolate it towards the default field of view
-		if ( GetIsAiming() ) { CurrentCameraFOV = FMath::FInterpTo(CurrentCameraFOV, ZoomedCameraFOV, DeltaTime, ZoomInterpSpeed); }
-		else { CurrentCameraFOV = FMath::FInterpTo(CurrentCameraFOV, DefaultCameraFOV, DeltaTime, ZoomInterpSpeed); }
-		// Set the camera's field of view
-		Camera->SetFieldOfView(CurrentCameraFOV);
-	}
+void UWeaponHandlingComponent::RegisterCosmeticTick( UCameraComponent* InViewCamera ) {
+	// A headless server never views a pawn, so the crosshair and FOV blend must never enrol it
+	if ( IsRunningDedicatedServer() ) { return; }
+
+	ViewCamera = InViewCamera;
+	bCosmeticTickRegistered = true;
+
+	FWeaponHandlingTickState& State = GetMutableTickState();
+	State.bTracksSpread = true;
+	State.bDrivesCamera = ViewCamera != nullptr;
+	RefreshTickEnrolment();
+}
+
+
+/**
+ * @brief Unregisters the cosmetic per-frame work and drops the cached camera.
+ */
+void UWeaponHandlingComponent::UnregisterCosmeticTick() {
+	ViewCamera = nullptr;
+	bCosmeticTickRegistered = false;
+
+	FWeaponHandlingTickState& State = GetMutableTickState();
+	State.bTracksSpread = false;
+	State.bDrivesCamera = false;
+}
+
+
+/**
+ * @brief Feeds the cosmetic per-frame inputs for the locally viewed pawn.
+ * Skipped entirely for pawns nobody is viewing through.
+ * @param PlayerSpeed The current speed of the player.
+ * @param MaxSpeed The maximum speed of the player.
+ * @param bIsInAir Whether the player is in the air.
+ */
+void UWeaponHandlingComponent::TickCosmetic( const float PlayerSpeed, const float MaxSpeed, const bool bIsInAir ) {
+	if ( !bCosmeticTickRegistered ) { return; }
+
+	DynamicCrosshair(PlayerSpeed, MaxSpeed, bIsInAir);
+}
+
+
+/**
+ * @brief Applies the blended field of view to the camera cached by RegisterCosmeticTick.
+ * @param CameraFOV The field of view to apply.
+ */
+void UWeaponHandlingComponent::ChangeCameraFOV( const float CameraFOV ) const {
+	if ( ViewCamera ) { ViewCamera->SetFieldOfView(CameraFOV); }
 }
 
 
 /**
  * @brief Sets the aiming state of the character.
+ * Retargets the camera field of view towards the zoomed or default value.
  * @param bNewAiming The new aiming state.
  */
 void UWeaponHandlingComponent::SetIsAiming( bool bNewAiming ) {
 	// Set the aiming state
 	bIsAiming = bNewAiming;
+
+	FWeaponHandlingTickState& State = GetMutableTickState();
+	State.Model.bIsAiming = bIsAiming;
+	State.TargetCameraFOV = bIsAiming ? ZoomedCameraFOV : DefaultCameraFOV;
+	RefreshTickEnrolment();
 }
 
 
 /**
- * @brief Adjusts the crosshair spread based on various factors such as player speed, whether the player is in the air, and whether the player is aiming or firing.
- * @param DeltaTime The time since the last frame.
+ * @brief Updates the inputs the crosshair spread is calculated from.
+ * The spread depends on player speed, whether the player is in the air, and whether the player is aiming or firing.
+ * Blending is batched in UWeaponHandlingSubsystem; the component only enrols while the spread has not settled.
  * @param PlayerSpeed The current speed of the player.
  * @param MaxSpeed The maximum speed of the player.
  * @param bIsInAir Whether the player is in the air.
- * @param CrosshairMultiplier The multiplier for the crosshair spread.
  */
-void UWeaponHandlingComponent::DynamicCrosshair( float DeltaTime, const float PlayerSpeed, const float MaxSpeed, const bool bIsInAir, float& CrosshairMultiplier ) {
-	// Calculate the crosshair spread based on player speed
-	FVector2D VelocityMultiplier{0, 1};
-	FVector2D MovementSpeed{0, MaxSpeed};
-	AcceleratingCrosshairMultiplier = FMath::GetMappedRangeValueClamped(MovementSpeed, VelocityMultiplier, PlayerSpeed);
-
-	// If the player is in the air, increase the crosshair spread
-	if ( bIsInAir ) { InAirCrosshairMultiplier = FMath::FInterpTo(InAirCrosshairMultiplier, 3.0f, DeltaTime, 20.0f); }
-	else { InAirCrosshairMultiplier = FMath::FInterpTo(InAirCrosshairMultiplier, 0.0f, DeltaTime, 5.0f); }
-
-	// If the player is aiming, decrease the crosshair spread
-	if ( bIsAiming ) { AimingCrosshairMultiplier = FMath::FInterpTo(AimingCrosshairMultiplier, -0.5f, DeltaTime, 12); }
-	else { AimingCrosshairMultiplier = FMath::FInterpTo(AimingCrosshairMultiplier, 0.0f, DeltaTime, 15); }
+void UWeaponHandlingComponent::DynamicCrosshair( const float PlayerSpeed, const float MaxSpeed, const bool bIsInAir ) {
+	CHARACTERATTRIBUTE_SCOPE(DynamicCrosshair);
+
+	FWeaponHandlingTickState& State = GetMutableTickState();
+	State.Model.PlayerSpeed = PlayerSpeed;
+	State.Model.MaxSpeed = MaxSpeed;
+	State.Model.bIsInAir = bIsInAir;
+	RefreshTickEnrolment();
+}
 
-	// If the player is firing, increase the crosshair spread
-	if ( bIsFiringWeapon ) { WeaponFireWeaponCrosshairMultiplier = FMath::FInterpTo(WeaponFireWeaponCrosshairMultiplier, 0.3f, DeltaTime, 35); }
-	else { WeaponFireWeaponCrosshairMultiplier = FMath::FInterpTo(WeaponFireWeaponCrosshairMultiplier, 0.0f, DeltaTime, 60); }
 
-	// Calculate the total crosshair spread
-	CrosshairMultiplier = 0.5 + AcceleratingCrosshairMultiplier + InAirCrosshairMultiplier + AimingCrosshairMultiplier + WeaponFireWeaponCrosshairMultiplier;
+/**
+ * @brief Tells the weapon model when the server starts or stops moving the character through the air.
+ * @param Character The owning character.
+ * @param PrevMovementMode The movement mode before the change.
+ * @param PreviousCustomMode The custom movement mode before the change.
+ */
+void UWeaponHandlingComponent::HandleOwnerMovementModeChanged( ACharacter* Character, EMovementMode PrevMovementMode, uint8 PreviousCustomMode ) {
+	GetMutableTickState().Model.SetRemoteInAir(Character->GetCharacterMovement()->IsFalling(), GetWorld()->GetTimeSeconds());
 }
 
 
 /**
  * @brief Starts the firing of the weapon.
- * Sets the firing state to true and starts a timer to stop the firing after a certain duration.
+ * Opens a short window during which the crosshair spread is widened.
  */
 void UWeaponHandlingComponent::SetWeaponFireState() {
-	// Set the firing state to true
-	bIsFiringWeapon = true;
-
-	// Start a timer to stop firing after a certain duration
-	GetWorld()->GetTimerManager().SetTimer(DynamicCrosshairWeaponFireTimer, this, &UWeaponHandlingComponent::ResetWeaponFireState, 0.05f);
+	FWeaponModel& Model = GetMutableTickState().Model;
+	Model.FiringSpreadSteps = Model.FiringSpreadWindowSteps;
+	RefreshTickEnrolment();
 }
 
 
@@ -216,8 +464,8 @@ void UWeaponHandlingComponent::SetWeaponFireState() {
  * Sets the firing state to false.
  */
 void UWeaponHandlingComponent::ResetWeaponFireState() {
-	// Set the firing state to false
-	bIsFiringWeapon = false;
+	// Close the firing spread window
+	GetMutableTickState().Model.FiringSpreadSteps = 0;
 }
 
 
@@ -227,87 +475,353 @@ void UWeaponHandlingComponent::ResetWeaponFireState() {
  * @return The updated firing state.
  */
 bool UWeaponHandlingComponent::SetShouldFireWeapon( const bool bShouldFire ) {
-	bShouldFireWeapon = bShouldFire;
-	return bShouldFireWeapon;
+	GetMutableTickState().Model.bReadyToFire = bShouldFire;
+	return bShouldFire;
 }
 
 
 /**
- * @brief Resets the weapon fire timer.
+ * @brief Resets the weapon fire cooldown.
  * Sets the weapon to be ready to fire again.
  */
-void UWeaponHandlingComponent::AutoFireTimerReset() { bShouldFireWeapon = true; }
+void UWeaponHandlingComponent::AutoFireTimerReset() { GetMutableTickState().Model.bReadyToFire = true; }
 
 
 /**
- * @brief Sets the fire timer for auto-firing the weapon.
- * Fires the weapon and sets a timer to allow the weapon to fire again after a delay.
+ * @brief Fires the weapon and starts the auto-fire cooldown.
+ * The weapon model decides whether the shot goes off and starts its cooldown, which UWeaponHandlingSubsystem counts down.
  * @param BarrelSocketTransform The transform of the barrel socket.
  * @param WeaponFireTraceStart The start location of the weapon fire trace.
  * @param WeaponFireTraceEnd The end location of the weapon fire trace.
- * @param ActorsToIgnore
  */
-void UWeaponHandlingComponent::FireWeapon( const FTransform& BarrelSocketTransform, const FVector& WeaponFireTraceStart, FVector& WeaponFireTraceEnd, TArray<AActor*>& ActorsToIgnore ) {
-	// Fire the weapon and prevent it from firing again until the timer resets
-	ExecuteFireWeapon(BarrelSocketTransform, WeaponFireTraceStart, WeaponFireTraceEnd, ActorsToIgnore);
-	bShouldFireWeapon = false;
+void UWeaponHandlingComponent::FireWeapon( const FTransform& BarrelSocketTransform, const FVector& WeaponFireTraceStart, FVector& WeaponFireTraceEnd ) {
+	CHARACTERATTRIBUTE_SCOPE(FireWeapon);
 
-	// Set a timer to reset the weapon fire state after the fire rate delay
-	GetWorld()->GetTimerManager().SetTimer(WeaponFireTimer, this, &UWeaponHandlingComponent::AutoFireTimerReset, WeaponFireRate);
+	// The model starts the cooldown and the firing spread window and numbers the shot in the spread stream
+	uint16 ShotIndex;
+	if ( GetMutableTickState().Model.TryFire(ShotIndex) ) { ExecuteFireWeapon(BarrelSocketTransform, WeaponFireTraceStart, WeaponFireTraceEnd, ShotIndex); }
+	RefreshTickEnrolment();
 }
 
 
 /**
  * @brief Fires the weapon.
- * Plays the fire sound, performs a weapon trace, and spawns the muzzle flash and impact particles.
+ * Performs a weapon trace for every pellet of the shot and plays the shot straight away. The server queues the result
+ * for the other clients; a client sends its aim ray and shot index to the server, which derives the same pellets and
+ * traces them again.
  * @param BarrelSocketTransform The transform of the barrel socket.
  * @param WeaponFireTraceStart The start location of the weapon fire trace.
  * @param WeaponFireTraceEnd The end location of the weapon fire trace.
- * @param ActorsToIgnore
+ * @param ShotIndex The index the weapon model gave the shot in the spread stream.
  */
-void UWeaponHandlingComponent::ExecuteFireWeapon( const FTransform& BarrelSocketTransform, const FVector& WeaponFireTraceStart, FVector& WeaponFireTraceEnd, TArray<AActor*>& ActorsToIgnore ) {
-	if ( bShouldFireWeapon ) {
-		// Play the fire sound
-		if ( FireSound ) { UGameplayStatics::PlaySoundAtLocation(GetWorld(), FireSound, GetOwner()->GetActorLocation()); }
+void UWeaponHandlingComponent::ExecuteFireWeapon( const FTransform& BarrelSocketTransform, const FVector& WeaponFireTraceStart, FVector& WeaponFireTraceEnd, const uint16 ShotIndex ) {
+	CSV_CUSTOM_STAT(CharacterAttribute, ShotsFired, 1, ECsvCustomStatOp::Accumulate);
+
+	FVector ViewOrigin;
+	FVector ViewDirection;
+	if ( !GetAimViewPoint(ViewOrigin, ViewDirection) ) {
+		ViewOrigin = WeaponFireTraceStart;
+		ViewDirection = BarrelSocketTransform.GetRotation().GetForwardVector();
+	}
 
-		// Perform a weapon trace
-		FHitResult WeaponTraceHit;
-		WeaponTrace(WeaponFireTraceStart, WeaponFireTraceEnd, WeaponTraceHit, ActorsToIgnore);
+	// Round the shot the way the network will, so the pellets traced here are the ones the server traces
+	FWeaponFireRequest Request;
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	// Stamp the shot with the time of the world the shooter saw, which draws other characters behind the latest state
+	const double ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	Request.Timestamp = static_cast<float>(ServerTime - ULagCompensationSubsystem::GetProxyRenderDelaySeconds(GetOwner()));
+	Request.ViewOrigin = ViewOrigin;
+	Request.ViewDirection = ViewDirection;
+	Request.ShotIndex = ShotIndex;
+	Request.SetSpreadMultiplier(GetTickState().Model.CrosshairSpreadMultiplier);
+	Request.SetArchetype(GetTickState().Model.Archetype);
+	Request.Quantize();
+
+	// Perform a weapon trace for every pellet
+	FVector Directions[WeaponSpread::MaxPellets];
+	const int32 NumPellets = GenerateShotDirections(Request.ViewDirection.GetSafeNormal(), Request.ShotIndex, Request.GetSpreadMultiplier(), Directions);
+	TArray<FWeaponFireCosmetic, TInlineAllocator<WeaponSpread::MaxPellets>> Pellets;
+	FHitResult WeaponTraceHit;
+	// Every kernel fires at least one pellet; GeneratePelletDirections asserts it for each archetype at compile time
+	check(NumPellets > 0);
+	TracePellets(Request.ViewOrigin, MakeArrayView(Directions, NumPellets), WeaponFireTraceStart, Pellets, WeaponTraceHit);
+	WeaponFireTraceEnd = Pellets[0].TraceEnd;
+
+	if ( WeaponTraceHit.bBlockingHit && IsFireDebugEnabled() ) {
+		FString HitActorName = WeaponTraceHit.GetActor() ? WeaponTraceHit.GetActor()->GetName() : TEXT("Nothing");
+		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Hit: %s"), *HitActorName));
+		DrawDebugLine(GetWorld(), GetOwner()->GetActorLocation(), WeaponTraceHit.ImpactPoint, FColor::Red, false, 1.0f, 0, 5.0f);
+	}
 
-		// Spawn the muzzle flash
-		if ( MuzzleFlash ) { UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, BarrelSocketTransform.GetLocation()); }
+	// The shooter sees the shot without waiting for the server
+	for ( const FWeaponFireCosmetic& Pellet : Pellets ) { PlayFireCosmetics(BarrelSocketTransform, Pellet); }
 
-		// Spawn the impact particles
-		if ( ImpactParticle &&  WeaponTraceHit.bBlockingHit ) {
-			FString HitActorName = WeaponTraceHit.GetActor() ? WeaponTraceHit.GetActor()->GetName() : TEXT("Nothing");
-			GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Hit: %s"), *HitActorName));
-			DrawDebugLine(GetWorld(), GetOwner()->GetActorLocation(), WeaponTraceHit.ImpactPoint, FColor::Red, false, 1.0f, 0, 5.0f);
-			
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticle, WeaponTraceHit.ImpactPoint, WeaponTraceHit.ImpactNormal.Rotation());
-		}
-			// Spawn the beam particles
-		if ( BeamParticle ) {
-			UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticle, BarrelSocketTransform);
-			if ( Beam ) {
-				// Set the target of the beam to the end location of the weapon fire trace
-				Beam->SetVectorParameter("Target", WeaponFireTraceEnd);
-			}
+	if ( GetOwnerRole() == ROLE_Authority ) {
+		for ( const FWeaponFireCosmetic& Pellet : Pellets ) { QueueFireCosmetic(Pellet); }
+	}
+	else {
+		ServerFire(Request);
+
+#if !UE_BUILD_SHIPPING
+		const float RequestBytes = static_cast<float>(Request.GetSerializedBits()) / 8.f;
+		SET_FLOAT_STAT(STAT_FireRequestBytes, RequestBytes);
+		CSV_CUSTOM_STAT(CharacterAttribute, FireRequestBytes, RequestBytes, ECsvCustomStatOp::Accumulate);
+#endif
+	}
+}
+
+
+/**
+ * @brief Generates the pellet directions of a shot from the equipped weapon's deterministic spread stream.
+ * The cone widens with the crosshair spread, so the crosshair now shows where shots can actually land.
+ * @param ViewDirection The unit direction the shot is aimed at.
+ * @param ShotIndex The index of the shot in the weapon's spread stream.
+ * @param SpreadMultiplier The crosshair spread multiplier when the shot was fired.
+ * @param OutDirections Receives up to WeaponSpread::MaxPellets unit directions.
+ * @return The number of pellets the shot fires.
+ */
+int32 UWeaponHandlingComponent::GenerateShotDirections( const FVector& ViewDirection, const uint16 ShotIndex, const float SpreadMultiplier, FVector* OutDirections ) const {
+	// The kernel was picked when the weapon was equipped and has the pellet count and cone of the weapon built in
+	return GetTickState().Model.GetKernel().GenerateShot(ViewDirection, GetSpreadSeed(), ShotIndex, SpreadMultiplier, OutDirections);
+}
+
+
+/**
+ * @brief Traces every pellet of a shot and collects what they look like.
+ * @param ViewOrigin The origin of the aim ray.
+ * @param Directions The direction of every pellet.
+ * @param MuzzleLocation The start location of the barrel traces.
+ * @param OutPellets Receives the visible result of every pellet, the first one marked as the start of the shot.
+ * @param OutFirstHit Receives the crosshair trace result of the first pellet.
+ */
+void UWeaponHandlingComponent::TracePellets( const FVector& ViewOrigin, const TConstArrayView<FVector> Directions, const FVector& MuzzleLocation, TArray<FWeaponFireCosmetic, TInlineAllocator<WeaponSpread::MaxPellets>>& OutPellets, FHitResult& OutFirstHit ) const {
+	OutPellets.Reset();
+
+	for ( int32 Pellet = 0; Pellet < Directions.Num(); ++Pellet ) {
+		FVector TraceEnd;
+		FHitResult PelletHit;
+		WeaponTraceAlongView(ViewOrigin, Directions[Pellet], MuzzleLocation, TraceEnd, PelletHit);
+
+		FWeaponFireCosmetic& Shot = OutPellets.AddDefaulted_GetRef();
+		Shot.TraceEnd = TraceEnd;
+		Shot.ImpactNormal = PelletHit.ImpactNormal;
+		Shot.bHit = PelletHit.bBlockingHit;
+		Shot.bFollowUpPellet = Pellet > 0;
+
+		if ( Pellet == 0 ) { OutFirstHit = PelletHit; }
+	}
+}
+
+
+/**
+ * @brief Gets the seed of the equipped weapon's spread stream.
+ * Built from the owner's replicated player id and the archetype of the weapon model. ServerFire drops shots whose
+ * archetype differs from the one the server has equipped, so both sides seed the stream from the same state.
+ * @return The seed of the stream.
+ */
+uint32 UWeaponHandlingComponent::GetSpreadSeed() const {
+	const APawn* OwnerPawn = Cast<APawn>(GetOwner());
+	const APlayerState* PlayerState = OwnerPawn ? OwnerPawn->GetPlayerState() : nullptr;
+	return WeaponSpread::MakeWeaponSeed(PlayerState ? PlayerState->GetPlayerId() : 0, GetTickState().Model.Archetype);
+}
+
+
+/**
+ * @brief Plays the sound, muzzle flash, beam and impact of a shot. Never traces.
+ * Further pellets of a shot only play their beam and impact. The effects come from the world's particle pool, which
+ * takes them back when they finish, so steady fire reuses the same components.
+ * Compiled out of server builds and skipped by client builds running as a dedicated server.
+ * @param BarrelSocketTransform The transform of the barrel socket.
+ * @param Shot The visible result of the shot, or of one further pellet of it.
+ */
+void UWeaponHandlingComponent::PlayFireCosmetics( const FTransform& BarrelSocketTransform, const FWeaponFireCosmetic& Shot ) const {
+#if !UE_SERVER
+	if ( IsRunningDedicatedServer() ) { return; }
+
+	// Play the fire sound
+	if ( FireSound && !Shot.bFollowUpPellet ) { UGameplayStatics::PlaySoundAtLocation(GetWorld(), FireSound, GetOwner()->GetActorLocation()); }
+
+	// Everything spawned for the shot's effects is accounted to the weapon VFX budget
+	LLM_SCOPE_BYTAG(CharacterAttribute_WeaponVFX);
+
+	// Spawn the muzzle flash
+	if ( MuzzleFlash && !Shot.bFollowUpPellet ) {
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, BarrelSocketTransform.GetLocation(), FRotator::ZeroRotator, FVector(1.f), true, EPSCPoolMethod::AutoRelease);
+		CSV_CUSTOM_STAT(CharacterAttribute, VFXSpawned, 1, ECsvCustomStatOp::Accumulate);
+	}
+
+	// Spawn the impact particles
+	if ( ImpactParticle && Shot.bHit ) {
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticle, Shot.TraceEnd, Shot.ImpactNormal.Rotation(), FVector(1.f), true, EPSCPoolMethod::AutoRelease);
+		CSV_CUSTOM_STAT(CharacterAttribute, VFXSpawned, 1, ECsvCustomStatOp::Accumulate);
+	}
+
+	// Spawn the beam particles
+	if ( BeamParticle ) {
+		UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticle, BarrelSocketTransform, true, EPSCPoolMethod::AutoRelease);
+		CSV_CUSTOM_STAT(CharacterAttribute, VFXSpawned, 1, ECsvCustomStatOp::Accumulate);
+		if ( Beam ) {
+			// Set the target of the beam to the end location of the weapon fire trace
+			Beam->SetVectorParameter(BeamTargetParameterName, Shot.TraceEnd);
 		}
+	}
+#endif
+}
+
+
+/**
+ * @brief Gets the muzzle of the equipped weapon, or the owner's transform when unarmed.
+ * @return The world transform shots are played from.
+ */
+FTransform UWeaponHandlingComponent::GetMuzzleTransform() const {
+	return MuzzleWeapon ? MuzzleWeapon->GetMuzzleTransform() : GetOwner()->GetActorTransform();
+}
+
 
-		// Update the weapon fire state
-		SetWeaponFireState();
+/**
+ * @brief Traces a client's shot on the server and queues its result for the other clients.
+ *
+ * The shot is ignored if the weapon is not armed, the shot comes sooner than half the fire rate after the last one
+ * (the client's own cooldown already spaces them, the slack absorbs jitter) or the aim ray starts too far from the pawn.
+ * It is also ignored if the client fired a different archetype than the server has equipped, which happens for the
+ * shots in flight while an equip or drop replicates; tracing them would use the wrong pellets and cone.
+ * Characters near the shot are rewound to the request's timestamp for the trace, so hits are judged on what the shooter saw.
+ * The pellets are derived from the shot index, which must be newer than the last accepted one so a client cannot
+ * replay an index whose spread happened to land well. The server does not see the client's aim and exact speed, so it
+ * cannot recompute the crosshair spread, but it follows the character's movement mode and the shots it accepted and
+ * derives the tightest spread the client could honestly have; a shot claiming less than that, beyond
+ * LastShooter.Weapon.SpreadTolerance, is ignored. The multiplier is also clamped to the range the spread blend can produce.
+ * @param Request The aim ray and time of the shot.
+ */
+void UWeaponHandlingComponent::ServerFire_Implementation( const FWeaponFireRequest& Request ) {
+	CHARACTERATTRIBUTE_SCOPE(ServerFire);
+
+	if ( FVector::DistSquared(Request.ViewOrigin, GetOwner()->GetActorLocation()) > FMath::Square(MaxFireOriginOffset) ) { return; }
+	if ( Request.GetArchetype() != GetTickState().Model.Archetype ) { return; }
+
+	// What the server sees of the character can be up to a round trip away from what its client saw
+	FWeaponModel& Model = GetMutableTickState().Model;
+	const double Now = GetWorld()->GetTimeSeconds();
+	const float SpreadFloor = Model.GetRemoteSpreadFloor(Now, ULagCompensationSubsystem::GetMaxRewindSeconds(GetOwner()));
+	if ( Request.GetSpreadMultiplier() < SpreadFloor - CVarWeaponSpreadTolerance.GetValueOnGameThread() ) { return; }
+	if ( !Model.AcceptRemoteShot(Request.ShotIndex, Now) ) { return; }
+
+	const FTransform MuzzleTransform = GetMuzzleTransform();
+	FVector Directions[WeaponSpread::MaxPellets];
+	FVector RayEnds[WeaponSpread::MaxPellets];
+	// Quantised again after clamping, so an honest multiplier comes out exactly as the client traced it
+	FWeaponFireRequest SpreadRequest;
+	SpreadRequest.SetSpreadMultiplier(FWeaponModel::ClampSpreadMultiplier(Request.GetSpreadMultiplier()));
+	const int32 NumPellets = GenerateShotDirections(Request.ViewDirection.GetSafeNormal(), Request.ShotIndex, SpreadRequest.GetSpreadMultiplier(), Directions);
+	const float TraceLength = GetTickState().Model.GetKernel().TraceLength;
+	for ( int32 Pellet = 0; Pellet < NumPellets; ++Pellet ) { RayEnds[Pellet] = Request.ViewOrigin + Directions[Pellet] * TraceLength; }
+
+	TArray<FWeaponFireCosmetic, TInlineAllocator<WeaponSpread::MaxPellets>> Pellets;
+	FHitResult WeaponTraceHit;
+	{
+		// Trace against the characters where the shooter saw them when they pulled the trigger
+		const FLagCompensationRewindScope Rewind(LagCompensationSubsystem, Request.Timestamp, Request.ViewOrigin, MakeArrayView(RayEnds, NumPellets), GetOwner());
+		TracePellets(Request.ViewOrigin, MakeArrayView(Directions, NumPellets), MuzzleTransform.GetLocation(), Pellets, WeaponTraceHit);
+	}
+
+	for ( const FWeaponFireCosmetic& Pellet : Pellets ) {
+		// A listen server's own player sees the shot as well
+		if ( GetNetMode() != NM_DedicatedServer ) { PlayFireCosmetics(MuzzleTransform, Pellet); }
+		QueueFireCosmetic(Pellet);
 	}
 }
 
 
+/**
+ * @brief Queues the visible result of a shot for the next net update.
+ * Standalone games have nobody to send it to.
+ * @param Shot The shot to fan out.
+ */
+void UWeaponHandlingComponent::QueueFireCosmetic( const FWeaponFireCosmetic& Shot ) {
+	if ( GetNetMode() == NM_Standalone ) { return; }
+
+	PendingFireCosmetics.Add(Shot);
+	if ( PendingFireCosmetics.Num() >= MaxBatchedShots ) { FlushFireCosmetics(); }
+}
+
+
+/**
+ * @brief Sends the queued shots in one multicast.
+ */
+void UWeaponHandlingComponent::FlushFireCosmetics() {
+	if ( PendingFireCosmetics.Num() == 0 ) { return; }
+
+#if !UE_BUILD_SHIPPING
+	int64 CosmeticBits = 0;
+	for ( const FWeaponFireCosmetic& Shot : PendingFireCosmetics ) { CosmeticBits += Shot.GetSerializedBits(); }
+	const float BytesPerShot = static_cast<float>(CosmeticBits) / 8.f / static_cast<float>(PendingFireCosmetics.Num());
+	SET_FLOAT_STAT(STAT_FireCosmeticBytesPerShot, BytesPerShot);
+	CSV_CUSTOM_STAT(CharacterAttribute, FireCosmeticBytesPerShot, BytesPerShot, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(CharacterAttribute, FireCosmeticBatchSize, PendingFireCosmetics.Num(), ECsvCustomStatOp::Max);
+#endif
+
+	MulticastFireCosmetics(PendingFireCosmetics);
+	PendingFireCosmetics.Reset();
+}
+
+
+/**
+ * @brief Sends the shots queued since the last net update.
+ * Called by the owning actor right before it replicates, so every shot between two updates shares one multicast.
+ * @param ChangedPropertyTracker The tracker of the owning actor's replicated properties.
+ */
+void UWeaponHandlingComponent::PreReplication( IRepChangedPropertyTracker& ChangedPropertyTracker ) {
+	Super::PreReplication(ChangedPropertyTracker);
+
+	FlushFireCosmetics();
+}
+
+
+/**
+ * @brief Plays the shots of another player on this client.
+ * The shooter already played its own shots and the server played them when it traced them.
+ * @param Shots The shots fired since the last net update, oldest first.
+ */
+void UWeaponHandlingComponent::MulticastFireCosmetics_Implementation( const TArray<FWeaponFireCosmetic>& Shots ) {
+	const APawn* OwnerPawn = Cast<APawn>(GetOwner());
+	if ( GetOwnerRole() == ROLE_Authority || (OwnerPawn && OwnerPawn->IsLocallyControlled()) ) { return; }
+
+	const FTransform MuzzleTransform = GetMuzzleTransform();
+	for ( const FWeaponFireCosmetic& Shot : Shots ) {
+		PlayFireCosmetics(MuzzleTransform, Shot);
+		if ( !Shot.bFollowUpPellet ) { OnRemoteWeaponFired.Broadcast(); }
+	}
+}
+
+
+/**
+ * @brief Starts loading the default weapon class and its assets in the background.
+ * The handle is kept so the loadout stays resident for later respawns, which then complete immediately.
+ * @param OnLoaded Called when the default weapon class is ready.
+ */
+void UWeaponHandlingComponent::RequestDefaultWeaponLoad( FStreamableDelegate OnLoaded ) {
+	if ( DefaultWeaponClass.IsNull() ) {
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+
+	DefaultWeaponLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(DefaultWeaponClass.ToSoftObjectPath(), MoveTemp(OnLoaded), FStreamableManager::AsyncLoadHighPriority);
+}
+
+
 /**
  * @brief Spawns the default weapon for the character.
- * Spawns the default weapon specified by DefaultWeaponClass and attaches it to the right hand weapon socket.
- * @return The spawned weapon actor.
+ * Spawns the default weapon specified by DefaultWeaponClass. Never loads synchronously.
+ * @return The spawned weapon actor, or nullptr if the class is not loaded.
  */
 AWeapon* UWeaponHandlingComponent::SpawnDefaultWeapon() const{
-	if ( DefaultWeaponClass ) { return GetWorld()->SpawnActor<AWeapon>(DefaultWeaponClass); }
-	return nullptr;
+	LLM_SCOPE_BYTAG(CharacterAttribute_Weapons);
+	UClass* WeaponClass = DefaultWeaponClass.Get();
+	if ( WeaponClass == nullptr ) { return nullptr; }
+
+	// Reuse a pooled weapon so respawns and match resets do not spawn new actors
+	if ( UItemPoolSubsystem* ItemPool = GetWorld()->GetSubsystem<UItemPoolSubsystem>() ) { return Cast<AWeapon>(ItemPool->AcquireItem(WeaponClass, GetOwner()->GetActorTransform())); }
+	return GetWorld()->SpawnActor<AWeapon>(WeaponClass);
 }
 
 
@@ -320,6 +834,8 @@ AWeapon* UWeaponHandlingComponent::SpawnDefaultWeapon() const{
  * @param PlayerMesh The skeletal mesh component of the player.
  */
 void UWeaponHandlingComponent::EquipWeapon(AWeapon* WeaponToEquip, AWeapon*& EquippedWeapon, const USkeletalMeshSocket* WeaponSlotSocket, USkeletalMeshComponent* PlayerMesh) {
+	CHARACTERATTRIBUTE_SCOPE(EquipWeapon);
+
 	// Attach the weapon to the specified socket on the player's mesh
 	if ( WeaponSlotSocket && WeaponToEquip != nullptr && EquippedWeapon == nullptr ) {
 		WeaponSlotSocket->AttachActor(WeaponToEquip, PlayerMesh);
@@ -327,19 +843,7 @@ void UWeaponHandlingComponent::EquipWeapon(AWeapon* WeaponToEquip, AWeapon*& Equ
 
 		if ( EquippedWeapon != nullptr ) {
 			EquippedWeapon->SetItemState(EItemState::EIS_Equipped);
-
-			switch ( EquippedWeapon->GetWeaponType() ) {
-			case EWeaponType::EWT_Pistol: SetPlayerArmedState(EPlayerArmedState::EPAS_Pistol);
-				break;
-
-			case EWeaponType::EWT_Rifle: SetPlayerArmedState(EPlayerArmedState::EPAS_Rifle);
-				break;
-
-			case EWeaponType::EWT_Shotgun: SetPlayerArmedState(EPlayerArmedState::EPAS_Shotgun);
-				break;
-
-			default: break;
-			}
+			AdoptEquippedWeapon(EquippedWeapon);
 		}
 	}
 	else {
@@ -348,6 +852,38 @@ void UWeaponHandlingComponent::EquipWeapon(AWeapon* WeaponToEquip, AWeapon*& Equ
 }
 
 
+/**
+ * @brief Takes on the trace ignores, the muzzle and the armed state of the weapon now held.
+ * The weapon must already be attached, its muzzle may be on the mesh holding it.
+ * @param Weapon The weapon now held, or nullptr when unarmed.
+ */
+void UWeaponHandlingComponent::AdoptEquippedWeapon( AWeapon* Weapon ) {
+	// The ignore set and the muzzle only change with the equipped weapon, so resolve them here rather than per shot
+	RefreshWeaponTraceParams(Weapon);
+	MuzzleWeapon = Weapon;
+
+	if ( Weapon == nullptr ) {
+		SetPlayerArmedState(EPlayerArmedState::EPAS_Unarmed);
+		return;
+	}
+
+	Weapon->ResolveMuzzle();
+
+	switch ( Weapon->GetWeaponType() ) {
+	case EWeaponType::EWT_Pistol: SetPlayerArmedState(EPlayerArmedState::EPAS_Pistol);
+		break;
+
+	case EWeaponType::EWT_Rifle: SetPlayerArmedState(EPlayerArmedState::EPAS_Rifle);
+		break;
+
+	case EWeaponType::EWT_Shotgun: SetPlayerArmedState(EPlayerArmedState::EPAS_Shotgun);
+		break;
+
+	default: break;
+	}
+}
+
+
 /**
  * @brief Drops the equipped weapon.
  * Detaches the weapon from the player's skeletal mesh and sets its state to falling.
@@ -361,40 +897,91 @@ void UWeaponHandlingComponent::DropWeapon( AWeapon*& WeaponToDrop) {
 		WeaponToDrop->DetachFromActor(DetachmentTransformRules);
 		WeaponToDrop->SetItemState(EItemState::EIS_Falling);
 		WeaponToDrop->ThrowItem();
-		
+
+		// The dropped weapon is fair game for traces again
+		RefreshWeaponTraceParams(nullptr);
+		MuzzleWeapon = nullptr;
+	}
+}
+
+
+/**
+ * @brief Returns the equipped weapon to the item pool.
+ * Detaches the weapon, parks it in the pool and leaves the player unarmed.
+ * @param WeaponToRelease A reference to the weapon to be released. Cleared on return.
+ */
+void UWeaponHandlingComponent::ReleaseWeapon( AWeapon*& WeaponToRelease ) {
+	if ( WeaponToRelease ) {
+		const FDetachmentTransformRules DetachmentTransformRules(EDetachmentRule::KeepWorld, true);
+		WeaponToRelease->DetachFromActor(DetachmentTransformRules);
+
+		if ( UItemPoolSubsystem* ItemPool = GetWorld()->GetSubsystem<UItemPoolSubsystem>() ) { ItemPool->ReleaseItem(WeaponToRelease); }
+		else { WeaponToRelease->Destroy(); }
+
+		WeaponToRelease = nullptr;
+		RefreshWeaponTraceParams(nullptr);
+		MuzzleWeapon = nullptr;
 	}
+
+	SetPlayerArmedState(EPlayerArmedState::EPAS_Unarmed);
 }
 
 
-void UWeaponHandlingComponent::SetPlayerArmedState( EPlayerArmedState NewPlayerArmedState ) {
-	switch ( NewPlayerArmedState )  {
-		case EPlayerArmedState::EPAS_Unarmed: bIsArmed = false;
-			bIsArmedPistol = false;
-			bIsArmedRifle = false;
-			bIsArmedShotGun = false;
+/**
+ * @brief Returns the handling state to how it was when play began.
+ * Used when a pawn is pooled or respawned so nothing of its previous life carries over.
+ */
+void UWeaponHandlingComponent::ResetHandlingState() {
+	if ( WeaponHandlingSubsystem ) { WeaponHandlingSubsystem->Withdraw(this); }
+
+	const bool bTracksSpread = TickState.bTracksSpread;
+	const bool bDrivesCamera = TickState.bDrivesCamera;
+	// Shots of the previous life are not held against the next one, which may belong to another player whose
+	// client counts its shots from zero. The armed state and fire rate outlive the reset.
+	FWeaponModel Model = TickState.Model;
+	Model.Reset();
+
+	TickState = FWeaponHandlingTickState();
+	TickState.Model = Model;
+	TickState.CurrentCameraFOV = DefaultCameraFOV;
+	TickState.TargetCameraFOV = DefaultCameraFOV;
+	TickState.ZoomInterpSpeed = ZoomInterpSpeed;
+	TickState.bTracksSpread = bTracksSpread;
+	TickState.bDrivesCamera = bDrivesCamera;
+	TickState.SnapPresentation();
+
+	bIsAiming = false;
+	ChangeCameraFOV(DefaultCameraFOV);
+
+	// Shots of the previous life are not sent
+	PendingFireCosmetics.Reset();
+}
+
+
+/**
+ * @brief Sets the armed state of the weapon model and mirrors it into the Blueprint-visible flags.
+ * @param NewPlayerArmedState The new armed state.
+ */
+void UWeaponHandlingComponent::SetPlayerArmedState( const EPlayerArmedState NewPlayerArmedState ) {
+	EWeaponArchetype Archetype;
+	switch ( NewPlayerArmedState ) {
+		case EPlayerArmedState::EPAS_Pistol: Archetype = EWeaponArchetype::Pistol;
 			break;
 
-		case EPlayerArmedState::EPAS_Pistol:
-			bIsArmed = true;
-			bIsArmedPistol = true;
-			bIsArmedRifle = false;
-			bIsArmedShotGun = false;
+		case EPlayerArmedState::EPAS_Rifle: Archetype = EWeaponArchetype::Rifle;
 			break;
 
-		case EPlayerArmedState::EPAS_Rifle:
-			bIsArmed = true;
-			bIsArmedPistol = false;
-			bIsArmedRifle = true;
-			bIsArmedShotGun = false;
+		case EPlayerArmedState::EPAS_Shotgun: Archetype = EWeaponArchetype::Shotgun;
 			break;
 
-		case EPlayerArmedState::EPAS_Shotgun:
-			bIsArmed = true;
-			bIsArmedPistol = false;
-			bIsArmedRifle = false;
-			bIsArmedShotGun = true;
+		default: Archetype = EWeaponArchetype::Unarmed;
 			break;
+	}
+
+	GetMutableTickState().Model.SetArchetype(Archetype);
 
-		default: break;;
-	} 
+	bIsArmed = Archetype != EWeaponArchetype::Unarmed;
+	bIsArmedPistol = Archetype == EWeaponArchetype::Pistol;
+	bIsArmedRifle = Archetype == EWeaponArchetype::Rifle;
+	bIsArmedShotGun = Archetype == EWeaponArchetype::Shotgun;
 }
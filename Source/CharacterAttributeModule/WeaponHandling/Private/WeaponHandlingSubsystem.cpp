@@ -0,0 +1,155 @@
+/**
+ * @file WeaponHandlingSubsystem.cpp
+ * @brief This file contains the implementation of the UWeaponHandlingSubsystem class.
+ */
+
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingSubsystem.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingComponent.h"
+#include "CharacterAttributeModule/Private/Profiling.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Particles/WorldPSCPool.h"
+
+/** The most steps run in one frame. A longer hitch drops the excess time rather than spiralling. */
+static constexpr int32 MaxStepsPerFrame = 8;
+
+
+/**
+ * @brief Enrols a handler so its state is advanced every frame.
+ * @param Handler The weapon handler to enrol.
+ */
+void UWeaponHandlingSubsystem::Enrol( UWeaponHandlingComponent* Handler ) {
+	if ( Handler == nullptr || Handler->TickSlot != INDEX_NONE ) { return; }
+
+	// The state was set directly while withdrawn, so there is no earlier step to blend from
+	Handler->TickState.SnapPresentation();
+	Handler->TickSlot = ActiveStates.Add(Handler->TickState);
+	ActiveHandlers.Add(Handler);
+	ActiveEvents.Add(0);
+}
+
+
+/**
+ * @brief Withdraws a handler and copies its active state back onto the component.
+ * @param Handler The weapon handler to withdraw.
+ */
+void UWeaponHandlingSubsystem::Withdraw( UWeaponHandlingComponent* Handler ) {
+	if ( Handler == nullptr || Handler->TickSlot == INDEX_NONE ) { return; }
+
+	RemoveAtSwap(Handler->TickSlot);
+}
+
+
+/**
+ * @brief Removes the handler in the given slot by swapping the last slot into its place.
+ * The handler's state is copied back so it stays readable while withdrawn.
+ * @param Slot The slot to remove.
+ */
+void UWeaponHandlingSubsystem::RemoveAtSwap( const int32 Slot ) {
+	UWeaponHandlingComponent* Handler = ActiveHandlers[Slot];
+	Handler->TickState = ActiveStates[Slot];
+	Handler->TickSlot = INDEX_NONE;
+
+	ActiveStates.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	ActiveHandlers.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	ActiveEvents.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+
+	// The last handler now lives in the freed slot
+	if ( ActiveHandlers.IsValidIndex(Slot) ) { ActiveHandlers[Slot]->TickSlot = Slot; }
+}
+
+
+/**
+ * @brief Runs the fixed steps the frame time covers, blends the presented values and withdraws the settled handlers.
+ *
+ * The stepping and blending passes only touch the contiguous state array. Side effects that reach back into the
+ * components (expired timers, camera FOV) run in a last pass over the few handlers that need them.
+ * @param DeltaTime The time since the last frame.
+ */
+void UWeaponHandlingSubsystem::Tick( const float DeltaTime ) {
+	CHARACTERATTRIBUTE_SCOPE(WeaponHandlingSubsystemTick);
+
+	Super::Tick(DeltaTime);
+
+	constexpr double StepSeconds = FWeaponModel::StepSeconds;
+	StepAccumulator += DeltaTime;
+	const int32 NumSteps = FMath::Min(FMath::FloorToInt32(StepAccumulator / StepSeconds), MaxStepsPerFrame);
+	StepAccumulator = FMath::Min(StepAccumulator - NumSteps * StepSeconds, StepSeconds);
+
+	const int32 NumActive = ActiveStates.Num();
+	CSV_CUSTOM_STAT(CharacterAttribute, ActiveWeaponHandlers, NumActive, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(CharacterAttribute, WeaponHandlingSteps, NumSteps, ECsvCustomStatOp::Set);
+	FWeaponHandlingTickState* States = ActiveStates.GetData();
+	uint8* Events = ActiveEvents.GetData();
+
+	FMemory::Memzero(Events, NumActive);
+	for ( int32 Step = 0; Step < NumSteps; ++Step ) {
+		for ( int32 Slot = 0; Slot < NumActive; ++Slot ) { Events[Slot] |= States[Slot].Advance(); }
+	}
+
+	const float Alpha = static_cast<float>(StepAccumulator / StepSeconds);
+	for ( int32 Slot = 0; Slot < NumActive; ++Slot ) { States[Slot].Present(Alpha); }
+
+	// Iterate backwards so settled handlers can be swapped out in place
+	for ( int32 Slot = NumActive - 1; Slot >= 0; --Slot ) {
+		FWeaponHandlingTickState& State = ActiveStates[Slot];
+		const bool bSettled = !State.HasPendingWork();
+		// A settled handler leaves showing exactly its simulated values
+		if ( bSettled ) { State.SnapPresentation(); }
+
+		ActiveHandlers[Slot]->HandleTickEvents(State, ActiveEvents[Slot]);
+
+		if ( bSettled ) { RemoveAtSwap(Slot); }
+	}
+}
+
+
+/**
+ * @brief Only ticks while at least one handler is enrolled.
+ * @return True if there is pending work, false otherwise.
+ */
+bool UWeaponHandlingSubsystem::IsTickable() const { return ActiveStates.Num() > 0; }
+
+
+TStatId UWeaponHandlingSubsystem::GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(UWeaponHandlingSubsystem, STATGROUP_Tickables); }
+
+
+/**
+ * @brief Fills the world's particle pool with components of a weapon effect before the first shot needs them.
+ * The components are all taken from the pool before any is handed back, so the pool ends up holding Count of them
+ * and the first shots reuse them instead of constructing new ones.
+ * @param Template The effect.
+ * @param Count The number of components to pool.
+ */
+void UWeaponHandlingSubsystem::PrewarmEffect( UParticleSystem* Template, const int32 Count ) {
+	if ( Template == nullptr || PrewarmedEffects.Contains(Template) ) { return; }
+
+	LLM_SCOPE_BYTAG(CharacterAttribute_WeaponVFX);
+	PrewarmedEffects.Add(Template);
+
+	FWorldPSCPool& Pool = GetWorld()->GetPSCPool();
+	TArray<UParticleSystemComponent*, TInlineAllocator<32>> Components;
+	for ( int32 Index = 0; Index < Count; ++Index ) {
+		if ( UParticleSystemComponent* Component = Pool.CreateWorldParticleSystem(Template, GetWorld(), EPSCPoolMethod::AutoRelease) ) { Components.Add(Component); }
+	}
+	for ( UParticleSystemComponent* Component : Components ) { Pool.ReclaimWorldParticleSystem(Component); }
+}
+
+
+/**
+ * @brief Withdraws every handler before the world goes away.
+ */
+void UWeaponHandlingSubsystem::Deinitialize() {
+	while ( ActiveStates.Num() > 0 ) { RemoveAtSwap(ActiveStates.Num() - 1); }
+	StepAccumulator = 0.0;
+	PrewarmedEffects.Empty();
+
+	Super::Deinitialize();
+}
+
+
+/**
+ * @brief Weapon handlers only need batching in worlds that actually play.
+ * @param WorldType The type of the world the subsystem would be created for.
+ * @return True for game and PIE worlds, false otherwise.
+ */
+bool UWeaponHandlingSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const { return WorldType == EWorldType::Game || WorldType == EWorldType::PIE; }
@@ -0,0 +1,61 @@
+/**
+ * @file WeaponHandlingTickState.cpp
+ * @brief This file contains the implementation of the FWeaponHandlingTickState struct.
+ */
+
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingTickState.h"
+
+/** Field of view values closer than this to their target are considered settled. */
+static constexpr float FOVSettleTolerance = 1.e-3f;
+
+
+/**
+ * @brief Advances the weapon model and the camera FOV blend by one fixed step.
+ * @return A mask of FWeaponModel::Event_* flags raised by the step.
+ */
+uint8 FWeaponHandlingTickState::Advance() {
+	// Keep the values before the step for presentation to blend from
+	PreviousCrosshairSpreadMultiplier = Model.CrosshairSpreadMultiplier;
+	PreviousCameraFOV = CurrentCameraFOV;
+
+	const uint8 Events = Model.Step(bTracksSpread);
+
+	// Blend the camera field of view towards the zoomed or default value
+	if ( bDrivesCamera ) {
+		CurrentCameraFOV = FMath::FInterpTo(CurrentCameraFOV, TargetCameraFOV, FWeaponModel::StepSeconds, ZoomInterpSpeed);
+	}
+
+	return Events;
+}
+
+
+/**
+ * @brief Blends the presented values between the last two steps.
+ * @param Alpha How far the frame is between the last step and the next one, in [0, 1].
+ */
+void FWeaponHandlingTickState::Present( const float Alpha ) {
+	PresentedCrosshairSpreadMultiplier = FMath::Lerp(PreviousCrosshairSpreadMultiplier, Model.CrosshairSpreadMultiplier, Alpha);
+	PresentedCameraFOV = FMath::Lerp(PreviousCameraFOV, CurrentCameraFOV, Alpha);
+}
+
+
+/**
+ * @brief Makes the simulated values the presented ones, with nothing left to blend.
+ */
+void FWeaponHandlingTickState::SnapPresentation() {
+	PreviousCrosshairSpreadMultiplier = Model.CrosshairSpreadMultiplier;
+	PresentedCrosshairSpreadMultiplier = Model.CrosshairSpreadMultiplier;
+	PreviousCameraFOV = CurrentCameraFOV;
+	PresentedCameraFOV = CurrentCameraFOV;
+}
+
+
+/**
+ * @brief Checks whether the handler still has anything to advance.
+ * @return True while the model has not settled or the FOV is still blending, false otherwise.
+ */
+bool FWeaponHandlingTickState::HasPendingWork() const {
+	if ( !Model.IsSettled(bTracksSpread) ) { return true; }
+
+	return bDrivesCamera && FMath::Abs(CurrentCameraFOV - TargetCameraFOV) > FOVSettleTolerance;
+}
@@ -0,0 +1,336 @@
+/**
+ * @file WeaponModel.cpp
+ * @brief This file contains the implementation of the FWeaponModel struct.
+ */
+
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponModel.h"
+
+namespace WeaponModel
+{
+	/** Values closer than this to their target are considered settled. */
+	constexpr float SettleTolerance = 1.e-3f;
+
+	/** The crosshair spread every other multiplier is added to. */
+	constexpr float BaseSpread = 0.5f;
+
+	/** The accelerating multiplier at full speed. */
+	constexpr float MaxAcceleratingSpread = 1.f;
+
+	/** The targets of the in-air, aiming and firing multipliers while active. The blend never overshoots them. */
+	constexpr float InAirSpread = 3.f;
+	constexpr float AimingSpread = -0.5f;
+	constexpr float WeaponFireSpread = 0.3f;
+
+	/** The crosshair spread targets and interpolation speeds for a given set of inputs. */
+	struct FSpreadTargets
+	{
+		float InAir;
+		float InAirSpeed;
+		float Aiming;
+		float AimingSpeed;
+		float WeaponFire;
+		float WeaponFireSpeed;
+	};
+
+	/** Steps after which every crosshair spread multiplier has reached its target, from anywhere in its range. */
+	constexpr int32 SpreadSettleSteps = 120;
+
+	/**
+	 * @brief Resolves the crosshair spread targets for a set of inputs.
+	 * @param bIsInAir Whether the player is in the air.
+	 * @param bIsAiming Whether the player is aiming.
+	 * @param bIsFiring Whether the weapon is inside its firing spread window.
+	 * @return The targets each multiplier is interpolating towards.
+	 */
+	FORCEINLINE FSpreadTargets GetSpreadTargets(const bool bIsInAir, const bool bIsAiming, const bool bIsFiring)
+	{
+		FSpreadTargets Targets;
+		// Jumping or falling widens the crosshair quickly and recovers slowly
+		Targets.InAir = bIsInAir ? InAirSpread : 0.0f;
+		Targets.InAirSpeed = bIsInAir ? 20.0f : 5.0f;
+		// Aiming tightens the crosshair
+		Targets.Aiming = bIsAiming ? AimingSpread : 0.0f;
+		Targets.AimingSpeed = bIsAiming ? 12.0f : 15.0f;
+		// Firing kicks the crosshair out briefly
+		Targets.WeaponFire = bIsFiring ? WeaponFireSpread : 0.0f;
+		Targets.WeaponFireSpeed = bIsFiring ? 35.0f : 60.0f;
+		return Targets;
+	}
+
+	/**
+	 * @brief Resolves the crosshair spread targets for the current inputs.
+	 * @param Model The model to read the inputs from.
+	 * @return The targets each multiplier is interpolating towards.
+	 */
+	FORCEINLINE FSpreadTargets GetSpreadTargets(const FWeaponModel& Model) { return GetSpreadTargets(Model.bIsInAir, Model.bIsAiming, Model.IsFiringWeapon()); }
+
+	/**
+	 * @brief Advances the in-air and firing multipliers the server estimates for a remote handler by one step.
+	 * @param bIsInAir Whether the handler is in the air.
+	 * @param InOutInAir The in-air multiplier.
+	 * @param InOutWeaponFire The firing multiplier.
+	 * @param InOutFiringSpreadSteps The steps left in the firing spread window.
+	 */
+	FORCEINLINE void StepRemoteSpread(const bool bIsInAir, float& InOutInAir, float& InOutWeaponFire, int32& InOutFiringSpreadSteps)
+	{
+		const FSpreadTargets Targets = GetSpreadTargets(bIsInAir, false, InOutFiringSpreadSteps > 0);
+		InOutInAir = FMath::FInterpTo(InOutInAir, Targets.InAir, FWeaponModel::StepSeconds, Targets.InAirSpeed);
+		InOutWeaponFire = FMath::FInterpTo(InOutWeaponFire, Targets.WeaponFire, FWeaponModel::StepSeconds, Targets.WeaponFireSpeed);
+		if ( InOutFiringSpreadSteps > 0 ) { --InOutFiringSpreadSteps; }
+	}
+
+	/**
+	 * @brief Maps the player speed onto the [0, 1] accelerating multiplier.
+	 * @param Model The model to read the inputs from.
+	 * @return The accelerating crosshair multiplier.
+	 */
+	FORCEINLINE float GetAcceleratingMultiplier(const FWeaponModel& Model)
+	{
+		return FMath::GetMappedRangeValueClamped(FVector2D(0.f, Model.MaxSpeed), FVector2D(0.f, MaxAcceleratingSpread), Model.PlayerSpeed);
+	}
+
+	/**
+	 * @brief Gets the fraction of its distance to the target a multiplier keeps over some steps of FInterpTo.
+	 * @param Speed The interpolation speed.
+	 * @param NumSteps The number of steps.
+	 * @return The fraction, in [0, 1].
+	 */
+	FORCEINLINE float GetKeptFraction(const float Speed, const int32 NumSteps) { return FMath::Pow(1.f - FMath::Min(Speed * FWeaponModel::StepSeconds, 1.f), static_cast<float>(NumSteps)); }
+
+	/**
+	 * @brief Gets the lowest value a non-negative multiplier can have had some steps ago.
+	 * @param Value The value now.
+	 * @param Target The highest target the multiplier rises towards.
+	 * @param Speed The speed it rises towards that target at.
+	 * @param NumSteps The number of steps.
+	 * @return The value it had if it rose as fast as it can the whole time, or zero if it can have risen from there.
+	 */
+	FORCEINLINE float GetLowestEarlierValue(const float Value, const float Target, const float Speed, const int32 NumSteps)
+	{
+		const float Kept = GetKeptFraction(Speed, NumSteps);
+		return Kept > UE_SMALL_NUMBER ? FMath::Max(Target - (Target - Value) / Kept, 0.f) : 0.f;
+	}
+
+	/**
+	 * @brief Gets the lowest value a non-negative multiplier can fall to within some steps.
+	 * @param Value The value now.
+	 * @param Speed The speed it falls towards zero at.
+	 * @param NumSteps The number of steps.
+	 * @return The value it reaches if it falls the whole time.
+	 */
+	FORCEINLINE float GetLowestLaterValue(const float Value, const float Speed, const int32 NumSteps) { return Value * GetKeptFraction(Speed, NumSteps); }
+
+	FORCEINLINE bool IsSettled(const float Value, const float Target) { return FMath::Abs(Value - Target) <= SettleTolerance; }
+}
+
+
+/**
+ * @brief Fires a shot if the weapon is armed and ready.
+ * Starts the fire cooldown and the firing spread window.
+ * @param OutShotIndex Receives the index of the shot in the weapon's spread stream.
+ * @return True if a shot was fired, false otherwise.
+ */
+bool FWeaponModel::TryFire( uint16& OutShotIndex ) {
+	if ( !bReadyToFire || !IsArmed() ) { return false; }
+
+	bReadyToFire = false;
+	FireCooldownSteps = FireIntervalSteps;
+	FiringSpreadSteps = FiringSpreadWindowSteps;
+	OutShotIndex = NextShotIndex++;
+	return true;
+}
+
+
+/**
+ * @brief Judges a shot a remote handler claims to have fired.
+ *
+ * The shot is refused if the handler is unarmed, or if its index is not newer than the last accepted one, so an index
+ * whose spread happened to land well cannot be replayed. Indices compare in 16 bits so they may wrap around.
+ *
+ * The fire rate is held with a token bucket refilled at one shot per fire interval of server time. Shots travel in a
+ * reliable RPC, so jitter or a resent packet can land several of them in the same frame; the bucket lets up to
+ * RemoteShotBurst of them through back to back, while the sustained rate can never beat the fire rate.
+ * An accepted shot opens the firing spread window of the server's estimate of the handler's spread.
+ * @param ShotIndex The index of the shot in the weapon's spread stream.
+ * @param Now The current time in seconds.
+ * @return True if the shot is accepted, false otherwise.
+ */
+bool FWeaponModel::AcceptRemoteShot( const uint16 ShotIndex, const double Now ) {
+	if ( !IsArmed() ) { return false; }
+	if ( LastAcceptedShotIndex != INDEX_NONE && static_cast<int16>(ShotIndex - static_cast<uint16>(LastAcceptedShotIndex)) <= 0 ) { return false; }
+
+	// The first shot finds the bucket full
+	if ( LastRemoteShotTime < 0.0 ) {
+		RemoteShotTokens = RemoteShotBurst;
+	}
+	else {
+		const double FireInterval = FMath::Max(FireIntervalSteps, 1) * StepSeconds;
+		RemoteShotTokens = FMath::Min(RemoteShotTokens + FMath::Max(Now - LastRemoteShotTime, 0.0) / FireInterval, static_cast<double>(RemoteShotBurst));
+	}
+	LastRemoteShotTime = Now;
+
+	if ( RemoteShotTokens < 1.0 ) { return false; }
+
+	RemoteShotTokens -= 1.0;
+	LastAcceptedShotIndex = ShotIndex;
+
+	// The shot kicks the remote handler's crosshair out, as it did on the client
+	AdvanceRemoteSpread(Now);
+	RemoteFiringSpreadSteps = FiringSpreadWindowSteps;
+	return true;
+}
+
+
+/**
+ * @brief Tells the server whether the pawn of a remote handler is in the air.
+ * The estimate is advanced to the change first, so the old state is applied up to it.
+ * @param bInAir Whether the server moves the pawn through the air.
+ * @param Now The current time in seconds.
+ */
+void FWeaponModel::SetRemoteInAir( const bool bInAir, const double Now ) {
+	AdvanceRemoteSpread(Now);
+	bRemoteInAir = bInAir;
+}
+
+
+/**
+ * @brief Advances the server's estimate of a remote handler's crosshair spread in whole steps.
+ * The inputs only change through SetRemoteInAir and AcceptRemoteShot, which advance the estimate before changing them,
+ * so the estimate is stepped through exactly the inputs the server saw.
+ * @param Now The current time in seconds.
+ */
+void FWeaponModel::AdvanceRemoteSpread( const double Now ) {
+	using namespace WeaponModel;
+
+	if ( LastRemoteSpreadTime < 0.0 ) {
+		LastRemoteSpreadTime = Now;
+		return;
+	}
+
+	const int32 NumSteps = FMath::FloorToInt32((Now - LastRemoteSpreadTime) / StepSeconds);
+	if ( NumSteps <= 0 ) { return; }
+
+	if ( NumSteps >= SpreadSettleSteps ) {
+		// Every multiplier has reached its target by now
+		RemoteInAirMultiplier = bRemoteInAir ? InAirSpread : 0.f;
+		RemoteWeaponFireMultiplier = 0.f;
+		RemoteFiringSpreadSteps = 0;
+		LastRemoteSpreadTime = Now;
+		return;
+	}
+
+	for ( int32 Step = 0; Step < NumSteps; ++Step ) { StepRemoteSpread(bRemoteInAir, RemoteInAirMultiplier, RemoteWeaponFireMultiplier, RemoteFiringSpreadSteps); }
+	LastRemoteSpreadTime += NumSteps * StepSeconds;
+}
+
+
+/**
+ * @brief Gets the lowest crosshair spread multiplier a remote handler can honestly have fired a shot with.
+ *
+ * The handler's own spread follows the server's estimate shifted by up to LeadSeconds either way, since its movement
+ * and its shots reach the server with different delays. Within that time no multiplier can have risen faster than
+ * towards its highest target at its fastest speed, nor fallen faster than towards rest, which bounds it from below.
+ * The handler may also have stopped moving, which drops the speed contribution at once, and it may be aiming, which
+ * the server is never told.
+ * @param Now The current time in seconds.
+ * @param LeadSeconds How far the remote handler can be ahead of or behind the server's view of it.
+ * @return The floor of the multiplier the handler can claim.
+ */
+float FWeaponModel::GetRemoteSpreadFloor( const double Now, const double LeadSeconds ) {
+	using namespace WeaponModel;
+
+	AdvanceRemoteSpread(Now);
+
+	const int32 LeadSteps = FMath::Clamp(FMath::CeilToInt32(LeadSeconds / StepSeconds), 0, SpreadSettleSteps);
+	const FSpreadTargets Rising = GetSpreadTargets(true, false, true);
+	const FSpreadTargets Falling = GetSpreadTargets(false, false, false);
+	const float InAir = FMath::Min(GetLowestEarlierValue(RemoteInAirMultiplier, Rising.InAir, Rising.InAirSpeed, LeadSteps), GetLowestLaterValue(RemoteInAirMultiplier, Falling.InAirSpeed, LeadSteps));
+	const float WeaponFire = FMath::Min(GetLowestEarlierValue(RemoteWeaponFireMultiplier, Rising.WeaponFire, Rising.WeaponFireSpeed, LeadSteps), GetLowestLaterValue(RemoteWeaponFireMultiplier, Falling.WeaponFireSpeed, LeadSteps));
+
+	return BaseSpread + AimingSpread + InAir + WeaponFire;
+}
+
+
+/**
+ * @brief Clamps a crosshair spread multiplier to the range the spread blend can produce.
+ * FInterpTo never overshoots, so every multiplier stays between zero and its target and the total stays in this range.
+ * @param SpreadMultiplier The claimed multiplier.
+ * @return The clamped multiplier.
+ */
+float FWeaponModel::ClampSpreadMultiplier( const float SpreadMultiplier ) {
+	using namespace WeaponModel;
+
+	constexpr float MinSpread = BaseSpread + AimingSpread;
+	constexpr float MaxSpread = BaseSpread + MaxAcceleratingSpread + InAirSpread + WeaponFireSpread;
+	return FMath::Clamp(SpreadMultiplier, MinSpread, MaxSpread);
+}
+
+
+/**
+ * @brief Advances the cooldowns and, if asked to, the crosshair spread by one fixed step.
+ * Counting the cooldowns in whole steps keeps the fire cadence exact at any frame rate.
+ * @param bIntegrateSpread Whether the crosshair spread should be integrated.
+ * @return A mask of Event_* flags raised by the step.
+ */
+uint8 FWeaponModel::Step( const bool bIntegrateSpread ) {
+	using namespace WeaponModel;
+
+	constexpr float DeltaTime = StepSeconds;
+	uint8 Events = 0;
+
+	// Count down the fire cooldown, which re-arms the weapon, and the firing spread window
+	if ( FireCooldownSteps > 0 && --FireCooldownSteps == 0 ) {
+		bReadyToFire = true;
+		Events |= Event_FireCooldownElapsed;
+	}
+	if ( FiringSpreadSteps > 0 && --FiringSpreadSteps == 0 ) { Events |= Event_FiringSpreadElapsed; }
+
+	// Blend the crosshair spread towards its targets
+	if ( bIntegrateSpread ) {
+		const FSpreadTargets Targets = GetSpreadTargets(*this);
+		AcceleratingCrosshairMultiplier = GetAcceleratingMultiplier(*this);
+		InAirCrosshairMultiplier = FMath::FInterpTo(InAirCrosshairMultiplier, Targets.InAir, DeltaTime, Targets.InAirSpeed);
+		AimingCrosshairMultiplier = FMath::FInterpTo(AimingCrosshairMultiplier, Targets.Aiming, DeltaTime, Targets.AimingSpeed);
+		WeaponFireCrosshairMultiplier = FMath::FInterpTo(WeaponFireCrosshairMultiplier, Targets.WeaponFire, DeltaTime, Targets.WeaponFireSpeed);
+
+		CrosshairSpreadMultiplier = BaseSpread + AcceleratingCrosshairMultiplier + InAirCrosshairMultiplier + AimingCrosshairMultiplier + WeaponFireCrosshairMultiplier;
+	}
+
+	return Events;
+}
+
+
+/**
+ * @brief Checks whether stepping would change anything.
+ * @param bIntegrateSpread Whether the crosshair spread is integrated.
+ * @return True once the cooldowns have run out and the spread has reached its targets, false otherwise.
+ */
+bool FWeaponModel::IsSettled( const bool bIntegrateSpread ) const {
+	using namespace WeaponModel;
+
+	if ( FireCooldownSteps > 0 || FiringSpreadSteps > 0 ) { return false; }
+
+	if ( bIntegrateSpread ) {
+		const FSpreadTargets Targets = GetSpreadTargets(*this);
+		if ( !WeaponModel::IsSettled(AcceleratingCrosshairMultiplier, GetAcceleratingMultiplier(*this)) ||
+			 !WeaponModel::IsSettled(InAirCrosshairMultiplier, Targets.InAir) ||
+			 !WeaponModel::IsSettled(AimingCrosshairMultiplier, Targets.Aiming) ||
+			 !WeaponModel::IsSettled(WeaponFireCrosshairMultiplier, Targets.WeaponFire) ) { return false; }
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Clears the inputs, the spread, the cooldowns and the accepted shots of a previous life.
+ * The archetype and its kernel, the fire rate and the shot index are kept.
+ */
+void FWeaponModel::Reset() {
+	FWeaponModel Fresh;
+	Fresh.FireIntervalSteps = FireIntervalSteps;
+	Fresh.FiringSpreadWindowSteps = FiringSpreadWindowSteps;
+	Fresh.NextShotIndex = NextShotIndex;
+	Fresh.SetArchetype(Archetype);
+	*this = Fresh;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file WeaponModelHarness.cpp
+ * @brief This file contains the offline simulation harness for FWeaponModel.
+ */
+
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponModel.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponSpread.h"
+#include "CharacterAttributeModule/Private/Logging.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+#if !UE_BUILD_SHIPPING
+namespace WeaponModelHarness
+{
+	/** The handlers simulated by one task. Large enough that scheduling is noise next to the stepping. */
+	constexpr int32 HandlersPerTask = 1024;
+
+	/** The totals of one simulated batch of handlers. */
+	struct FBatchTotals
+	{
+		int64 Shots = 0;
+		int64 Pellets = 0;
+		double HalfAngleDegrees = 0.0;
+	};
+
+	/**
+	 * @brief Simulates one handler for a number of steps with scripted inputs.
+	 *
+	 * The inputs are drawn from the counter-based spread stream, so every run of the harness replays the same
+	 * engagements whatever the number of cores. The handler holds the trigger and releases it now and then, and every
+	 * shot it fires generates its pellets through the kernel of its weapon.
+	 * @param Handler The index of the handler, which seeds its inputs.
+	 * @param NumSteps The number of steps to simulate.
+	 * @param Totals Receives the shots the handler fired.
+	 */
+	void SimulateHandler(const int32 Handler, const int32 NumSteps, FBatchTotals& Totals)
+	{
+		const uint32 Key = WeaponSpread::MakeShotKey(0x5eed1e55U, static_cast<uint32>(Handler));
+
+		FWeaponModel Model;
+		Model.SetArchetype(static_cast<EWeaponArchetype>(1 + WeaponSpread::Random(Key, 0) % 3));
+		Model.FireIntervalSteps = 2 + static_cast<int32>(WeaponSpread::Random(Key, 1) % 8);
+		Model.MaxSpeed = 600.f;
+
+		for ( int32 Step = 0; Step < NumSteps; ++Step ) {
+			// New inputs every quarter of a second, like a player changing what they do
+			if ( Step % 15 == 0 ) {
+				const uint32 Bits = WeaponSpread::Random(Key, 2 + Step);
+				Model.PlayerSpeed = WeaponSpread::ToUnitFloat(Bits) * Model.MaxSpeed;
+				Model.bIsInAir = (Bits & 0x7) == 0;
+				Model.bIsAiming = (Bits & 0x18) != 0;
+				// Releasing the trigger re-arms the weapon at once
+				if ( (Bits & 0x60) == 0 ) { Model.bReadyToFire = true; }
+			}
+
+			uint16 ShotIndex;
+			if ( Model.TryFire(ShotIndex) ) {
+				// Aim along a fixed axis. The kernel does the same work whatever the direction.
+				FVector Directions[WeaponSpread::MaxPellets];
+				++Totals.Shots;
+				Totals.Pellets += Model.GetKernel().GenerateShot(FVector::ForwardVector, Key, ShotIndex, Model.CrosshairSpreadMultiplier, Directions);
+				Totals.HalfAngleDegrees += Model.GetShotHalfAngleDegrees(Model.CrosshairSpreadMultiplier);
+			}
+
+			Model.Step(true);
+		}
+	}
+
+	/**
+	 * @brief Simulates many handlers across every core and logs the throughput and the engagement totals.
+	 * @param Args The number of handlers and the simulated seconds per handler, both optional.
+	 */
+	void Run(const TArray<FString>& Args)
+	{
+		const int32 NumHandlers = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+		const float Seconds = Args.Num() > 1 ? FMath::Max(FCString::Atof(*Args[1]), FWeaponModel::StepSeconds) : 60.f;
+		const int32 NumSteps = FWeaponModel::SecondsToSteps(Seconds);
+		const int32 NumTasks = FMath::DivideAndRoundUp(NumHandlers, HandlersPerTask);
+
+		TArray<FBatchTotals> TaskTotals;
+		TaskTotals.SetNum(NumTasks);
+
+		const double Start = FPlatformTime::Seconds();
+		ParallelFor(NumTasks, [&TaskTotals, NumHandlers, NumSteps](const int32 Task)
+		{
+			const int32 End = FMath::Min((Task + 1) * HandlersPerTask, NumHandlers);
+			for ( int32 Handler = Task * HandlersPerTask; Handler < End; ++Handler ) { SimulateHandler(Handler, NumSteps, TaskTotals[Task]); }
+		});
+		const double Elapsed = FMath::Max(FPlatformTime::Seconds() - Start, UE_DOUBLE_SMALL_NUMBER);
+
+		FBatchTotals Totals;
+		for ( const FBatchTotals& Task : TaskTotals ) {
+			Totals.Shots += Task.Shots;
+			Totals.Pellets += Task.Pellets;
+			Totals.HalfAngleDegrees += Task.HalfAngleDegrees;
+		}
+
+		const double HandlerSteps = static_cast<double>(NumHandlers) * NumSteps;
+		UE_LOG(LogCharacterAttributeModule, Display, TEXT("Weapon model, %d handlers for %.1f s (%d steps) in %.3f s:"), NumHandlers, Seconds, NumSteps, Elapsed);
+		UE_LOG(LogCharacterAttributeModule, Display, TEXT("  %.1f M handler steps/s, %lld shots, %lld pellets, mean cone %.2f deg"),
+			HandlerSteps / Elapsed * 1.e-6, Totals.Shots, Totals.Pellets, Totals.Shots > 0 ? Totals.HalfAngleDegrees / Totals.Shots : 0.0);
+	}
+}
+
+static FAutoConsoleCommandWithArgs SimulateWeaponModelsCommand(
+	TEXT("LastShooter.Weapon.SimulateModels"),
+	TEXT("Steps many weapon models with scripted inputs across every core and logs the throughput. Usage: LastShooter.Weapon.SimulateModels [Handlers=100000] [Seconds=60]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&WeaponModelHarness::Run));
+#endif
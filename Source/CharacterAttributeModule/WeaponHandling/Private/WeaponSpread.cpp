@@ -0,0 +1,19 @@
+/**
+ * @file WeaponSpread.cpp
+ * @brief This file contains the implementation of the deterministic shot spread.
+ */
+
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponSpread.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponArchetypeTraits.h"
+
+
+/**
+ * @brief Makes the seed of a weapon held by a player.
+ * @param PlayerId The replicated id of the player.
+ * @param Archetype The archetype of the weapon.
+ * @return The seed of the weapon's random stream.
+ */
+uint32 WeaponSpread::MakeWeaponSeed( const int32 PlayerId, const EWeaponArchetype Archetype ) {
+	return Mix(static_cast<uint32>(PlayerId) * 0x85ebca6bU ^ Mix(static_cast<uint32>(Archetype) + 1));
+}
+
@@ -0,0 +1,108 @@
+/**
+ * @file WeaponArchetypeTraits.h
+ * @brief This file contains the compile-time traits of every weapon archetype and the fire kernels generated from them.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @enum EWeaponArchetype
+ * @brief The kinds of weapon the model can be armed with.
+ */
+enum class EWeaponArchetype : uint8
+{
+	Unarmed,
+	Pistol,
+	Rifle,
+	Shotgun,
+
+	Count
+};
+
+/**
+ * @struct TWeaponArchetypeTraits
+ * @brief The constants of a weapon archetype. Specialised once per archetype so the fire kernels can fold them.
+ */
+template<EWeaponArchetype Archetype>
+struct TWeaponArchetypeTraits;
+
+template<>
+struct TWeaponArchetypeTraits<EWeaponArchetype::Unarmed>
+{
+	/** The number of pellets each shot fires. */
+	static constexpr int32 NumPellets = 1;
+
+	/** The cone half angle every shot has, whatever the crosshair spread. Keeps pellets apart while aiming. */
+	static constexpr float MinHalfAngleDegrees = 0.f;
+
+	/** The cone half angle added per unit of crosshair spread multiplier. */
+	static constexpr float HalfAngleDegreesPerSpread = 2.f;
+
+	/** How far a weapon trace reaches. */
+	static constexpr float TraceLength = 50000.f;
+};
+
+template<>
+struct TWeaponArchetypeTraits<EWeaponArchetype::Pistol> : TWeaponArchetypeTraits<EWeaponArchetype::Unarmed>
+{
+	static constexpr float HalfAngleDegreesPerSpread = 1.5f;
+};
+
+template<>
+struct TWeaponArchetypeTraits<EWeaponArchetype::Rifle> : TWeaponArchetypeTraits<EWeaponArchetype::Unarmed>
+{
+};
+
+template<>
+struct TWeaponArchetypeTraits<EWeaponArchetype::Shotgun> : TWeaponArchetypeTraits<EWeaponArchetype::Unarmed>
+{
+	static constexpr int32 NumPellets = 8;
+	static constexpr float MinHalfAngleDegrees = 2.f;
+	static constexpr float HalfAngleDegreesPerSpread = 3.f;
+};
+
+/**
+ * @struct FWeaponFireKernel
+ * @brief The fire path of one weapon archetype, generated from its traits.
+ *
+ * One kernel exists per archetype and the weapon model picks it when it is armed, so a shot calls straight into code
+ * specialised for the weapon instead of looking the weapon up and branching on it.
+ */
+struct FWeaponFireKernel
+{
+	/** The number of pellets each shot fires. */
+	int32 NumPellets;
+
+	/** How far a weapon trace reaches. */
+	float TraceLength;
+
+	/**
+	 * @brief Gets the cone half angle of a shot fired with a crosshair spread multiplier.
+	 * @param SpreadMultiplier The crosshair spread multiplier when the shot was fired.
+	 * @return The half angle in degrees.
+	 */
+	float (*GetShotHalfAngleDegrees)(float SpreadMultiplier);
+
+	/**
+	 * @brief Generates the pellet directions of a shot from the weapon's deterministic spread stream.
+	 * @param AimDirection The unit direction the shot is aimed at.
+	 * @param Seed The seed of the weapon.
+	 * @param ShotIndex The index of the shot in the weapon's spread stream.
+	 * @param SpreadMultiplier The crosshair spread multiplier when the shot was fired.
+	 * @param OutDirections Receives NumPellets unit directions.
+	 * @return The number of pellets the shot fires.
+	 */
+	int32 (*GenerateShot)(const FVector& AimDirection, uint32 Seed, uint32 ShotIndex, float SpreadMultiplier, FVector* OutDirections);
+};
+
+namespace WeaponFireKernel
+{
+	/**
+	 * @brief Gets the fire kernel of a weapon archetype. Meant to be called when a weapon is equipped, not per shot.
+	 * @param Archetype The archetype of the weapon.
+	 * @return The kernel of the archetype.
+	 */
+	CHARACTERATTRIBUTEMODULE_API const FWeaponFireKernel& Get(EWeaponArchetype Archetype);
+}
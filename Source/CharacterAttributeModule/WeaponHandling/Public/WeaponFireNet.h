@@ -0,0 +1,136 @@
+/**
+ * @file WeaponFireNet.h
+ * @brief This file contains the declaration of the FWeaponFireRequest and FWeaponFireCosmetic structs.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponArchetypeTraits.h"
+#include "WeaponFireNet.generated.h"
+
+/**
+ * @struct FWeaponFireRequest
+ * @brief A shot as sent by the firing client to the server.
+ *
+ * Carries the aim ray the client saw rather than the result of its trace; the server traces it again.
+ * The origin is rounded to whole centimetres and the direction to 16 bits per component.
+ * Pellet directions are not sent: both sides derive them from the shot index and the spread multiplier.
+ * The archetype of the weapon is sent so the server ignores shots fired with a weapon it no longer agrees the client holds.
+ */
+USTRUCT()
+struct CHARACTERATTRIBUTEMODULE_API FWeaponFireRequest
+{
+	GENERATED_BODY()
+
+	/** The server world time of what the client saw when it fired: its estimate of the server time, less the time it draws other characters behind. */
+	UPROPERTY()
+	float Timestamp = 0.f;
+
+	/** The origin of the aim ray: the camera for players, the eyes for AI. */
+	UPROPERTY()
+	FVector_NetQuantize ViewOrigin = FVector::ZeroVector;
+
+	/** The unit direction of the aim ray. */
+	UPROPERTY()
+	FVector_NetQuantizeNormal ViewDirection = FVector::ForwardVector;
+
+	/** The index of the shot in the weapon's spread stream. */
+	UPROPERTY()
+	uint16 ShotIndex = 0;
+
+	/** The crosshair spread multiplier when the shot was fired, in steps of 1/32. */
+	UPROPERTY()
+	uint8 QuantizedSpread = 0;
+
+	/** The EWeaponArchetype of the weapon the client fired, sent in two bits. */
+	UPROPERTY()
+	uint8 Archetype = 0;
+
+	/**
+	 * @brief Stores the archetype of the weapon the shot was fired with.
+	 * @param InArchetype The archetype.
+	 */
+	FORCEINLINE void SetArchetype(const EWeaponArchetype InArchetype) { Archetype = static_cast<uint8>(InArchetype); }
+
+	/**
+	 * @brief Gets the archetype of the weapon the shot was fired with.
+	 * @return The archetype as the server will see it.
+	 */
+	FORCEINLINE EWeaponArchetype GetArchetype() const { return static_cast<EWeaponArchetype>(Archetype); }
+
+	/**
+	 * @brief Stores the crosshair spread multiplier of the shot.
+	 * @param SpreadMultiplier The multiplier, clamped to what the quantisation can hold.
+	 */
+	FORCEINLINE void SetSpreadMultiplier(const float SpreadMultiplier) { QuantizedSpread = static_cast<uint8>(FMath::Clamp(FMath::RoundToInt32(SpreadMultiplier * 32.f), 0, 255)); }
+
+	/**
+	 * @brief Gets the crosshair spread multiplier of the shot.
+	 * @return The multiplier as the server will see it.
+	 */
+	FORCEINLINE float GetSpreadMultiplier() const { return static_cast<float>(QuantizedSpread) / 32.f; }
+
+	/**
+	 * @brief Rounds the aim ray the way the network will.
+	 * The client traces the rounded ray itself, so its pellets match the server's exactly.
+	 */
+	void Quantize();
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	/**
+	 * @brief Measures the request as it is written to a bunch.
+	 * @return The serialised size in bits.
+	 */
+	int64 GetSerializedBits() const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FWeaponFireRequest> : public TStructOpsTypeTraitsBase2<FWeaponFireRequest>
+{
+	enum { WithNetSerializer = true };
+};
+
+/**
+ * @struct FWeaponFireCosmetic
+ * @brief The visible result of a shot, fanned out by the server to the other clients.
+ *
+ * Enough to play the muzzle flash, beam and impact without tracing. The impact normal is only sent for hits.
+ */
+USTRUCT()
+struct CHARACTERATTRIBUTEMODULE_API FWeaponFireCosmetic
+{
+	GENERATED_BODY()
+
+	/** Where the shot ended: the impact point for hits, the end of the trace otherwise. */
+	UPROPERTY()
+	FVector_NetQuantize TraceEnd = FVector::ZeroVector;
+
+	/** The surface normal at the impact point. */
+	UPROPERTY()
+	FVector_NetQuantizeNormal ImpactNormal = FVector::UpVector;
+
+	/** Whether the shot hit something. */
+	UPROPERTY()
+	bool bHit = false;
+
+	/** Whether this is a further pellet of the previous entry's shot. Such entries play no sound or muzzle flash. */
+	UPROPERTY()
+	bool bFollowUpPellet = false;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	/**
+	 * @brief Measures the cosmetic as it is written to a bunch.
+	 * @return The serialised size in bits.
+	 */
+	int64 GetSerializedBits() const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FWeaponFireCosmetic> : public TStructOpsTypeTraitsBase2<FWeaponFireCosmetic>
+{
+	enum { WithNetSerializer = true };
+};
@@ -8,11 +8,22 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
 #include "Components/ActorComponent.h"
+#include "Engine/EngineTypes.h"
+#include "Engine/StreamableManager.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponFireNet.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingTickState.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponSpread.h"
 #include "WeaponHandlingComponent.generated.h"
 
+class ACharacter;
 class AWeapon;
+class UCameraComponent;
 class USoundCue;
+class UWeaponHandlingSubsystem;
+class ULagCompensationSubsystem;
+class UHitboxSubsystem;
 
 UENUM(BlueprintType)
 enum class EPlayerArmedState : uint8
@@ -24,11 +35,19 @@ enum class EPlayerArmedState : uint8
 	EPAS_MAX UMETA(DisplayName = "DefaultMax")
 };
 
+/** Broadcast on clients for every shot of another player that the server fanned out, to play the fire animation. */
+DECLARE_MULTICAST_DELEGATE(FOnRemoteWeaponFired);
+
 /**
  * @class UWeaponHandlingComponent
  * @brief This class is a component for handling weapon-related actions.
  *
  * It inherits from the UActorComponent class and provides methods for firing a weapon and tracing under the crosshair.
+ *
+ * Firing is server authoritative. The firing client plays its shot straight away and sends the aim ray to the server
+ * in a compact FWeaponFireRequest. The server traces it again and queues the visible result. Queued shots go out
+ * together once per net update in an unreliable multicast, and the other clients play them from the muzzle
+ * without tracing.
  */
 UCLASS(ClassGroup = (CharacterAttribute), meta = (BlueprintSpawnableComponent))
 class CHARACTERATTRIBUTEMODULE_API UWeaponHandlingComponent : public UActorComponent
@@ -48,59 +67,192 @@ protected:
 	 * @param BarrelSocketTransform The transform of the barrel socket.
 	 * @param WeaponFireTraceStart The start location of the weapon fire trace.
 	 * @param WeaponFireTraceEnd The end location of the weapon fire trace.
-	 * @param ActorsToIgnore
+	 * @param ShotIndex The index the weapon model gave the shot in the spread stream.
 	 */
-	void ExecuteFireWeapon( const FTransform& BarrelSocketTransform, const FVector& WeaponFireTraceStart, FVector& WeaponFireTraceEnd, TArray<AActor*>& ActorsToIgnore );
+	void ExecuteFireWeapon( const FTransform& BarrelSocketTransform, const FVector& WeaponFireTraceStart, FVector& WeaponFireTraceEnd, uint16 ShotIndex );
 
 	/**
 	 * @brief Traces under the crosshair.
-	 * Performs a line trace from the center of the screen and checks if it hits anything.
+	 * Performs a line trace along the owning controller's view point and checks if it hits anything.
+	 * Ignores the owner and the equipped weapon through the cached WeaponTraceParams.
 	 * @param TraceHitResult The result of the trace.
 	 * @param TraceEndLocation The end location of the trace.
-	 * @param ActorsToIgnore Actors to be ignored by the line trace
 	 * @return True if the trace hit something, false otherwise.
 	 */
-	bool TraceUnderCrosshair( FHitResult& TraceHitResult, FVector& TraceEndLocation, TArray<AActor*>& ActorsToIgnore ) const;
+	bool TraceUnderCrosshair( FHitResult& TraceHitResult, FVector& TraceEndLocation ) const;
 
 	/**
 	 * @brief Performs a weapon trace.
 	 * Performs a line trace from the weapon to the location under the crosshair and checks if it hits anything.
 	 * @param TraceStart The start location of the trace.
 	 * @param TraceEnd The end location of the trace.
-	 * @param TraceHitResult
-	 * @param ActorsToIgnore
+	 * @param TraceHitResult The result of the crosshair trace.
+	 * @return True if the trace hit something, false otherwise.
+	 */
+	bool WeaponTrace( const FVector& TraceStart, FVector& TraceEnd, FHitResult& TraceHitResult ) const;
+
+	/**
+	 * @brief Rebuilds the cached trace query params.
+	 * Ignores the owner and the given weapon. Only called when the equipped weapon changes, never per shot.
+	 * @param EquippedWeapon The weapon currently held, or nullptr when unarmed.
+	 */
+	void RefreshWeaponTraceParams(const AWeapon* EquippedWeapon);
+
+	/**
+	 * @brief Gets the aim ray of the owning controller.
+	 * @param OutOrigin Receives the origin of the ray: the camera for players, the eyes for AI.
+	 * @param OutDirection Receives the unit direction of the ray.
+	 * @return True if the owner is controlled, false otherwise.
+	 */
+	bool GetAimViewPoint(FVector& OutOrigin, FVector& OutDirection) const;
+
+	/**
+	 * @brief Traces one weapon ray against the world and the characters.
+	 * Registered characters are resolved by the hitbox layer while it is enabled; the scene query covers the rest.
+	 * @param TraceStart The start of the ray.
+	 * @param TraceEnd The end of the ray.
+	 * @param OutHit Receives the nearest hit.
+	 * @return True if the ray hit something, false otherwise.
+	 */
+	bool TraceWeaponRay(const FVector& TraceStart, const FVector& TraceEnd, FHitResult& OutHit) const;
+
+	/**
+	 * @brief Traces along an aim ray.
+	 * @param ViewOrigin The origin of the aim ray.
+	 * @param ViewDirection The unit direction of the aim ray.
+	 * @param TraceHitResult The result of the trace.
+	 * @param TraceEndLocation The end location of the trace.
 	 * @return True if the trace hit something, false otherwise.
 	 */
-	bool WeaponTrace( const FVector& TraceStart, FVector& TraceEnd, FHitResult& TraceHitResult, TArray<AActor*>& ActorsToIgnore ) const;
+	bool TraceAlongView(const FVector& ViewOrigin, const FVector& ViewDirection, FHitResult& TraceHitResult, FVector& TraceEndLocation) const;
+
+	/**
+	 * @brief Performs a weapon trace from the barrel towards whatever an aim ray hits.
+	 * @param ViewOrigin The origin of the aim ray.
+	 * @param ViewDirection The unit direction of the aim ray.
+	 * @param TraceStart The start location of the barrel trace.
+	 * @param TraceEnd The end location of the trace.
+	 * @param TraceHitResult The result of the barrel trace.
+	 * @return True if the trace hit something, false otherwise.
+	 */
+	bool WeaponTraceAlongView(const FVector& ViewOrigin, const FVector& ViewDirection, const FVector& TraceStart, FVector& TraceEnd, FHitResult& TraceHitResult) const;
+
+	/**
+	 * @brief Generates the pellet directions of a shot from the equipped weapon's deterministic spread stream.
+	 * @param ViewDirection The unit direction the shot is aimed at.
+	 * @param ShotIndex The index of the shot in the weapon's spread stream.
+	 * @param SpreadMultiplier The crosshair spread multiplier when the shot was fired.
+	 * @param OutDirections Receives up to WeaponSpread::MaxPellets unit directions.
+	 * @return The number of pellets the shot fires.
+	 */
+	int32 GenerateShotDirections(const FVector& ViewDirection, uint16 ShotIndex, float SpreadMultiplier, FVector* OutDirections) const;
+
+	/**
+	 * @brief Traces every pellet of a shot and collects what they look like.
+	 * @param ViewOrigin The origin of the aim ray.
+	 * @param Directions The direction of every pellet.
+	 * @param MuzzleLocation The start location of the barrel traces.
+	 * @param OutPellets Receives the visible result of every pellet, the first one marked as the start of the shot.
+	 * @param OutFirstHit Receives the crosshair trace result of the first pellet.
+	 */
+	void TracePellets(const FVector& ViewOrigin, TConstArrayView<FVector> Directions, const FVector& MuzzleLocation, TArray<FWeaponFireCosmetic, TInlineAllocator<WeaponSpread::MaxPellets>>& OutPellets, FHitResult& OutFirstHit) const;
+
+	/**
+	 * @brief Gets the seed of the equipped weapon's spread stream.
+	 * @return A seed both the owning client and the server derive from replicated state.
+	 */
+	uint32 GetSpreadSeed() const;
+
+	/**
+	 * @brief Plays the sound, muzzle flash, beam and impact of a shot. Never traces.
+	 * @param BarrelSocketTransform The transform of the barrel socket.
+	 * @param Shot The visible result of the shot, or of one further pellet of it.
+	 */
+	void PlayFireCosmetics(const FTransform& BarrelSocketTransform, const FWeaponFireCosmetic& Shot) const;
+
+	/**
+	 * @brief Gets the muzzle of the equipped weapon, or the owner's transform when unarmed.
+	 * @return The world transform shots are played from.
+	 */
+	FTransform GetMuzzleTransform() const;
+
+	/**
+	 * @brief Sends a shot to the server.
+	 * @param Request The aim ray and time of the shot.
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerFire(const FWeaponFireRequest& Request);
+
+	/**
+	 * @brief Plays the shots of another player on this client.
+	 * @param Shots The shots fired since the last net update, oldest first.
+	 */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastFireCosmetics(const TArray<FWeaponFireCosmetic>& Shots);
+
+	/**
+	 * @brief Queues the visible result of a shot for the next net update.
+	 * @param Shot The shot to fan out.
+	 */
+	void QueueFireCosmetic(const FWeaponFireCosmetic& Shot);
+
+	/**
+	 * @brief Sends the queued shots in one multicast.
+	 */
+	void FlushFireCosmetics();
 
 public:
 	/**
-	 * @brief Changes the camera field of view based on aiming state.
-	 * Interpolates the camera's field of view towards the zoomed or default value based on aiming.
-	 * @param DeltaTime The time since the last frame.
+	 * @brief Sends the shots queued since the last net update.
+	 * @param ChangedPropertyTracker The tracker of the owning actor's replicated properties.
 	 */
-	void ChangeCameraFOV(float DeltaTime);
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	/** Broadcast on clients for every shot of another player, to play the fire animation. */
+	FOnRemoteWeaponFired OnRemoteWeaponFired;
+
+	/**
+	 * @brief Registers the cosmetic per-frame work for the pawn the local player views through.
+	 * Caches the camera driven by ChangeCameraFOV. Only the locally controlled, player controlled pawn should register.
+	 * @param InViewCamera The camera whose field of view follows the aiming state.
+	 */
+	void RegisterCosmeticTick(UCameraComponent* InViewCamera);
+
+	/**
+	 * @brief Unregisters the cosmetic per-frame work.
+	 * Called when the owning pawn stops being locally viewed (unpossessed, AI controlled or a simulated proxy).
+	 */
+	void UnregisterCosmeticTick();
+
+	/**
+	 * @brief Feeds the cosmetic per-frame inputs: crosshair spread and camera field of view.
+	 * Does nothing unless RegisterCosmeticTick has been called. The blending itself is batched in UWeaponHandlingSubsystem.
+	 * @param PlayerSpeed The current speed of the player.
+	 * @param MaxSpeed The maximum speed of the player.
+	 * @param bIsInAir Whether the player is in the air.
+	 */
+	void TickCosmetic(const float PlayerSpeed, const float MaxSpeed, const bool bIsInAir);
 
 	/**
 	 * @brief Sets the aiming state of the character.
+	 * Also retargets the camera field of view blend.
 	 * @param bNewAiming The new aiming state.
 	 */
 	void SetIsAiming(bool bNewAiming);
 
 	/**
-	 * @brief Adjusts the crosshair spread based on various factors.
-	 * Calculates the crosshair spread based on player speed, whether in the air, and whether aiming or firing.
-	 * @param DeltaTime The time since the last frame.
+	 * @brief Updates the inputs the crosshair spread is calculated from.
+	 * The spread is blended by UWeaponHandlingSubsystem based on player speed, whether in the air, and whether aiming or firing.
+	 * The component only enrols for the batched update while the spread has not settled.
 	 * @param PlayerSpeed The current speed of the player.
 	 * @param MaxSpeed The maximum speed of the player.
 	 * @param bIsInAir Whether the player is in the air. 
-	 * @param CrosshairMultiplier The multiplier for the crosshair spread.
 	 */
-	void DynamicCrosshair(float DeltaTime, const float PlayerSpeed, const float MaxSpeed, const bool bIsInAir, float& CrosshairMultiplier);
+	void DynamicCrosshair(const float PlayerSpeed, const float MaxSpeed, const bool bIsInAir);
 
 	/**
 	 * @brief Starts the firing of the weapon.
-	 * Sets the firing state to true and starts a timer to stop the firing after a certain duration.
+	 * Sets the firing state to true for a short window that widens the crosshair spread.
 	 */
 	void SetWeaponFireState();
 
@@ -111,8 +263,8 @@ public:
 	void ResetWeaponFireState();
 
 	/**
-	 * @brief Resets the auto-fire timer.
-	 * Resets the timer used for auto-firing the weapon.
+	 * @brief Resets the auto-fire cooldown.
+	 * Called when the fire cooldown advanced by UWeaponHandlingSubsystem runs out.
 	 */
 	void AutoFireTimerReset();
 
@@ -124,25 +276,32 @@ public:
 	bool SetShouldFireWeapon(bool bShouldFire);
 
 	/**
-	 * @brief Sets a timer for the weapon fire.
-	 * Sets a timer for the weapon fire with the provided parameters.
+	 * @brief Fires the weapon and starts the fire cooldown.
+	 * Fires with the provided parameters and enrols the cooldown with UWeaponHandlingSubsystem.
 	 * @param BarrelSocketTransform The transform of the barrel socket.
 	 * @param WeaponFireTraceStart The start location of the weapon fire trace.
 	 * @param WeaponFireTraceEnd The end location of the weapon fire trace.
-	 * @param ActorsToIgnore Used to ignore the actors that shouldn't be hit by the weapon trace. Usually the player character and the weapon itself.
 	 */
-	void FireWeapon( const FTransform& BarrelSocketTransform, const FVector& WeaponFireTraceStart, FVector& WeaponFireTraceEnd, TArray<AActor*>& ActorsToIgnore );
+	void FireWeapon( const FTransform& BarrelSocketTransform, const FVector& WeaponFireTraceStart, FVector& WeaponFireTraceEnd );
+
+	/**
+	 * @brief Starts loading the default weapon class and its assets in the background.
+	 * The delegate fires once the loadout can be spawned without blocking, or right away if there is nothing to load.
+	 * @param OnLoaded Called when the default weapon class is ready.
+	 */
+	void RequestDefaultWeaponLoad(FStreamableDelegate OnLoaded);
 
 	/**
 	 * @brief Spawns the default weapon for the character.
-	 * Spawns the default weapon specified by DefaultWeaponClass and attaches it to the right-hand weapon socket.
-	 * @return The spawned weapon actor.
+	 * Takes the default weapon specified by DefaultWeaponClass from the item pool, spawning one if the pool is empty.
+	 * The class must already be loaded through RequestDefaultWeaponLoad.
+	 * @return The weapon actor, or nullptr if the class is not loaded.
 	 */
 	AWeapon* SpawnDefaultWeapon() const;
 
 	/**
-	 * @brief Equips the specified weapon.
-	 * Attaches the weapon to the given weapon socket on the player's skeletal mesh.
+	 * @brief Equips the specified weapon. Meant to run on the server, which replicates the result to the clients.
+	 * Attaches the weapon to the given weapon socket on the player's skeletal mesh and resolves its muzzle.
 	 * @param WeaponToEquip The weapon to be equipped.
 	 * @param EquippedWeapon A reference to the equipped weapon.
 	 * @param WeaponSlotSocket The socket to attach the weapon to.
@@ -150,6 +309,13 @@ public:
 	 */
 	void EquipWeapon(AWeapon* WeaponToEquip, AWeapon*& EquippedWeapon, const USkeletalMeshSocket* WeaponSlotSocket, USkeletalMeshComponent* PlayerMesh);
 
+	/**
+	 * @brief Takes on the trace ignores, the muzzle and the armed state of the weapon now held.
+	 * Called by EquipWeapon, and on clients when the weapon the server equipped replicates. Attaching is left to the caller.
+	 * @param Weapon The weapon now held, or nullptr when unarmed.
+	 */
+	void AdoptEquippedWeapon(AWeapon* Weapon);
+
 	/**
 	 * @brief Drops the equipped weapon.
 	 * Detaches the weapon from the player's skeletal mesh and sets its state to falling.
@@ -157,23 +323,85 @@ public:
 	 */
 	void DropWeapon(AWeapon*& WeaponToDrop);
 
+	/**
+	 * @brief Returns the equipped weapon to the item pool.
+	 * Detaches the weapon, parks it in the pool and leaves the player unarmed.
+	 * @param WeaponToRelease A reference to the weapon to be released. Cleared on return.
+	 */
+	void ReleaseWeapon(AWeapon*& WeaponToRelease);
+
+	/**
+	 * @brief Returns the handling state to how it was when play began.
+	 * Withdraws from the batched update and clears aiming, cooldowns, crosshair spread and the camera zoom.
+	 * Whether the cosmetic work is registered is kept, it follows the controller, not the life of the pawn.
+	 */
+	void ResetHandlingState();
+
+	/**
+	 * @brief Sets the armed state of the weapon model and mirrors it into the Blueprint-visible flags.
+	 * @param NewPlayerArmedState The new armed state.
+	 */
 	void SetPlayerArmedState(EPlayerArmedState NewPlayerArmedState);
 
 protected:
 	/**
 	 * @brief Called when the game starts.
-	 * Calls the parent class's BeginPlay function.
+	 * Caches the weapon handling subsystem and seeds the tick state from the configured defaults.
 	 */
 	virtual void BeginPlay() override;
 
 	/**
-	 * @brief Called every frame.
-	 * Calls the parent class's TickComponent function.
-	 * @param DeltaTime The time since the last frame.
-	 * @param TickType The type of tick this frame.
-	 * @param ThisTickFunction The tick function that caused this to run.
+	 * @brief Called when the component is removed from play.
+	 * Withdraws the component from the batched update.
+	 * @param EndPlayReason The reason play ended.
 	 */
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	friend class UWeaponHandlingSubsystem;
+#if WITH_DEV_AUTOMATION_TESTS
+	friend struct FWeaponHandlingTestWorld;
+#endif
+
+	/**
+	 * @brief Gets the live tick state.
+	 * @return The slot in UWeaponHandlingSubsystem while enrolled, the component's own copy otherwise.
+	 */
+	FWeaponHandlingTickState& GetMutableTickState();
+
+	/**
+	 * @brief Gets the live tick state.
+	 * @return The slot in UWeaponHandlingSubsystem while enrolled, the component's own copy otherwise.
+	 */
+	const FWeaponHandlingTickState& GetTickState() const;
+
+	/**
+	 * @brief Enrols the component with UWeaponHandlingSubsystem if its tick state has pending work.
+	 */
+	void RefreshTickEnrolment();
+
+	/**
+	 * @brief Reacts to the state advanced by UWeaponHandlingSubsystem this frame.
+	 * @param State The advanced state of this component.
+	 * @param Events The FWeaponModel::Event_* flags raised this frame.
+	 */
+	void HandleTickEvents(const FWeaponHandlingTickState& State, uint8 Events);
+
+	/**
+	 * @brief Tells the weapon model when the server starts or stops moving the character through the air.
+	 * Bound on servers only, where it feeds the floor of the crosshair spread the character's client may claim.
+	 * @param Character The owning character.
+	 * @param PrevMovementMode The movement mode before the change.
+	 * @param PreviousCustomMode The custom movement mode before the change.
+	 */
+	UFUNCTION()
+	void HandleOwnerMovementModeChanged(ACharacter* Character, EMovementMode PrevMovementMode, uint8 PreviousCustomMode);
+
+	/**
+	 * @brief Applies the blended field of view to the cached view camera.
+	 * @param CameraFOV The field of view to apply.
+	 */
+	void ChangeCameraFOV(float CameraFOV) const;
 
 private:
 	//Weapon VFX
@@ -193,20 +421,31 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Weapon|WeaponVfx", meta = (AllowPrivateAccess = "true"))
 	UParticleSystem* ImpactParticle = nullptr;
 
-	/** The class of the default weapon to be spawned. */
+	/** How many components of each effect are pooled when play begins. Shots reuse pooled components instead of spawning new ones. */
+	UPROPERTY(EditAnywhere, Category = "Weapon|WeaponVfx", meta = (AllowPrivateAccess = "true", ClampMin = 0))
+	int32 PrewarmedEffectCount = 16;
+
+	/** The class of the default weapon to be spawned. Loaded asynchronously while the owning pawn spawns. */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	TSubclassOf<AWeapon> DefaultWeaponClass;
+	TSoftClassPtr<AWeapon> DefaultWeaponClass;
+
+	/** Keeps the default weapon class and its assets resident once loaded. */
+	TSharedPtr<FStreamableHandle> DefaultWeaponLoadHandle;
 
 private:
 //Aiming related variables 
+	/** The camera driven by ChangeCameraFOV. Only set while the cosmetic tick is registered. */
+	UPROPERTY()
+	UCameraComponent* ViewCamera = nullptr;
+
+	/** True while the owning pawn is locally viewed and the cosmetic work should run. */
+	UPROPERTY(VisibleAnywhere, Category = "Field of View", meta = (AllowPrivateAccess = "true"))
+	bool bCosmeticTickRegistered;
+
 	/** The default camera field of view. */
 	UPROPERTY(EditAnywhere, Category = "Field of View", meta = (AllowPrivateAccess = "true"))
 	float DefaultCameraFOV;
 
-	/** The current camera field of view. */
-	UPROPERTY(EditAnywhere, Category = "Field of View", meta = (AllowPrivateAccess = "true"))
-	float CurrentCameraFOV;
-
 	/** The zoomed camera field of view. */
 	UPROPERTY(EditAnywhere, Category = "Field of View", meta = (AllowPrivateAccess = "true"))
 	float ZoomedCameraFOV;
@@ -219,46 +458,59 @@ private:
 	UPROPERTY(VisibleAnywhere, Category = "Field of View", meta = (AllowPrivateAccess = "true"))
 	bool bIsAiming;
 
-//Dynamic Crosshair Variables
+//Batched tick state
 private:
-	/** The crosshair spread multiplier based on player speed. */
-	UPROPERTY(VisibleAnywhere, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
-	float AcceleratingCrosshairMultiplier;
-
-	/** The crosshair spread multiplier when the player is in the air. */
-	UPROPERTY(VisibleAnywhere, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
-	float InAirCrosshairMultiplier;
-
-	/** The crosshair spread multiplier when the weapon is firing. */
-	UPROPERTY(VisibleAnywhere, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
-	float WeaponFireWeaponCrosshairMultiplier;
-
-	/** The crosshair spread multiplier when the player is aiming. */
-	UPROPERTY(VisibleAnywhere, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
-	float AimingCrosshairMultiplier;
+	/** The crosshair spread, fire cooldown and FOV blend state. Stale while enrolled with UWeaponHandlingSubsystem. */
+	UPROPERTY(VisibleAnywhere, Category = Weapon, meta = (AllowPrivateAccess = "true"))
+	FWeaponHandlingTickState TickState;
 
-	/** True if the weapon is firing, false otherwise. */
-	UPROPERTY(VisibleAnywhere, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
-	bool bIsFiringWeapon;
+	/** The slot of this component in UWeaponHandlingSubsystem, or INDEX_NONE while not enrolled. */
+	int32 TickSlot = INDEX_NONE;
 
-	/** The timer handle for stopping the firing of the weapon. */
-	UPROPERTY(VisibleAnywhere, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
-	FTimerHandle DynamicCrosshairWeaponFireTimer;
+	/** The subsystem that advances the tick state while there is pending work. */
+	UPROPERTY()
+	UWeaponHandlingSubsystem* WeaponHandlingSubsystem = nullptr;
 
 //Firing weapon Variables
 private:
-	/** The timer handle for auto firing the weapon. */
-	UPROPERTY()
-	FTimerHandle WeaponFireTimer;
+	/** The query params shared by every weapon trace. Ignores the owner and the equipped weapon; rebuilt on equip and drop only. */
+	FCollisionQueryParams WeaponTraceParams;
 
-	/** True if the weapon should fire, false otherwise. */
-	UPROPERTY(VisibleAnywhere, Category = Weapon, meta = (AllowPrivateAccess = "true"))
-	bool bShouldFireWeapon;
+	/** WeaponTraceParams that also ignore the characters of the hitbox layer, for the world part of a weapon trace. */
+	mutable FCollisionQueryParams WorldTraceParams;
 
-	/** The rate at which the weapon fires. */
+	/** The hitbox layer registration serial WorldTraceParams were built for, or MAX_uint32 if they must be rebuilt. */
+	mutable uint32 WorldTraceParamsSerial = MAX_uint32;
+
+	/** The delay between shots in seconds, rounded up to whole simulation steps of FWeaponModel::StepSeconds. */
 	UPROPERTY(EditAnywhere, Category = Weapon, meta = (AllowPrivateAccess = "true"))
 	float WeaponFireRate;
 
+	/** The weapon shots are played from. Kept so remote shots need no help from the owning pawn. */
+	UPROPERTY()
+	AWeapon* MuzzleWeapon = nullptr;
+
+//Replicated fire
+private:
+	/** How far from the pawn a client's aim ray may start before the server ignores the shot. */
+	UPROPERTY(EditAnywhere, Category = "Weapon|Network", meta = (AllowPrivateAccess = "true"))
+	float MaxFireOriginOffset = 1000.f;
+
+	/** The most shots or pellets batched into a single multicast. A full batch is sent without waiting for the net update. */
+	UPROPERTY(EditAnywhere, Category = "Weapon|Network", meta = (AllowPrivateAccess = "true", ClampMin = 1))
+	int32 MaxBatchedShots = 8;
+
+	/** The shots the server accepted since the last net update. */
+	TArray<FWeaponFireCosmetic> PendingFireCosmetics;
+
+	/** The hitbox history shots are validated against. Only set on servers, where the owner is registered with it. */
+	UPROPERTY()
+	ULagCompensationSubsystem* LagCompensationSubsystem = nullptr;
+
+	/** The hitbox layer weapon rays resolve characters against. The owner is registered with it on every machine. */
+	UPROPERTY()
+	UHitboxSubsystem* HitboxSubsystem = nullptr;
+
 //Weapon Armed State
 private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="PlayerArmedState", meta = (AllowPrivateAccess = true))
@@ -284,7 +536,26 @@ public:
 	 * @brief Gets the firing state of the weapon.
 	 * @return True if the weapon should fire, false otherwise.
 	 */
-	FORCEINLINE bool GetShouldFireWeapon() const { return bShouldFireWeapon; }
+	FORCEINLINE bool GetShouldFireWeapon() const { return GetTickState().Model.bReadyToFire; }
+
+	/**
+	 * @brief Gets whether the weapon fire debug output is enabled.
+	 * Controlled by the LastShooter.Weapon.DebugFire console variable. Always false in shipping builds.
+	 * @return True if fire, pickup and equip debug messages and lines should be drawn, false otherwise.
+	 */
+	static bool IsFireDebugEnabled();
+
+	/**
+	 * @brief Gets the crosshair spread multiplier blended between the last two simulation steps, for the HUD.
+	 * @return The total crosshair spread multiplier.
+	 */
+	FORCEINLINE float GetCrosshairSpreadMultiplier() const { return GetTickState().PresentedCrosshairSpreadMultiplier; }
+
+	/**
+	 * @brief Gets whether the cosmetic per-frame work is registered.
+	 * @return True if the owning pawn is locally viewed, false otherwise.
+	 */
+	FORCEINLINE bool IsCosmeticTickRegistered() const { return bCosmeticTickRegistered; }
 
 	FORCEINLINE bool GetIsArmed() const { return bIsArmed; }
 
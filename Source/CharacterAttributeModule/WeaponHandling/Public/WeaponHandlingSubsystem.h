@@ -0,0 +1,109 @@
+/**
+ * @file WeaponHandlingSubsystem.h
+ * @brief This file contains the declaration of the UWeaponHandlingSubsystem class.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingTickState.h"
+#include "WeaponHandlingSubsystem.generated.h"
+
+class UParticleSystem;
+class UWeaponHandlingComponent;
+
+/**
+ * @class UWeaponHandlingSubsystem
+ * @brief Advances every active weapon handler in the world from a single tick.
+ *
+ * Weapon handling components do not tick themselves. A component enrols here only while it has pending work
+ * (a running fire cooldown, an unsettled crosshair spread or camera FOV blend) and is withdrawn as soon as its
+ * state settles. The state of enrolled handlers lives in one contiguous array that is advanced in a tight loop.
+ *
+ * Frame time is collected in an accumulator and the handlers are advanced in fixed steps of
+ * FWeaponModel::StepSeconds, so a 30 Hz server and a 144 FPS client simulate the same steps.
+ * Between steps the presented values are blended by how far the frame is into the next step.
+ */
+UCLASS()
+class CHARACTERATTRIBUTEMODULE_API UWeaponHandlingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief Enrols a handler so its state is advanced every frame.
+	 * Copies the handler's state into the active array. Does nothing if the handler is already enrolled.
+	 * @param Handler The weapon handler to enrol.
+	 */
+	void Enrol(UWeaponHandlingComponent* Handler);
+
+	/**
+	 * @brief Withdraws a handler and copies its active state back onto the component.
+	 * @param Handler The weapon handler to withdraw.
+	 */
+	void Withdraw(UWeaponHandlingComponent* Handler);
+
+	/**
+	 * @brief Gets the active state stored in the given slot.
+	 * @param Slot The slot handed out by Enrol.
+	 * @return The mutable state of the enrolled handler.
+	 */
+	FORCEINLINE FWeaponHandlingTickState& GetState(const int32 Slot) { return ActiveStates[Slot]; }
+
+	/**
+	 * @brief Gets the number of handlers currently enrolled.
+	 * @return The number of active handlers.
+	 */
+	FORCEINLINE int32 GetNumActiveHandlers() const { return ActiveStates.Num(); }
+
+	/**
+	 * @brief Runs the fixed steps the frame time covers, blends the presented values and withdraws the settled handlers.
+	 * @param DeltaTime The time since the last frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	/**
+	 * @brief Only ticks while at least one handler is enrolled.
+	 * @return True if there is pending work, false otherwise.
+	 */
+	virtual bool IsTickable() const override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * @brief Fills the world's particle pool with components of a weapon effect before the first shot needs them.
+	 * @param Template The effect. Each template is pre-warmed once per world, however many handlers play it.
+	 * @param Count The number of components to pool.
+	 */
+	void PrewarmEffect(UParticleSystem* Template, int32 Count);
+
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * @brief Removes the handler in the given slot by swapping the last slot into its place.
+	 * @param Slot The slot to remove.
+	 */
+	void RemoveAtSwap(int32 Slot);
+
+	/** The state of every enrolled handler, packed contiguously. */
+	TArray<FWeaponHandlingTickState> ActiveStates;
+
+	/** The enrolled handlers, parallel to ActiveStates. */
+	UPROPERTY()
+	TArray<UWeaponHandlingComponent*> ActiveHandlers;
+
+	/** The events raised by the steps of the last frame, parallel to ActiveStates. */
+	TArray<uint8> ActiveEvents;
+
+	/** Frame time not yet simulated, always less than one step after a frame. */
+	double StepAccumulator = 0.0;
+
+	/** The effects already pre-warmed in this world. */
+	UPROPERTY()
+	TArray<UParticleSystem*> PrewarmedEffects;
+};
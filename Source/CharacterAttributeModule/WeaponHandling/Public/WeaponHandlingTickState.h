@@ -0,0 +1,85 @@
+/**
+ * @file WeaponHandlingTickState.h
+ * @brief This file contains the declaration of the FWeaponHandlingTickState struct.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponModel.h"
+#include "WeaponHandlingTickState.generated.h"
+
+/**
+ * @struct FWeaponHandlingTickState
+ * @brief The per-frame state of a single weapon handler: its weapon model and camera FOV blend.
+ *
+ * Kept as plain data so UWeaponHandlingSubsystem can advance every active handler in one loop over a contiguous array.
+ * The combat maths lives in the engine-independent FWeaponModel; this struct adds what only a viewed pawn needs.
+ * The state is simulated in fixed steps of FWeaponModel::StepSeconds, so spread and fire cadence do not depend on
+ * the frame rate. Presentation reads the Presented* values, which blend between the last two steps.
+ */
+USTRUCT()
+struct CHARACTERATTRIBUTEMODULE_API FWeaponHandlingTickState
+{
+	GENERATED_BODY()
+
+	/** The armed state, fire scheduling and crosshair spread of the handler. */
+	FWeaponModel Model;
+
+	/** Whether the crosshair spread should be integrated. Only the locally viewed pawn tracks it. */
+	bool bTracksSpread = false;
+
+	/** Whether the camera FOV should be blended. Only the locally viewed pawn drives a camera. */
+	bool bDrivesCamera = false;
+
+//Crosshair spread
+	/** The total crosshair spread multiplier before the last step. */
+	float PreviousCrosshairSpreadMultiplier = 0.5f;
+
+	/** The total crosshair spread multiplier blended between the last two steps for the HUD. */
+	UPROPERTY(VisibleAnywhere, Category = Crosshair)
+	float PresentedCrosshairSpreadMultiplier = 0.5f;
+
+//Camera field of view
+	/** The camera field of view as of the last step. */
+	UPROPERTY(VisibleAnywhere, Category = "Field of View")
+	float CurrentCameraFOV = 90.f;
+
+	/** The camera field of view before the last step. */
+	float PreviousCameraFOV = 90.f;
+
+	/** The camera field of view blended between the last two steps, applied to the camera. */
+	UPROPERTY(VisibleAnywhere, Category = "Field of View")
+	float PresentedCameraFOV = 90.f;
+
+	/** The field of view the camera is blending towards. */
+	UPROPERTY(VisibleAnywhere, Category = "Field of View")
+	float TargetCameraFOV = 90.f;
+
+	/** The interpolation speed for zooming. */
+	float ZoomInterpSpeed = 20.f;
+
+	/**
+	 * @brief Advances the state by one fixed step of FWeaponModel::StepSeconds.
+	 * @return A mask of FWeaponModel::Event_* flags raised by the step.
+	 */
+	uint8 Advance();
+
+	/**
+	 * @brief Blends the presented values between the last two steps.
+	 * @param Alpha How far the frame is between the last step and the next one, in [0, 1].
+	 */
+	void Present(float Alpha);
+
+	/**
+	 * @brief Makes the simulated values the presented ones, with nothing left to blend.
+	 * Called when the state is set directly rather than stepped, and when it settles.
+	 */
+	void SnapPresentation();
+
+	/**
+	 * @brief Checks whether the handler still has anything to advance.
+	 * @return True while the model has not settled or the FOV is still blending, false otherwise.
+	 */
+	bool HasPendingWork() const;
+};
@@ -0,0 +1,226 @@
+/**
+ * @file WeaponModel.h
+ * @brief This file contains the declaration of the FWeaponModel struct, the engine-independent core of weapon handling.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponArchetypeTraits.h"
+
+/**
+ * @struct FWeaponModel
+ * @brief The combat maths of one weapon handler: armed state, fire scheduling, crosshair spread and shot acceptance.
+ *
+ * Plain data with no UObject, world or timer dependencies, advanced in fixed steps of StepSeconds.
+ * UWeaponHandlingComponent wraps one inside its batched tick state; offline harnesses can step any number of them
+ * on any thread and get exactly the results a game would.
+ */
+struct CHARACTERATTRIBUTEMODULE_API FWeaponModel
+{
+	/** Raised by Step when the fire cooldown has just run out. */
+	static constexpr uint8 Event_FireCooldownElapsed = 1 << 0;
+
+	/** Raised by Step when the firing spread window has just run out. */
+	static constexpr uint8 Event_FiringSpreadElapsed = 1 << 1;
+
+	/** The length of one simulation step. Fixed at compile time so every client and server simulates the same steps. */
+	static constexpr float StepSeconds = 1.f / 60.f;
+
+	/** The remote shots the server accepts back to back, for shots that reach it bunched together. */
+	static constexpr int32 RemoteShotBurst = 8;
+
+//Crosshair spread inputs, sampled by the owning pawn
+	/** The current horizontal speed of the player. */
+	float PlayerSpeed = 0.f;
+
+	/** The maximum speed of the player. */
+	float MaxSpeed = 0.f;
+
+	/** Whether the player is in the air. */
+	bool bIsInAir = false;
+
+	/** Whether the player is aiming. */
+	bool bIsAiming = false;
+
+//Crosshair spread
+	/** The crosshair spread multiplier based on player speed. */
+	float AcceleratingCrosshairMultiplier = 0.f;
+
+	/** The crosshair spread multiplier when the player is in the air. */
+	float InAirCrosshairMultiplier = 0.f;
+
+	/** The crosshair spread multiplier when the player is aiming. */
+	float AimingCrosshairMultiplier = 0.f;
+
+	/** The crosshair spread multiplier when the weapon is firing. */
+	float WeaponFireCrosshairMultiplier = 0.f;
+
+	/** The total crosshair spread multiplier as of the last step. Shots are spread by this value. */
+	float CrosshairSpreadMultiplier = 0.5f;
+
+//Fire scheduling
+	/** Steps between shots. Three steps is the default fire rate of 0.05 seconds. */
+	int32 FireIntervalSteps = 3;
+
+	/** Steps a shot keeps the firing contribution of the crosshair spread active. */
+	int32 FiringSpreadWindowSteps = 3;
+
+	/** Steps until the cooldown re-arms the weapon. */
+	int32 FireCooldownSteps = 0;
+
+	/** Steps the firing contribution to the crosshair spread stays active. */
+	int32 FiringSpreadSteps = 0;
+
+	/** Whether the next shot may be fired. Cleared by a shot, set again by the cooldown or by releasing the trigger. */
+	bool bReadyToFire = true;
+
+	/** The index the next shot takes in the weapon's spread stream. */
+	uint16 NextShotIndex = 0;
+
+//Armed state
+	/** The weapon the handler is armed with. */
+	EWeaponArchetype Archetype = EWeaponArchetype::Unarmed;
+
+	/** The fire kernel of the archetype, picked when the handler is armed so shots never look the weapon up. */
+	const FWeaponFireKernel* Kernel = &WeaponFireKernel::Get(EWeaponArchetype::Unarmed);
+
+//Shot acceptance, used by the server for the shots of a remote handler
+	/** The shots a remote handler may still send back to back. Refilled at the fire rate, up to RemoteShotBurst. */
+	double RemoteShotTokens = 0.0;
+
+	/** The time the remote shot tokens were last refilled, or a negative value before the first shot. */
+	double LastRemoteShotTime = -1.0;
+
+	/** The index of the last accepted shot, or INDEX_NONE before the first one. */
+	int32 LastAcceptedShotIndex = INDEX_NONE;
+
+//Remote crosshair spread, estimated by the server from what it sees of a remote handler
+	/** Whether the server last saw the remote handler's pawn in the air. */
+	bool bRemoteInAir = false;
+
+	/** The in-air crosshair multiplier of the remote handler as of LastRemoteSpreadTime. */
+	float RemoteInAirMultiplier = 0.f;
+
+	/** The firing crosshair multiplier of the remote handler as of LastRemoteSpreadTime. */
+	float RemoteWeaponFireMultiplier = 0.f;
+
+	/** Steps the firing contribution to the remote handler's crosshair spread stays active. */
+	int32 RemoteFiringSpreadSteps = 0;
+
+	/** The time the remote spread estimate was last advanced to, or a negative value before it starts. */
+	double LastRemoteSpreadTime = -1.0;
+
+	/**
+	 * @brief Converts a duration into whole simulation steps, rounding up.
+	 * @param Seconds The duration.
+	 * @return The number of steps that covers the duration.
+	 */
+	static FORCEINLINE int32 SecondsToSteps(const float Seconds) { return FMath::Max(FMath::CeilToInt32(Seconds / StepSeconds - UE_KINDA_SMALL_NUMBER), 0); }
+
+	/**
+	 * @brief Arms the handler with a weapon, or disarms it.
+	 * @param NewArchetype The weapon to hold, or Unarmed.
+	 */
+	FORCEINLINE void SetArchetype(const EWeaponArchetype NewArchetype)
+	{
+		Archetype = NewArchetype;
+		Kernel = &WeaponFireKernel::Get(NewArchetype);
+	}
+
+	/**
+	 * @brief Gets the fire kernel of the weapon the handler holds.
+	 * @return The kernel picked by SetArchetype.
+	 */
+	FORCEINLINE const FWeaponFireKernel& GetKernel() const { return *Kernel; }
+
+	/**
+	 * @brief Checks whether the handler holds a weapon.
+	 * @return True if armed, false otherwise.
+	 */
+	FORCEINLINE bool IsArmed() const { return Archetype != EWeaponArchetype::Unarmed; }
+
+	/**
+	 * @brief Checks whether the weapon is inside its firing spread window.
+	 * @return True if the weapon fired recently, false otherwise.
+	 */
+	FORCEINLINE bool IsFiringWeapon() const { return FiringSpreadSteps > 0; }
+
+	/**
+	 * @brief Fires a shot if the weapon is armed and ready.
+	 * Starts the fire cooldown and the firing spread window.
+	 * @param OutShotIndex Receives the index of the shot in the weapon's spread stream.
+	 * @return True if a shot was fired, false otherwise.
+	 */
+	bool TryFire(uint16& OutShotIndex);
+
+	/**
+	 * @brief Judges a shot a remote handler claims to have fired.
+	 * @param ShotIndex The index of the shot in the weapon's spread stream.
+	 * @param Now The current time in seconds.
+	 * @return True if the shot is accepted, false otherwise.
+	 */
+	bool AcceptRemoteShot(uint16 ShotIndex, double Now);
+
+	/**
+	 * @brief Tells the server whether the pawn of a remote handler is in the air.
+	 * @param bInAir Whether the server moves the pawn through the air.
+	 * @param Now The current time in seconds.
+	 */
+	void SetRemoteInAir(bool bInAir, double Now);
+
+	/**
+	 * @brief Advances the server's estimate of a remote handler's crosshair spread in whole steps.
+	 * @param Now The current time in seconds.
+	 */
+	void AdvanceRemoteSpread(double Now);
+
+	/**
+	 * @brief Gets the lowest crosshair spread multiplier a remote handler can honestly have fired a shot with.
+	 * @param Now The current time in seconds.
+	 * @param LeadSeconds How far the remote handler can be ahead of or behind the server's view of it.
+	 * @return The floor of the multiplier the handler can claim.
+	 */
+	float GetRemoteSpreadFloor(double Now, double LeadSeconds);
+
+	/**
+	 * @brief Clamps a crosshair spread multiplier to the range the spread blend can produce.
+	 * The server applies it to the multiplier a remote handler sends, once the claim has cleared GetRemoteSpreadFloor.
+	 * @param SpreadMultiplier The claimed multiplier.
+	 * @return The multiplier, between the spread of a still, aiming handler and that of a moving, airborne, firing one.
+	 */
+	static float ClampSpreadMultiplier(float SpreadMultiplier);
+
+	/**
+	 * @brief Gets the cone half angle of a shot fired with a crosshair spread multiplier.
+	 * @param SpreadMultiplier The crosshair spread multiplier when the shot was fired.
+	 * @return The half angle in degrees.
+	 */
+	FORCEINLINE float GetShotHalfAngleDegrees(const float SpreadMultiplier) const { return Kernel->GetShotHalfAngleDegrees(SpreadMultiplier); }
+
+	/**
+	 * @brief Gets the number of pellets every shot fires.
+	 * @return The number of pellets, at least one.
+	 */
+	FORCEINLINE int32 GetNumPellets() const { return Kernel->NumPellets; }
+
+	/**
+	 * @brief Advances the cooldowns and, if asked to, the crosshair spread by one fixed step.
+	 * @param bIntegrateSpread Whether the crosshair spread should be integrated. Only viewed handlers need it.
+	 * @return A mask of Event_* flags raised by the step.
+	 */
+	uint8 Step(bool bIntegrateSpread);
+
+	/**
+	 * @brief Checks whether stepping would change anything.
+	 * @param bIntegrateSpread Whether the crosshair spread is integrated.
+	 * @return True once the cooldowns have run out and the spread has reached its targets, false otherwise.
+	 */
+	bool IsSettled(bool bIntegrateSpread) const;
+
+	/**
+	 * @brief Clears the inputs, the spread, the cooldowns and the accepted shots of a previous life.
+	 * The archetype and its kernel, the fire rate and the shot index are kept.
+	 */
+	void Reset();
+};
@@ -0,0 +1,117 @@
+/**
+ * @file WeaponSpread.h
+ * @brief This file contains the deterministic shot spread used by both the firing client and the server.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EWeaponArchetype : uint8;
+
+/**
+ * Counter-based shot spread. Every random number is a pure function of a weapon seed, a shot index and
+ * the number's position in the shot, so the client and the server derive the same pellet directions from
+ * the shot index alone and nothing but that index needs to be sent.
+ */
+namespace WeaponSpread
+{
+	/** The most pellets a single shot can fire. */
+	constexpr int32 MaxPellets = 16;
+
+	/** The widest cone half angle a shot can have. */
+	constexpr float MaxHalfAngleDegrees = 30.f;
+
+	/**
+	 * @brief Scrambles a 32-bit integer. A bijection, so distinct counters never collide.
+	 * @param Value The value to scramble.
+	 * @return The scrambled value.
+	 */
+	FORCEINLINE uint32 Mix(uint32 Value)
+	{
+		Value ^= Value >> 16;
+		Value *= 0x7feb352dU;
+		Value ^= Value >> 15;
+		Value *= 0x846ca68bU;
+		Value ^= Value >> 16;
+		return Value;
+	}
+
+	/**
+	 * @brief Combines a weapon seed and a shot index into the key of a shot's random stream.
+	 * @param Seed The seed of the weapon.
+	 * @param ShotIndex The index of the shot fired with the weapon.
+	 * @return The key of the shot.
+	 */
+	FORCEINLINE uint32 MakeShotKey(const uint32 Seed, const uint32 ShotIndex) { return Mix(Seed ^ Mix(ShotIndex + 0x9e3779b9U)); }
+
+	/**
+	 * @brief Gets the random number at a position in a shot's stream.
+	 * @param ShotKey The key made by MakeShotKey.
+	 * @param Counter The position in the stream.
+	 * @return 32 random bits.
+	 */
+	FORCEINLINE uint32 Random(const uint32 ShotKey, const uint32 Counter) { return Mix(ShotKey + Counter * 0x9e3779b9U); }
+
+	/**
+	 * @brief Maps random bits onto [0, 1).
+	 * @param Bits The random bits.
+	 * @return A float with 24 random bits of mantissa.
+	 */
+	FORCEINLINE float ToUnitFloat(const uint32 Bits) { return static_cast<float>(static_cast<int32>(Bits >> 8)) * (1.f / 16777216.f); }
+
+	/**
+	 * @brief Makes the seed of a weapon held by a player.
+	 * @param PlayerId The replicated id of the player, known to the client and the server alike.
+	 * @param Archetype The archetype of the weapon, which the server checks against the one it has equipped.
+	 * @return The seed of the weapon's random stream.
+	 */
+	CHARACTERATTRIBUTEMODULE_API uint32 MakeWeaponSeed(int32 PlayerId, EWeaponArchetype Archetype);
+
+	/**
+	 * @brief Generates the directions of every pellet of a shot.
+	 *
+	 * Pellets are spread uniformly over a cone around the aim direction. The random numbers for all pellets are
+	 * generated first in one branch-free loop over fixed-size arrays, which the compiler vectorises. The pellet count
+	 * is a template parameter so every weapon archetype gets a loop sized for its own pellets.
+	 * @tparam NumPellets The number of pellets, at most MaxPellets.
+	 * @param AimDirection The unit direction the shot is aimed at.
+	 * @param Seed The seed of the weapon.
+	 * @param ShotIndex The index of the shot.
+	 * @param HalfAngleDegrees The half angle of the cone.
+	 * @param OutDirections Receives NumPellets unit directions.
+	 */
+	template<int32 NumPellets>
+	void GeneratePelletDirections(const FVector& AimDirection, const uint32 Seed, const uint32 ShotIndex, const float HalfAngleDegrees, FVector* OutDirections)
+	{
+		static_assert(NumPellets > 0 && NumPellets <= MaxPellets, "A shot fires between one and MaxPellets pellets");
+
+		// Whole SIMD registers. Generating the unused lanes is cheaper than the branch it would take to skip them.
+		constexpr int32 NumLanes = (NumPellets + 3) & ~3;
+
+		const uint32 ShotKey = MakeShotKey(Seed, ShotIndex);
+		const float TanHalfAngle = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(HalfAngleDegrees, 0.f, MaxHalfAngleDegrees)));
+
+		// Every lane is independent and the trip count is fixed, so this loop compiles to SIMD integer and float maths
+		alignas(16) float Radius[NumLanes];
+		alignas(16) float Angle[NumLanes];
+		for ( int32 Lane = 0; Lane < NumLanes; ++Lane ) {
+			const float U = ToUnitFloat(Random(ShotKey, 2 * Lane));
+			const float V = ToUnitFloat(Random(ShotKey, 2 * Lane + 1));
+			// The square root spreads pellets evenly over the cone's cross-section instead of bunching them in the middle
+			Radius[Lane] = FMath::Sqrt(U) * TanHalfAngle;
+			Angle[Lane] = V * UE_TWO_PI;
+		}
+
+		FVector Right;
+		FVector Up;
+		AimDirection.FindBestAxisVectors(Right, Up);
+
+		for ( int32 Pellet = 0; Pellet < NumPellets; ++Pellet ) {
+			float Sin;
+			float Cos;
+			FMath::SinCos(&Sin, &Cos, Angle[Pellet]);
+			OutDirections[Pellet] = (AimDirection + Right * (Radius[Pellet] * Cos) + Up * (Radius[Pellet] * Sin)).GetSafeNormal();
+		}
+	}
+}
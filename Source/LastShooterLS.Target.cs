@@ -12,5 +12,11 @@ public class LastShooterLSTarget : TargetRules
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_4;
 		ExtraModuleNames.Add("LastShooterLS");
 		ExtraModuleNames.Add("WorldItemsModule");
+
+		// The benchmark tests, never part of a shipping game
+		if (Target.Configuration != UnrealTargetConfiguration.Shipping)
+		{
+			ExtraModuleNames.Add("LastShooterTests");
+		}
 	}
 }
@@ -8,6 +8,7 @@
 #include "KismetAnimationLibrary.h"
 #include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "LastShooterLS/Profiling.h"
 
 /**
  * @brief Called when the animation instance is initialized.
@@ -28,6 +29,9 @@ void UPlayerAnimInstance::NativeInitializeAnimation()
  */
 void UPlayerAnimInstance::NativeUpdateAnimation(float DeltaTime)
 {
+	LASTSHOOTER_SCOPE(NativeUpdateAnimation);
+	CSV_SCOPED_TIMING_STAT(LastShooter, NativeUpdateAnimation);
+
 	Super::NativeUpdateAnimation(DeltaTime);
 
 	if (Belica == nullptr)
@@ -4,6 +4,7 @@
  */
 
 #include "BelicaCharacter.h"
+#include "BelicaMovementComponent.h"
 
 #include "Camera/CameraComponent.h"
 #include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingComponent.h"
@@ -11,18 +12,28 @@
 #include "Engine/SkeletalMeshSocket.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
+#include "LastShooterLS/Profiling.h"
+#include "Net/UnrealNetwork.h"
 #include "WorldItemsModule/Item/Public/Item.h"
 #include "WorldItemsModule/Weapon/Public/Weapon.h"
 
+/** Socket and section names are hashed once here instead of on every equip or shot. */
+static const FName RightHandWeaponSocketName(TEXT("Hand_R_Weapon_Socket"));
+static const FName FireMontageStartSectionName(TEXT("Start"));
+
 /**
  * @brief Sets default values for this character's properties.
  *
  * Initializes the character with a camera boom to keep the camera behind the character,
  * a follow camera, and a WeaponHandling component. Configures the character to be ticked every frame.
+ * Movement runs through UBelicaMovementComponent, which predicts run and walk toggles.
+ *
+ * @param ObjectInitializer The initializer used to override the default subobject classes.
  */
-ABelicaCharacter::ABelicaCharacter() {
-	
-    // Set this character to call Tick() every frame. You can turn this off to improve performance if you don't need it.
+ABelicaCharacter::ABelicaCharacter( const FObjectInitializer& ObjectInitializer ) : Super(ObjectInitializer.SetDefaultSubobjectClass<UBelicaMovementComponent>(ACharacter::CharacterMovementComponentName)) {
+	LLM_SCOPE_BYTAG(LastShooter_Characters);
+
+    // Set this character to call Tick() every frame. The C++ cosmetic work in it only runs for the locally viewed pawn.
     PrimaryActorTick.bCanEverTick = true;
 
 	GetCharacterMovement()->GetNavAgentPropertiesRef().bCanCrouch =	true;
@@ -30,6 +41,10 @@ ABelicaCharacter::ABelicaCharacter() {
     // Create a camera boom (a spring arm that will keep the camera behind the character)
     CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
     CameraBoom->SetupAttachment(RootComponent);
+#if UE_SERVER
+    // The boom only places the camera; server builds never view through it
+    CameraBoom->PrimaryComponentTick.bCanEverTick = false;
+#endif
 
     // Set the camera boom properties
     CameraBoom->bUsePawnControlRotation = true; // Rotate the arm based on the controller
@@ -61,42 +76,130 @@ ABelicaCharacter::ABelicaCharacter() {
 /**
  * @brief Called when the game starts or when spawned.
  *
- * Initializes the character by calling the parent class's BeginPlay function
- * and handling the default weapon spawn.
+ * Initializes the character by calling the parent class's BeginPlay function,
+ * binding the pickup overlap and remote fire events and arming the default weapon if it is already loaded.
+ * On a dedicated server the camera rig stops ticking, since nobody looks through it.
  */
 void ABelicaCharacter::BeginPlay() {
     Super::BeginPlay();
 
-	FTimerDelegate TestTimerDelegate;
-	TestTimerDelegate.BindLambda([this](){
-		// Handle spawning of the default weapon
-		HandleDefaultWeaponSpawn();
+	PickupSphere->OnComponentBeginOverlap.AddDynamic(this, &ABelicaCharacter::OnOverlapBegin);
+	PickupSphere->OnComponentEndOverlap.AddDynamic(this, &ABelicaCharacter::OnOverlapEnd);
+
+	if ( IsRunningDedicatedServer() ) {
+		CameraBoom->SetComponentTickEnabled(false);
+		FollowCamera->SetComponentTickEnabled(false);
+	}
+	else {
+		// Shots of other players arrive through the weapon handling multicast and animate here
+		WeaponHandling->OnRemoteWeaponFired.AddUObject(this, &ABelicaCharacter::PlayWeaponFireMontage);
+	}
+
+	// The loadout may have finished loading while the pawn was being spawned
+	if ( bDefaultLoadoutReady ) { HandleDefaultWeaponSpawn(); }
+}
+
+
+/**
+ * @brief Called once all components are initialized.
+ *
+ * Resolves the right-hand weapon socket so equipping never looks it up by name, and
+ * kicks off the asynchronous default loadout load while the pawn is still spawning.
+ */
+void ABelicaCharacter::PostInitializeComponents() {
+	Super::PostInitializeComponents();
+
+	RightHandWeaponSocket = GetMesh()->GetSocketByName(RightHandWeaponSocketName);
+
+	if ( GetWorld() && GetWorld()->IsGameWorld() ) {
+		SpawnStartTime = FPlatformTime::Seconds();
+		WeaponHandling->RequestDefaultWeaponLoad(FStreamableDelegate::CreateUObject(this, &ABelicaCharacter::OnDefaultLoadoutLoaded));
+	}
+}
+
+
+/**
+ * @brief Called when the default weapon class and its assets are loaded.
+ *
+ * Arms the character immediately if play has begun, otherwise BeginPlay does it.
+ */
+void ABelicaCharacter::OnDefaultLoadoutLoaded() {
+	bDefaultLoadoutReady = true;
+
+	if ( HasActorBegunPlay() && !bIsPooled ) { HandleDefaultWeaponSpawn(); }
+}
+
 
-		PickupSphere->OnComponentBeginOverlap.AddDynamic(this, &ABelicaCharacter::OnOverlapBegin);
-		PickupSphere->OnComponentEndOverlap.AddDynamic(this, &ABelicaCharacter::OnOverlapEnd);
-	});
+/**
+ * @brief Called whenever the controller of this pawn changes.
+ *
+ * Re-evaluates whether this pawn is locally viewed and (un)registers the cosmetic work accordingly.
+ */
+void ABelicaCharacter::NotifyControllerChanged() {
+	Super::NotifyControllerChanged();
 
-	FTimerHandle TestHandle;
-	GetWorldTimerManager().SetTimer(TestHandle, TestTimerDelegate, 1.f,false);
+	RefreshCosmeticTickRegistration();
+}
+
+
+/**
+ * @brief Registers the cosmetic tick for the locally viewed pawn only.
+ *
+ * AI controllers are local on the server, so the pawn must also be player controlled
+ * for its crosshair and camera to be on screen.
+ */
+void ABelicaCharacter::RefreshCosmeticTickRegistration() {
+	const bool bIsLocallyViewed = IsLocallyControlled() && IsPlayerControlled();
+
+	if ( WeaponHandling ) {
+		if ( bIsLocallyViewed ) { WeaponHandling->RegisterCosmeticTick(FollowCamera); }
+		else { WeaponHandling->UnregisterCosmeticTick(); }
+	}
+}
+
+
+/**
+ * @brief Replicates the equipped weapon to every client.
+ * @param OutLifetimeProps The replicated properties of the character.
+ */
+void ABelicaCharacter::GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ABelicaCharacter, EquippedWeapon);
+}
+
+
+/**
+ * @brief Mirrors the weapon the server equipped or dropped on this client.
+ *
+ * The weapon's attachment replicates on its own as well, but may arrive after this, so the weapon is attached
+ * here first: its muzzle may be a socket on the character mesh.
+ * @param PreviousWeapon The weapon held before the change, or nullptr.
+ */
+void ABelicaCharacter::OnRep_EquippedWeapon( AWeapon* PreviousWeapon ) {
+	if ( PreviousWeapon && PreviousWeapon != EquippedWeapon && PreviousWeapon->GetAttachParentActor() == this ) {
+		PreviousWeapon->DetachFromActor(FDetachmentTransformRules(EDetachmentRule::KeepWorld, true));
+	}
+
+	if ( EquippedWeapon && RightHandWeaponSocket ) { RightHandWeaponSocket->AttachActor(EquippedWeapon, GetMesh()); }
+	WeaponHandling->AdoptEquippedWeapon(EquippedWeapon);
 }
 
 
 /**
  * @brief Called every frame.
  * 
- * Updates the character by calling the parent class's Tick function and calculates
- * the crosshair spread based on the character's movement and status.
+ * Updates the character by calling the parent class's Tick function, which also runs Blueprint Tick,
+ * and runs the cosmetic work for the locally viewed pawn: crosshair spread and camera field of view.
  * @param DeltaTime The time since the last frame.
  */
 void ABelicaCharacter::Tick(float DeltaTime) {
-    Super::Tick(DeltaTime);
+	LASTSHOOTER_SCOPE(BelicaTick);
 
-    // Calculate crosshair spread based on character's velocity and movement
-    CalculateCrosshairSpread(DeltaTime);
+    Super::Tick(DeltaTime);
 
-	if(WeaponHandling) {
-		WeaponHandling->ChangeCameraFOV(DeltaTime);
-	}
+    // Calculate crosshair spread and blend the camera field of view. Nobody sees them on other instances
+    if ( WeaponHandling->IsCosmeticTickRegistered() ) { CalculateCrosshairSpread(DeltaTime); }
 }
 
 
@@ -105,8 +208,10 @@ void ABelicaCharacter::Tick(float DeltaTime) {
  *
  * Retrieves the character's animation instance and plays the HipFireMontage if
  * both the animation instance and the montage are valid. Jumps to the start of the montage.
+ * Compiled out of server builds.
  */
 void ABelicaCharacter::PlayWeaponFireMontage() {
+#if !UE_SERVER
     // Get the character's animation instance
     UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
 
@@ -114,8 +219,9 @@ void ABelicaCharacter::PlayWeaponFireMontage() {
     if (AnimInstance && HipFireMontage)
     {
         AnimInstance->Montage_Play(HipFireMontage);
-        AnimInstance->Montage_JumpToSection(FName("Start")); // Jump to the start of the montage
+        AnimInstance->Montage_JumpToSection(FireMontageStartSectionName); // Jump to the start of the montage
     }
+#endif
 }
 
 
@@ -123,8 +229,8 @@ void ABelicaCharacter::PlayWeaponFireMontage() {
  * @brief Calculates the crosshair spread.
  *
  * Gets the player's velocity and speed, checks if the player is falling, and
- * calls the DynamicCrosshair function of the WeaponHandling component to update
- * the crosshair spread based on current conditions.
+ * feeds them to the TickCosmetic function of the WeaponHandling component. The
+ * spread and camera field of view are blended by the weapon handling subsystem.
  * @param DeltaTime The time since the last frame.
  */
 void ABelicaCharacter::CalculateCrosshairSpread(float DeltaTime) {
@@ -139,8 +245,9 @@ void ABelicaCharacter::CalculateCrosshairSpread(float DeltaTime) {
     // Check if the player is currently falling
     const bool bPlayerIsFalling = GetCharacterMovement()->IsFalling();
 
-    // Update crosshair spread based on movement and falling state
-    WeaponHandling->DynamicCrosshair(DeltaTime, PlayerSpeed, PlayerMaxSpeed, bPlayerIsFalling, CrosshairSpreadMultiplier);
+    // Feed the crosshair spread inputs; the blending is batched by the weapon handling subsystem
+    WeaponHandling->TickCosmetic(PlayerSpeed, PlayerMaxSpeed, bPlayerIsFalling);
+    CrosshairSpreadMultiplier = WeaponHandling->GetCrosshairSpreadMultiplier();
 }
 
 
@@ -149,42 +256,137 @@ void ABelicaCharacter::CalculateCrosshairSpread(float DeltaTime) {
  *
  * Retrieves the socket for the weapon attachment on the character's right hand
  * and spawns the default weapon using the WeaponHandling component.
+ * Only the server spawns it. Weapons replicate, so a spawn on every machine would leave duplicates
+ * in the world; clients receive the server's weapon through OnRep_EquippedWeapon.
  */
 void ABelicaCharacter::HandleDefaultWeaponSpawn() {
-	// Get the right-hand weapon socket
-	const USkeletalMeshSocket* RightHandWeaponSocket = GetMesh()->GetSocketByName("Hand_R_Weapon_Socket");
+	if ( !HasAuthority() ) { return; }
 
-	// Spawn the default weapon and attach it to the right-hand socket
+	// Spawn the default weapon and attach it to the cached right-hand socket
 	AWeapon* Weapon = WeaponHandling->SpawnDefaultWeapon();
 	WeaponHandling->EquipWeapon(Weapon,EquippedWeapon, RightHandWeaponSocket, GetMesh());
+
+	// Record how long it took from spawn until the character was armed
+	if ( EquippedWeapon ) {
+		TimeToArmed = static_cast<float>(FPlatformTime::Seconds() - SpawnStartTime);
+		SET_FLOAT_STAT(STAT_TimeToArmed, TimeToArmed * 1000.f);
+	}
 }
 
 
 void ABelicaCharacter::HandleEquipWeapon() {
+	LASTSHOOTER_SCOPE(HandleEquipWeapon);
+
 	PickupSphere->SetCollisionResponseToChannel(ECollisionChannel::ECC_WorldDynamic, ECollisionResponse::ECR_Overlap);
 	
-	if( EquipableItem ) {GEngine->AddOnScreenDebugMessage(1, 10.0f, FColor::Red, TEXT("Equipable Item") + EquipableItem->GetName());}
+	const bool bDebugEquip = UWeaponHandlingComponent::IsFireDebugEnabled();
+	if( EquipableItem && bDebugEquip ) {GEngine->AddOnScreenDebugMessage(1, 10.0f, FColor::Red, TEXT("Equipable Item") + EquipableItem->GetName());}
 
-	// Get the right-hand weapon socket
-	const USkeletalMeshSocket* RightHandWeaponSocket = GetMesh()->GetSocketByName("Hand_R_Weapon_Socket");
 	if(AWeapon* EquipableWeapon = Cast<AWeapon>(EquipableItem)) {
-		GEngine->AddOnScreenDebugMessage(2, 10.0f, FColor::Purple, TEXT("Equipable Weapon") + EquipableWeapon->GetName());
+		if ( bDebugEquip ) { GEngine->AddOnScreenDebugMessage(2, 10.0f, FColor::Purple, TEXT("Equipable Weapon") + EquipableWeapon->GetName()); }
 
-		WeaponHandling->EquipWeapon(EquipableWeapon, EquippedWeapon, RightHandWeaponSocket, GetMesh());
+		// The server decides what is held. Clients ask and receive the result through OnRep_EquippedWeapon
+		if ( HasAuthority() ) { EquipPickedUpWeapon(EquipableWeapon); }
+		else { ServerEquipWeapon(EquipableWeapon); }
 
-		GEngine->AddOnScreenDebugMessage(3, 10.0f, FColor::Green, TEXT("Equipped Weapon") + EquippedWeapon->GetName());
+		if ( EquippedWeapon && bDebugEquip ) { GEngine->AddOnScreenDebugMessage(3, 10.0f, FColor::Green, TEXT("Equipped Weapon") + EquippedWeapon->GetName()); }
 	}
 
 	PickupSphere->SetCollisionResponseToAllChannels(ECR_Ignore);
 }
 
 
+void ABelicaCharacter::ServerEquipWeapon_Implementation( AWeapon* Weapon ) {
+	EquipPickedUpWeapon(Weapon);
+}
+
+
+/**
+ * @brief Equips a weapon lying in pickup range. Server only.
+ *
+ * Refuses weapons that are held, stored or out of reach, whatever the client's pickup sphere reported.
+ * @param Weapon The weapon to pick up.
+ */
+void ABelicaCharacter::EquipPickedUpWeapon( AWeapon* Weapon ) {
+	if ( Weapon == nullptr ) { return; }
+
+	const EItemState WeaponState = Weapon->GetItemState();
+	if ( WeaponState != EItemState::EIS_InWorld && WeaponState != EItemState::EIS_Falling ) { return; }
+	if ( FVector::DistSquared(Weapon->GetActorLocation(), GetActorLocation()) > FMath::Square(MaxPickupDistance) ) { return; }
+
+	WeaponHandling->EquipWeapon(Weapon, EquippedWeapon, RightHandWeaponSocket, GetMesh());
+}
+
+
+/**
+ * @brief Resets the character in place for a new round or life without destroying it.
+ *
+ * Clears transient combat and movement state, teleports to the spawn transform and re-arms
+ * with a pooled default weapon, so respawning costs no actor spawns or asset loads.
+ *
+ * @param SpawnTransform Where the character respawns.
+ */
+void ABelicaCharacter::ResetForRespawn( const FTransform& SpawnTransform ) {
+	// Put down whatever the character was doing
+	EndWeaponFIre();
+	WeaponHandling->ResetHandlingState();
+	if ( bIsCrouched ) { UnCrouch(); }
+	GetCharacterMovement()->StopMovementImmediately();
+	GetBelicaMovement()->SetRequestedGait(EBelicaGait::Default);
+	EquipableItem = nullptr;
+
+	// Move back to the spawn point
+	TeleportTo(SpawnTransform.GetLocation(), SpawnTransform.Rotator(), false, true);
+	if ( Controller ) { Controller->SetControlRotation(SpawnTransform.Rotator()); }
+
+	// Swap whatever is held for a fresh default loadout from the pool
+	WeaponHandling->ReleaseWeapon(EquippedWeapon);
+	SpawnStartTime = FPlatformTime::Seconds();
+	if ( bDefaultLoadoutReady ) { HandleDefaultWeaponSpawn(); }
+}
+
+
+/**
+ * @brief Moves the character in or out of the game mode's pawn pool.
+ *
+ * Pooled characters are hidden, have no collision, do not move, animate or tick, and hold no weapon.
+ * @param bInPooled Whether the character is being released to the pool.
+ */
+void ABelicaCharacter::SetPooled( const bool bInPooled ) {
+	bIsPooled = bInPooled;
+
+	SetActorHiddenInGame(bInPooled);
+	SetActorEnableCollision(!bInPooled);
+	GetMesh()->SetComponentTickEnabled(!bInPooled);
+
+	if ( bInPooled ) {
+		// Forget everything the character was doing before it was parked
+		EndWeaponFIre();
+		WeaponHandling->ResetHandlingState();
+		WeaponHandling->ReleaseWeapon(EquippedWeapon);
+		EquipableItem = nullptr;
+
+		GetCharacterMovement()->StopMovementImmediately();
+		GetCharacterMovement()->DisableMovement();
+	}
+	else { GetCharacterMovement()->SetDefaultMovementMode(); }
+
+	SetActorTickEnabled(!bInPooled);
+}
+
+
 /**
  * @brief Unequips the currently equipped weapon.
  *
  * Detaches the current weapon from the character and sets its state to unarmed.
+ * Clients ask the server, which drops the weapon and replicates the result.
  */
 void ABelicaCharacter::UnEquipWeapon() {
+	if ( !HasAuthority() ) {
+		ServerUnEquipWeapon();
+		return;
+	}
+
 	WeaponHandling->DropWeapon(EquippedWeapon);
 	EquippedWeapon = nullptr;
 	
@@ -192,6 +394,11 @@ void ABelicaCharacter::UnEquipWeapon() {
 }
 
 
+void ABelicaCharacter::ServerUnEquipWeapon_Implementation() {
+	UnEquipWeapon();
+}
+
+
 void ABelicaCharacter::StartAiming() {
 	WeaponHandling->SetIsAiming(true);
 }
@@ -204,26 +411,21 @@ void ABelicaCharacter::StopAiming() {
 
 void ABelicaCharacter::StartFIreWeapon()
 {
-	if(EquippedWeapon) {
+	LASTSHOOTER_SCOPE(StartFireWeapon);
+
+	if(EquippedWeapon && UWeaponHandlingComponent::IsFireDebugEnabled()) {
 		GEngine->AddOnScreenDebugMessage(5, 15.f, FColor::Red, TEXT("Equipped Weapon Name: ") + EquippedWeapon->GetName());
 	}
-	if (WeaponHandling->GetShouldFireWeapon() && WeaponHandling->GetIsArmed()) {
-		// Get the Barrel Socket from the character's mesh
-		const USkeletalMeshSocket* BarrelSocket = GetMesh()->GetSocketByName("SMG_Barrel");
-		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(GetMesh());
+	if (EquippedWeapon && WeaponHandling->GetShouldFireWeapon() && WeaponHandling->GetIsArmed()) {
+		// The equipped weapon resolved its muzzle when it was equipped
+		const FTransform MuzzleTransform = EquippedWeapon->GetMuzzleTransform();
 
 		// Play the weapon fire montage
 		PlayWeaponFireMontage();
 
-		// Fire the weapon
+		// Fire the weapon. The trace ignores this character and its weapon through params cached at equip time
 		FVector TraceEndLocation;
-
-		/* Actors to ignore by the weapon fire trace*/
-		TArray<AActor*> ActorsToIgnore;
-		ActorsToIgnore.Emplace(this);
-		ActorsToIgnore.Emplace(EquippedWeapon);
-		
-		WeaponHandling->FireWeapon(SocketTransform, SocketTransform.GetLocation(), TraceEndLocation, ActorsToIgnore);
+		WeaponHandling->FireWeapon(MuzzleTransform, MuzzleTransform.GetLocation(), TraceEndLocation);
 	}
 }
 
@@ -233,13 +435,20 @@ void ABelicaCharacter::EndWeaponFIre() {
 }
 
 
+/**
+ * @brief Gets the movement component as the predicted Belica movement.
+ * @return The movement component, which the constructor always creates as UBelicaMovementComponent.
+ */
+UBelicaMovementComponent* ABelicaCharacter::GetBelicaMovement() const { return CastChecked<UBelicaMovementComponent>(GetCharacterMovement()); }
+
+
 void ABelicaCharacter::ToggleRun() {
-	GetCharacterMovement()->MaxWalkSpeed = 900.0f;
+	GetBelicaMovement()->SetRequestedGait(EBelicaGait::Run);
 }
 
 
 void ABelicaCharacter::ToggleWalk() {
-	GetCharacterMovement()->MaxWalkSpeed = 300.0f;
+	GetBelicaMovement()->SetRequestedGait(EBelicaGait::Walk);
 }
 
 
@@ -253,9 +462,12 @@ void ABelicaCharacter::ToggleCrouch() {
 
 
 void ABelicaCharacter::OnOverlapBegin( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult ) {
+	LASTSHOOTER_SCOPE(BelicaOverlap);
+	CSV_CUSTOM_STAT(LastShooter, OverlapsProcessed, 1, ECsvCustomStatOp::Accumulate);
+
 	AItem* PickupItem = Cast<AItem>(OtherActor);
 
-	GEngine->AddOnScreenDebugMessage(1, 0.5f, FColor::Red, TEXT("Overlap Begin: ") + OtherActor->GetName());
+	if ( UWeaponHandlingComponent::IsFireDebugEnabled() ) { GEngine->AddOnScreenDebugMessage(1, 0.5f, FColor::Red, TEXT("Overlap Begin: ") + OtherActor->GetName()); }
 	if(PickupItem) {
 		EquipableItem = PickupItem;
 	}
@@ -263,5 +475,8 @@ void ABelicaCharacter::OnOverlapBegin( UPrimitiveComponent* OverlappedComponent,
 
 
 void ABelicaCharacter::OnOverlapEnd( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex ) {
+	LASTSHOOTER_SCOPE(BelicaOverlap);
+	CSV_CUSTOM_STAT(LastShooter, OverlapsProcessed, 1, ECsvCustomStatOp::Accumulate);
+
 	EquipableItem = nullptr;
 }
\ No newline at end of file
@@ -16,10 +16,12 @@
 #include "BelicaCharacter.generated.h"
 
 class USphereComponent;
+class USkeletalMeshSocket;
 class AWeapon;
 class UWeaponHandlingComponent;
 class USpringArmComponent;
 class UCameraComponent;
+class UBelicaMovementComponent;
 class AItem;
 
 /**
@@ -51,8 +53,11 @@ public:
 	 * 2. Weapon handling for combat mechanics
 	 * 3. Pickup sphere for item interaction
 	 * 4. Default movement and input settings
+	 *
+	 * Replaces the movement component with UBelicaMovementComponent so gait changes are predicted.
+	 * @param ObjectInitializer The initializer used to override the default subobject classes.
 	 */
-	ABelicaCharacter();
+	explicit ABelicaCharacter(const FObjectInitializer& ObjectInitializer);
 
 protected:
 	/**
@@ -85,25 +90,101 @@ protected:
 	 * @brief Initializes the character's starting loadout and systems.
 	 * 
 	 * Called at game start to:
-	 * 1. Initialize core character systems
-	 * 2. Spawn and equip default weapons
+	 * 1. Bind the pickup sphere overlap events
+	 * 2. Equip the default weapon if its assets finished loading during spawn
 	 * 3. Set up initial player state
 	 */
 	virtual void BeginPlay() override;
 
+	/**
+	 * @brief Resolves the mesh sockets and starts the default loadout preload.
+	 * 
+	 * Looks up the right-hand weapon socket by name a single time so equipping
+	 * never hashes socket names again, and begins loading the default weapon
+	 * asynchronously while the pawn is still being spawned.
+	 */
+	virtual void PostInitializeComponents() override;
+
+	/**
+	 * @brief Arms the character as soon as the default loadout has loaded.
+	 * 
+	 * Equips straight away if play has begun, otherwise BeginPlay picks it up.
+	 */
+	void OnDefaultLoadoutLoaded();
+
+	/**
+	 * @brief Re-evaluates cosmetic tick registration whenever the controller changes.
+	 * 
+	 * Fires on the server when possessed or unpossessed and on clients when the
+	 * replicated controller arrives, so AI pawns and simulated proxies drop their
+	 * cosmetic work while the pawn the local player views through keeps it.
+	 */
+	virtual void NotifyControllerChanged() override;
+
+	/**
+	 * @brief Mirrors the weapon the server equipped or dropped on this client.
+	 * 
+	 * Attaches the weapon to the right hand and hands it to the weapon handling component, so the
+	 * client fires with the same muzzle, pellets and archetype the server traces with.
+	 * 
+	 * @param PreviousWeapon The weapon held before the change, or nullptr.
+	 */
+	UFUNCTION()
+	void OnRep_EquippedWeapon(AWeapon* PreviousWeapon);
+
+	/**
+	 * @brief Asks the server to equip a weapon in pickup range.
+	 * @param Weapon The weapon the client's pickup sphere overlaps.
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerEquipWeapon(AWeapon* Weapon);
+
+	/**
+	 * @brief Asks the server to drop the equipped weapon.
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerUnEquipWeapon();
+
+	/**
+	 * @brief Equips a weapon lying in pickup range. Server only.
+	 * 
+	 * The weapon must be lying in the world within MaxPickupDistance, so a client can neither take a weapon
+	 * someone else holds nor one out of reach.
+	 * 
+	 * @param Weapon The weapon to pick up.
+	 */
+	void EquipPickedUpWeapon(AWeapon* Weapon);
+
 public:
 	/**
-	 * @brief Updates character systems and state each frame.
+	 * @brief Replicates the equipped weapon to every client.
+	 * @param OutLifetimeProps The replicated properties of the class.
+	 */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/**
+	 * @brief Updates the cosmetic character systems each frame.
 	 * 
-	 * Handles continuous updates for:
+	 * The actor tick runs for every instance so Blueprint Tick keeps working on AI and
+	 * server proxies. The C++ cosmetic work only runs for the pawn the local player views through:
 	 * - Crosshair spread calculations based on movement and state
-	 * - Weapon positioning and animations
-	 * - Camera smoothing and transitions
+	 * - Camera field of view transitions
+	 * 
+	 * Authoritative per-frame simulation (movement, fire timing) is driven by the
+	 * movement and weapon handling components and keeps running for every instance.
 	 * 
 	 * @param DeltaTime Time elapsed since last frame, used for smooth interpolation
 	 */
 	virtual void Tick( float DeltaTime ) override;
 
+	/**
+	 * @brief Enables or disables the cosmetic per-frame work for this pawn.
+	 * 
+	 * Registers the weapon handling cosmetic work only when the pawn is locally and
+	 * player controlled. Every other instance skips it inside Tick.
+	 */
+	void RefreshCosmeticTickRegistration();
+
 	/**
 	 * @brief Triggers weapon fire animation sequence.
 	 * 
@@ -135,12 +216,14 @@ public:
 	 * 1. Spawns default weapon
 	 * 2. Attaches to correct socket
 	 * 3. Initializes weapon state
+	 * 4. Records the time it took to arm since spawn
 	 */
 	void HandleDefaultWeaponSpawn();
 
 	/**
 	 * @brief Manages the weapon equip process.
 	 * 
+	 * Runs on the server, which clients ask through ServerEquipWeapon. The result reaches clients through OnRep_EquippedWeapon.
 	 * Coordinates the sequence of events when equipping a weapon:
 	 * 1. Unequips current weapon if necessary
 	 * 2. Plays equip animation
@@ -152,6 +235,7 @@ public:
 	/**
 	 * @brief Manages the weapon unequip process.
 	 * 
+	 * Runs on the server, which clients ask through ServerUnEquipWeapon. The result reaches clients through OnRep_EquippedWeapon.
 	 * Handles proper cleanup when unequipping weapons:
 	 * 1. Plays unequip animation
 	 * 2. Detaches weapon
@@ -160,6 +244,41 @@ public:
 	 */
 	void UnEquipWeapon();
 
+	/**
+	 * @brief Resets the character in place for a new round or life without destroying it.
+	 * 
+	 * 1. Stops firing, crouching and any movement and clears the weapon handling state
+	 * 2. Restores the default walk speed
+	 * 3. Teleports to the spawn transform and faces its direction
+	 * 4. Returns the held weapon to the item pool and re-arms with the default loadout
+	 * 
+	 * @param SpawnTransform Where the character respawns.
+	 */
+	void ResetForRespawn(const FTransform& SpawnTransform);
+
+	/**
+	 * @brief Moves the character in or out of the game mode's pawn pool.
+	 * 
+	 * Pooled characters stay in the world hidden, without collision, movement, animation or ticking, and
+	 * return their weapon to the item pool. Leaving the pool only re-enables the actor; the game mode resets
+	 * it for its spawn point and the controller re-enables the cosmetic work when it possesses it.
+	 * 
+	 * @param bInPooled Whether the character is being released to the pool.
+	 */
+	void SetPooled(bool bInPooled);
+
+	/**
+	 * @brief Gets whether the character is parked in the pawn pool.
+	 * @return True if the character is pooled, false otherwise.
+	 */
+	FORCEINLINE bool IsPooled() const { return bIsPooled; }
+
+	/**
+	 * @brief Gets the movement component as the predicted Belica movement.
+	 * @return The movement component.
+	 */
+	UBelicaMovementComponent* GetBelicaMovement() const;
+
 	// State management functions
 	void StartAiming();
 	void StopAiming();
@@ -248,8 +367,10 @@ private:
 	 * - Handle animations
 	 * - Process input
 	 * - Update UI
+	 * 
+	 * Only the server changes it. Clients follow through OnRep_EquippedWeapon.
 	 */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_EquippedWeapon, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	AWeapon* EquippedWeapon;
 
 	/**
@@ -263,6 +384,44 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	AItem* EquipableItem;
 
+	/**
+	 * @brief How far from the pawn a weapon may be for the server to accept picking it up.
+	 * 
+	 * Covers the pickup sphere, the item's own overlap sphere and the movement of the pawn while the request travels.
+	 */
+	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float MaxPickupDistance = 400.f;
+
+	/**
+	 * @brief Socket the equipped weapon is attached to.
+	 * 
+	 * Resolved once in PostInitializeComponents. Owned by the skeletal mesh asset.
+	 */
+	const USkeletalMeshSocket* RightHandWeaponSocket = nullptr;
+
+	/**
+	 * @brief True once the default weapon class and its assets are loaded.
+	 */
+	bool bDefaultLoadoutReady = false;
+
+	/**
+	 * @brief True while the character is parked in the pawn pool.
+	 */
+	bool bIsPooled = false;
+
+	/**
+	 * @brief Platform time at which this pawn started spawning.
+	 */
+	double SpawnStartTime = 0.0;
+
+	/**
+	 * @brief Seconds from spawn until the default loadout was equipped.
+	 * 
+	 * Also published as the STAT_TimeToArmed stat.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float TimeToArmed = 0.f;
+
 public:
 	/**
 	 * @brief Provides access to weapon handling systems.
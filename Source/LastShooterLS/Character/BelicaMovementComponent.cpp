@@ -0,0 +1,131 @@
+/**
+ * @file BelicaMovementComponent.cpp
+ * @brief This file contains the implementation of the UBelicaMovementComponent class.
+ */
+
+#include "BelicaMovementComponent.h"
+
+#include "GameFramework/Character.h"
+
+/** The compressed flag set while running. */
+static constexpr uint8 FLAG_Run = FSavedMove_Character::FLAG_Custom_0;
+
+/** The compressed flag set while walking. */
+static constexpr uint8 FLAG_Walk = FSavedMove_Character::FLAG_Custom_1;
+
+
+UBelicaMovementComponent::UBelicaMovementComponent() : RunSpeed(900.f), WalkSpeed(300.f) {}
+
+
+/**
+ * @brief Requests a gait.
+ * @param NewGait The gait to move at.
+ */
+void UBelicaMovementComponent::SetRequestedGait( const EBelicaGait NewGait ) { RequestedGait = NewGait; }
+
+
+/**
+ * @brief Gets the maximum speed for the current movement mode, taking the requested gait into account.
+ * Crouching keeps its own speed whatever the gait.
+ * @return The maximum speed.
+ */
+float UBelicaMovementComponent::GetMaxSpeed() const {
+	if ( (MovementMode == MOVE_Walking || MovementMode == MOVE_NavWalking) && !IsCrouching() ) {
+		switch ( RequestedGait ) {
+		case EBelicaGait::Run: return RunSpeed;
+		case EBelicaGait::Walk: return WalkSpeed;
+		default: break;
+		}
+	}
+
+	return Super::GetMaxSpeed();
+}
+
+
+FNetworkPredictionData_Client* UBelicaMovementComponent::GetPredictionData_Client() const {
+	if ( ClientPredictionData == nullptr ) {
+		UBelicaMovementComponent* MutableThis = const_cast<UBelicaMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Belica(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+
+/**
+ * @brief Restores the requested gait from the flags of a move.
+ * @param Flags The compressed flags of the move.
+ */
+void UBelicaMovementComponent::UpdateFromCompressedFlags( const uint8 Flags ) {
+	Super::UpdateFromCompressedFlags(Flags);
+
+	RequestedGait = GetGaitFromFlags(Flags);
+}
+
+
+/**
+ * @brief Reads the gait a move was made at from its compressed flags.
+ * @param Flags The compressed flags of the move.
+ * @return The gait packed by FSavedMove_Belica::GetCompressedFlags.
+ */
+EBelicaGait UBelicaMovementComponent::GetGaitFromFlags( const uint8 Flags ) {
+	return (Flags & FLAG_Run) ? EBelicaGait::Run : (Flags & FLAG_Walk) ? EBelicaGait::Walk : EBelicaGait::Default;
+}
+
+
+void FSavedMove_Belica::Clear() {
+	Super::Clear();
+
+	SavedGait = EBelicaGait::Default;
+}
+
+
+/**
+ * @brief Packs the requested gait into the custom flags next to the engine's own.
+ * @return The compressed flags of the move.
+ */
+uint8 FSavedMove_Belica::GetCompressedFlags() const {
+	uint8 Flags = Super::GetCompressedFlags();
+
+	if ( SavedGait == EBelicaGait::Run ) { Flags |= FLAG_Run; }
+	else if ( SavedGait == EBelicaGait::Walk ) { Flags |= FLAG_Walk; }
+
+	return Flags;
+}
+
+
+/**
+ * @brief Moves can only be combined while the gait stays the same.
+ * @param NewMove The move to combine with.
+ * @param InCharacter The character that made the moves.
+ * @param MaxDelta The longest combined move.
+ * @return True if the moves can be combined, false otherwise.
+ */
+bool FSavedMove_Belica::CanCombineWith( const FSavedMovePtr& NewMove, ACharacter* InCharacter, const float MaxDelta ) const {
+	if ( SavedGait != static_cast<const FSavedMove_Belica*>(NewMove.Get())->SavedGait ) { return false; }
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+
+/**
+ * @brief Records the requested gait with the move.
+ */
+void FSavedMove_Belica::SetMoveFor( ACharacter* C, const float InDeltaTime, const FVector& NewAccel, FNetworkPredictionData_Client_Character& ClientData ) {
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	if ( const UBelicaMovementComponent* Movement = Cast<UBelicaMovementComponent>(C->GetCharacterMovement()) ) { SavedGait = Movement->GetRequestedGait(); }
+}
+
+
+/**
+ * @brief Restores the requested gait before the move is replayed after a correction.
+ */
+void FSavedMove_Belica::PrepMoveFor( ACharacter* C ) {
+	Super::PrepMoveFor(C);
+
+	if ( UBelicaMovementComponent* Movement = Cast<UBelicaMovementComponent>(C->GetCharacterMovement()) ) { Movement->SetRequestedGait(SavedGait); }
+}
+
+
+FSavedMovePtr FNetworkPredictionData_Client_Belica::AllocateNewMove() { return MakeShared<FSavedMove_Belica>(); }
@@ -0,0 +1,126 @@
+/**
+ * @file BelicaMovementComponent.h
+ * @brief This file contains the declaration of the UBelicaMovementComponent class.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "BelicaMovementComponent.generated.h"
+
+/**
+ * @enum EBelicaGait
+ * @brief The pace Belica moves at on the ground.
+ */
+UENUM(BlueprintType)
+enum class EBelicaGait : uint8
+{
+	/** The configured MaxWalkSpeed. */
+	Default,
+	/** RunSpeed. */
+	Run,
+	/** WalkSpeed. */
+	Walk,
+};
+
+/**
+ * @class UBelicaMovementComponent
+ * @brief Character movement that predicts Belica's run and walk toggles.
+ *
+ * The requested gait travels as custom compressed flags inside every saved move, so the owning client applies it
+ * immediately, the server replays it on the same move and neither side corrects the other. Crouching already
+ * travels the same way through the engine's FLAG_WantsToCrouch.
+ */
+UCLASS()
+class LASTSHOOTERLS_API UBelicaMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	UBelicaMovementComponent();
+
+	/**
+	 * @brief Requests a gait. Call on the owning client or in a standalone game; the server receives it with the next move.
+	 * @param NewGait The gait to move at.
+	 */
+	void SetRequestedGait(EBelicaGait NewGait);
+
+	/**
+	 * @brief Gets the requested gait.
+	 * @return The gait the character moves at while walking.
+	 */
+	FORCEINLINE EBelicaGait GetRequestedGait() const { return RequestedGait; }
+
+	/**
+	 * @brief Gets the maximum speed for the current movement mode, taking the requested gait into account.
+	 * @return The maximum speed.
+	 */
+	virtual float GetMaxSpeed() const override;
+
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	/**
+	 * @brief Reads the gait a move was made at from its compressed flags.
+	 * @param Flags The compressed flags of the move.
+	 * @return The gait packed by FSavedMove_Belica::GetCompressedFlags.
+	 */
+	static EBelicaGait GetGaitFromFlags(uint8 Flags);
+
+protected:
+	/**
+	 * @brief Restores the requested gait from the flags of a move.
+	 * @param Flags The compressed flags of the move.
+	 */
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+
+private:
+	/** The gait the character moves at while walking. */
+	EBelicaGait RequestedGait = EBelicaGait::Default;
+
+	/** The maximum speed while running. */
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Walking", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "cm/s", AllowPrivateAccess = "true"))
+	float RunSpeed;
+
+	/** The maximum speed while walking. */
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Walking", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "cm/s", AllowPrivateAccess = "true"))
+	float WalkSpeed;
+};
+
+/**
+ * @class FSavedMove_Belica
+ * @brief A saved move that also records the requested gait.
+ */
+class FSavedMove_Belica : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	virtual void Clear() override;
+
+	virtual uint8 GetCompressedFlags() const override;
+
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, const FVector& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+
+	virtual void PrepMoveFor(ACharacter* C) override;
+
+private:
+	/** The gait requested when the move was made. */
+	EBelicaGait SavedGait = EBelicaGait::Default;
+};
+
+/**
+ * @class FNetworkPredictionData_Client_Belica
+ * @brief Client prediction data that allocates FSavedMove_Belica.
+ */
+class FNetworkPredictionData_Client_Belica : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	explicit FNetworkPredictionData_Client_Belica(const UCharacterMovementComponent& ClientMovement) : Super(ClientMovement) {}
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
@@ -0,0 +1,85 @@
+/**
+ * @file BelicaMovementTests.cpp
+ * @brief This file contains the automation tests of the UBelicaMovementComponent class.
+ */
+
+#include "LastShooterLS/Character/BelicaCharacter.h"
+#include "LastShooterLS/Character/BelicaMovementComponent.h"
+#include "WorldItemsModule/Testing/Public/GameplayTestWorld.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BelicaMovementTests
+{
+	/** The length of one client move. */
+	constexpr float MoveSeconds = 1.f / 60.f;
+
+	/**
+	 * @struct FTestWorld
+	 * @brief A standalone game world that has begun play, with a helper to spawn Belicas in it.
+	 */
+	struct FTestWorld : FGameplayTestWorld
+	{
+		/**
+		 * @brief Spawns a walking Belica.
+		 * @param Location Where the character stands.
+		 * @return The character.
+		 */
+		ABelicaCharacter* SpawnWalkingCharacter(const FVector& Location) const
+		{
+			ABelicaCharacter* Character = World->SpawnActor<ABelicaCharacter>(Location, FRotator::ZeroRotator);
+			if ( Character ) { Character->GetCharacterMovement()->SetMovementMode(MOVE_Walking); }
+			return Character;
+		}
+	};
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBelicaGaitSavedMoveTest, "LastShooter.Character.Movement.GaitSavedMove", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Checks that the gait survives the compressed flags, keeps the engine's flags intact and splits combined moves.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FBelicaGaitSavedMoveTest::RunTest( const FString& Parameters ) {
+	using namespace BelicaMovementTests;
+
+	FTestWorld TestWorld;
+	ABelicaCharacter* Character = TestWorld.SpawnWalkingCharacter(FVector(0.0, 0.0, 100.0));
+	if ( !TestNotNull(TEXT("The character is spawned"), Character) ) { return false; }
+
+	UBelicaMovementComponent* Movement = Character->GetBelicaMovement();
+	FNetworkPredictionData_Client_Character* ClientData = Movement->GetPredictionData_Client_Character();
+
+	TSharedPtr<FSavedMove_Belica> Moves[3];
+	const EBelicaGait Gaits[3] = { EBelicaGait::Default, EBelicaGait::Run, EBelicaGait::Walk };
+	for ( int32 Index = 0; Index < 3; ++Index ) {
+		Movement->SetRequestedGait(Gaits[Index]);
+		Movement->bWantsToCrouch = Index == 2;
+		Moves[Index] = MakeShared<FSavedMove_Belica>();
+		Moves[Index]->SetMoveFor(Character, MoveSeconds, FVector::ZeroVector, *ClientData);
+
+		const uint8 Flags = Moves[Index]->GetCompressedFlags();
+		TestEqual(FString::Printf(TEXT("Gait %d survives the flags"), Index), UBelicaMovementComponent::GetGaitFromFlags(Flags), Gaits[Index]);
+		TestEqual(FString::Printf(TEXT("Gait %d leaves the crouch flag alone"), Index), (Flags & FSavedMove_Character::FLAG_WantsToCrouch) != 0, Index == 2);
+	}
+	Movement->bWantsToCrouch = false;
+
+	TestFalse(TEXT("A run move is not combined into a default one"), Moves[0]->CanCombineWith(Moves[1], Character, 1.f));
+	TestFalse(TEXT("A walk move is not combined into a run one"), Moves[1]->CanCombineWith(Moves[2], Character, 1.f));
+
+	// A correction replays the saved moves, which must bring back the gait each was made at
+	Movement->SetRequestedGait(EBelicaGait::Default);
+	Moves[1]->PrepMoveFor(Character);
+	TestEqual(TEXT("Replaying a run move runs"), Movement->GetRequestedGait(), EBelicaGait::Run);
+	TestTrue(TEXT("Running is faster than the default"), Movement->GetMaxSpeed() > Movement->MaxWalkSpeed);
+	Moves[2]->PrepMoveFor(Character);
+	TestTrue(TEXT("Walking is slower than the default"), Movement->GetMaxSpeed() < Movement->MaxWalkSpeed);
+
+	return true;
+}
+
+#endif
@@ -9,6 +9,10 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingComponent.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBelicaInput, Log, All);
 
 /**
  * @brief Called when the controller possesses a pawn.
@@ -26,6 +30,11 @@ void ABelicaController::OnPossess( APawn* aPawn ) {
 	// Cast the possessed pawn to ABelicaCharacter
 	Belica = Cast<ABelicaCharacter>(aPawn);
 
+	InitializeInputRecording();
+
+	// A replay drives the handlers itself, live input must not interfere
+	if ( InputRecordingMode == EInputRecordingMode::Replaying ) { return; }
+
 	// Get the EnhancedInputComponent from the InputComponent
 	EnhancedInputComponent = Cast<UEnhancedInputComponent>(InputComponent);
 	checkf(EnhancedInputComponent, TEXT("Enhanced Input component is valid"));
@@ -33,6 +42,9 @@ void ABelicaController::OnPossess( APawn* aPawn ) {
 	// Add the BelicaMappingContext to the EnhancedInputLocalPlayerSubsystem
 	if ( UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(GetLocalPlayer()) ) { Subsystem->AddMappingContext(BelicaMappingContext, 0); }
 
+	// A respawned pawn is possessed again by the same controller, the bindings of its last life must not stack up
+	EnhancedInputComponent->ClearActionBindings();
+
 	// Bind input actions to their respective methods
 	EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &ABelicaController::Move);
 	EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Triggered, this, &ABelicaController::HandleLookAndAiming);
@@ -60,19 +72,173 @@ void ABelicaController::OnPossess( APawn* aPawn ) {
  * the base class's OnUnPossess method.
  */
 void ABelicaController::OnUnPossess() {
+	// A dead or spectating player has no pawn to drive, the mapping context is added back on the next possession
+	if ( UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(GetLocalPlayer()) ) { Subsystem->RemoveMappingContext(BelicaMappingContext); }
+
+	Belica = nullptr;
+
 	// Call the base class's OnUnPossess method
 	Super::OnUnPossess();
 }
 
+/**
+ * @brief Called every frame to process the player's input.
+ * 
+ * This function is invoked every frame before Tick. Live input handlers run inside
+ * Super::PlayerTick, so the recorded events of the current frame are dispatched just
+ * before it, and the pawn moves on them in the same frame they were recorded in.
+ * 
+ * @param DeltaTime The time elapsed since the last frame.
+ */
+void ABelicaController::PlayerTick( float DeltaTime ) {
+	if ( InputRecordingMode == EInputRecordingMode::Replaying ) { ReplayInputFrame(); }
+
+	Super::PlayerTick(DeltaTime);
+}
+
 /**
  * @brief Called every frame to update the controller.
  * 
- * This function is invoked every frame. It updates the field of view based on the
- * character's weapon handling.
+ * This function is invoked every frame, after PlayerTick. It advances the input
+ * recording frame.
  * 
  * @param DeltaTime The time elapsed since the last frame.
  */
-void ABelicaController::Tick( float DeltaTime ) { Super::Tick(DeltaTime); }
+void ABelicaController::Tick( float DeltaTime ) {
+	Super::Tick(DeltaTime);
+
+	if ( InputRecordingMode == EInputRecordingMode::None ) { return; }
+
+	// Recorded and replayed events both run in PlayerTick, before this, so they share the frame index
+	++InputRecordingFrame;
+}
+
+/**
+ * @brief Called when the controller is removed from play.
+ * 
+ * Writes the input recording to disk if one is being recorded.
+ * 
+ * @param EndPlayReason The reason play ended.
+ */
+void ABelicaController::EndPlay( const EEndPlayReason::Type EndPlayReason ) {
+	if ( InputRecordingMode == EInputRecordingMode::Recording ) {
+		InputRecording.NumFrames = InputRecordingFrame;
+		if ( InputRecording.Save(InputRecordingPath) ) {
+			UE_LOG(LogBelicaInput, Display, TEXT("Recorded %d input events over %u frames to %s"), InputRecording.Events.Num(), InputRecording.NumFrames, *InputRecordingPath);
+		}
+		else { UE_LOG(LogBelicaInput, Error, TEXT("Failed to write input recording %s"), *InputRecordingPath); }
+		InputRecordingMode = EInputRecordingMode::None;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+/**
+ * @brief Starts recording or replaying input if requested on the command line.
+ * 
+ * Only the first possession of a local controller is considered. Both modes switch the engine to a
+ * fixed timestep so frame N of a replay consumes exactly the input of frame N of the recording.
+ */
+void ABelicaController::InitializeInputRecording() {
+	if ( bInputRecordingInitialized || !IsLocalController() ) { return; }
+	bInputRecordingInitialized = true;
+
+	FString RecordingName;
+	if ( FParse::Value(FCommandLine::Get(), TEXT("ReplayInput="), RecordingName) ) {
+		InputRecordingPath = FBelicaInputRecording::ResolvePath(RecordingName);
+		if ( !InputRecording.Load(InputRecordingPath) ) {
+			UE_LOG(LogBelicaInput, Error, TEXT("Failed to read input recording %s"), *InputRecordingPath);
+			return;
+		}
+		InputRecordingMode = EInputRecordingMode::Replaying;
+	}
+	else if ( FParse::Value(FCommandLine::Get(), TEXT("RecordInput="), RecordingName) ) {
+		float InputFPS = 60.f;
+		FParse::Value(FCommandLine::Get(), TEXT("RecordInputFPS="), InputFPS);
+
+		InputRecordingPath = FBelicaInputRecording::ResolvePath(RecordingName);
+		InputRecording.FixedDeltaTime = 1.f / FMath::Max(InputFPS, 1.f);
+		InputRecordingMode = EInputRecordingMode::Recording;
+	}
+	else { return; }
+
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(InputRecording.FixedDeltaTime);
+
+	UE_LOG(LogBelicaInput, Display, TEXT("%s input %s at %.1f fps"), InputRecordingMode == EInputRecordingMode::Recording ? TEXT("Recording") : TEXT("Replaying"),
+		*InputRecordingPath, 1.f / InputRecording.FixedDeltaTime);
+}
+
+/**
+ * @brief Appends a handler invocation to the recording for the current frame.
+ * 
+ * @param Action The action that fired.
+ * @param Value The axis value of Move and Look.
+ */
+void ABelicaController::RecordInput( const EBelicaInputAction Action, const FVector2D& Value ) {
+	if ( InputRecordingMode != EInputRecordingMode::Recording ) { return; }
+
+	FBelicaInputEvent& Event = InputRecording.Events.AddDefaulted_GetRef();
+	Event.Frame = InputRecordingFrame;
+	Event.Action = Action;
+	Event.Value = FVector2f(Value);
+}
+
+/**
+ * @brief Dispatches every recorded event of the current frame to its handler.
+ * 
+ * Requests exit once every recorded frame has been played out.
+ */
+void ABelicaController::ReplayInputFrame() {
+	const TArray<FBelicaInputEvent>& Events = InputRecording.Events;
+	while ( Events.IsValidIndex(ReplayEventIndex) && Events[ReplayEventIndex].Frame <= InputRecordingFrame ) {
+		DispatchInputEvent(Events[ReplayEventIndex]);
+		++ReplayEventIndex;
+	}
+
+	if ( InputRecordingFrame + 1 >= InputRecording.NumFrames ) {
+		UE_LOG(LogBelicaInput, Display, TEXT("Replayed %d input events over %u frames from %s"), Events.Num(), InputRecording.NumFrames, *InputRecordingPath);
+		InputRecordingMode = EInputRecordingMode::None;
+		FPlatformMisc::RequestExit(false, TEXT("ReplayInput"));
+	}
+}
+
+/**
+ * @brief Calls the handler of a recorded event.
+ * 
+ * @param Event The event to dispatch.
+ */
+void ABelicaController::DispatchInputEvent( const FBelicaInputEvent& Event ) {
+	if ( Belica == nullptr ) { return; }
+
+	switch ( Event.Action ) {
+	case EBelicaInputAction::Move: Move(FInputActionValue(FVector2D(Event.Value)));
+		break;
+	case EBelicaInputAction::Look: HandleLookAndAiming(FInputActionValue(FVector2D(Event.Value)));
+		break;
+	case EBelicaInputAction::Jump: Jump();
+		break;
+	case EBelicaInputAction::FireStart: HandleFireWeaponStart();
+		break;
+	case EBelicaInputAction::FireEnd: HandleFireWeaponEnd();
+		break;
+	case EBelicaInputAction::AimStart: HandleAimStart();
+		break;
+	case EBelicaInputAction::AimEnd: HandleAimEnd();
+		break;
+	case EBelicaInputAction::Equip: HandleWeaponEquip();
+		break;
+	case EBelicaInputAction::Unequip: WeaponUnequip();
+		break;
+	case EBelicaInputAction::Run: HandleRun();
+		break;
+	case EBelicaInputAction::Walk: HandleWalk();
+		break;
+	case EBelicaInputAction::Crouch: HandleCrouch();
+		break;
+	default: break;
+	}
+}
 
 /**
  * @brief Called when the Move action is triggered.
@@ -85,6 +251,7 @@ void ABelicaController::Tick( float DeltaTime ) { Super::Tick(DeltaTime); }
 void ABelicaController::Move( const FInputActionValue& Value ) {
 	// Get the movement vector from the input value
 	FVector2D MovementVector = Value.Get<FVector2D>();
+	RecordInput(EBelicaInputAction::Move, MovementVector);
 
 	// Add movement input in the forward and right directions
 	Belica->AddMovementInput(Belica->GetActorForwardVector(), MovementVector.Y);
@@ -103,6 +270,7 @@ void ABelicaController::Move( const FInputActionValue& Value ) {
 void ABelicaController::HandleLookAndAiming( const FInputActionValue& Value ) {
 	// Get the look axis value from the input value
 	const FVector2D LookAxisValue = Value.Get<FVector2D>();
+	RecordInput(EBelicaInputAction::Look, LookAxisValue);
 
 	// Add yaw and pitch input based on the look axis value
 	if ( Belica->GetWeaponHandling()->GetIsAiming() ) {
@@ -121,6 +289,8 @@ void ABelicaController::HandleLookAndAiming( const FInputActionValue& Value ) {
  * This function is invoked when the Jump action is triggered. It makes the character jump.
  */
 void ABelicaController::Jump() {
+	RecordInput(EBelicaInputAction::Jump);
+
 	// Make the character jump
 	Belica->Jump();
 }
@@ -131,7 +301,10 @@ void ABelicaController::Jump() {
  * This function is invoked when the ExecuteFireWeapon action is triggered. It handles starting
  * the weapon firing process, including playing the fire montage and setting the fire timer.
  */
-void ABelicaController::HandleFireWeaponStart() { Belica->StartFIreWeapon(); }
+void ABelicaController::HandleFireWeaponStart() {
+	RecordInput(EBelicaInputAction::FireStart);
+	Belica->StartFIreWeapon();
+}
 
 /**
  * @brief Called when the FireWeapon action ends.
@@ -139,28 +312,52 @@ void ABelicaController::HandleFireWeaponStart() { Belica->StartFIreWeapon(); }
  * This function is invoked when the ExecuteFireWeapon action is completed. It updates the weapon's
  * firing status to allow for re-triggering.
  */
-void ABelicaController::HandleFireWeaponEnd() { Belica->EndWeaponFIre(); }
+void ABelicaController::HandleFireWeaponEnd() {
+	RecordInput(EBelicaInputAction::FireEnd);
+	Belica->EndWeaponFIre();
+}
 
 /**
  * @brief Called when the Aim action is started.
  * 
  * This function is invoked when the Aim action is started. It sets the aiming status to true.
  */
-void ABelicaController::HandleAimStart() { Belica->StartAiming(); }
+void ABelicaController::HandleAimStart() {
+	RecordInput(EBelicaInputAction::AimStart);
+	Belica->StartAiming();
+}
 
 /**
  * @brief Called when the Aim action is ended.
  * 
  * This function is invoked when the Aim action is completed. It sets the aiming status to false.
  */
-void ABelicaController::HandleAimEnd() { Belica->StopAiming(); }
+void ABelicaController::HandleAimEnd() {
+	RecordInput(EBelicaInputAction::AimEnd);
+	Belica->StopAiming();
+}
 
-void ABelicaController::HandleWeaponEquip() { Belica->HandleEquipWeapon(); }
+void ABelicaController::HandleWeaponEquip() {
+	RecordInput(EBelicaInputAction::Equip);
+	Belica->HandleEquipWeapon();
+}
 
-void ABelicaController::WeaponUnequip() { Belica->UnEquipWeapon(); }
+void ABelicaController::WeaponUnequip() {
+	RecordInput(EBelicaInputAction::Unequip);
+	Belica->UnEquipWeapon();
+}
 
-void ABelicaController::HandleRun() { Belica->ToggleRun(); }
+void ABelicaController::HandleRun() {
+	RecordInput(EBelicaInputAction::Run);
+	Belica->ToggleRun();
+}
 
-void ABelicaController::HandleWalk() { Belica->ToggleWalk(); }
+void ABelicaController::HandleWalk() {
+	RecordInput(EBelicaInputAction::Walk);
+	Belica->ToggleWalk();
+}
 
-void ABelicaController::HandleCrouch() { Belica->ToggleCrouch(); }
+void ABelicaController::HandleCrouch() {
+	RecordInput(EBelicaInputAction::Crouch);
+	Belica->ToggleCrouch();
+}
@@ -8,6 +8,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
 #include "InputActionValue.h"
+#include "BelicaInputRecording.h"
 #include "BelicaController.generated.h"
 
 class UInputAction;
@@ -19,6 +20,10 @@ class ABelicaCharacter;
  *
  * It inherits from the APlayerController class and overrides the OnPossess and OnUnPossess methods.
  * It also defines methods for handling movement, looking, jumping, and firing a weapon.
+ *
+ * Every handler can be recorded to and replayed from an FBelicaInputRecording under a fixed timestep:
+ * -RecordInput=Name records the local player's session, -ReplayInput=Name feeds a recording back into the
+ * same handlers instead of live input and exits once it has been played out.
  */
 UCLASS()
 class LASTSHOOTERLS_API ABelicaController : public APlayerController
@@ -40,20 +45,39 @@ protected:
 	/**
 	 * @brief Called when the controller unpossesses a pawn.
 	 * 
-	 * This function is called when the controller releases control of a pawn. It performs
-	 * necessary clean-up by calling the base class's OnUnPossess method.
+	 * This function is called when the controller releases control of a pawn. It removes
+	 * the input mapping context and forgets the pawn, so a respawn can bind them again.
 	 */
 	virtual void OnUnPossess() override;
 
+	/**
+	 * @brief Called every frame to process the player's input.
+	 * 
+	 * This function replays the recorded input of the current frame before the live input
+	 * is processed, so replayed events run where the recorded ones did.
+	 * 
+	 * @param DeltaTime The time elapsed since the last frame.
+	 */
+	virtual void PlayerTick(float DeltaTime) override;
+
 	/**
 	 * @brief Called every frame to update the controller.
 	 * 
-	 * This function is called every frame. It updates the field of view based on the
-	 * character's weapon handling.
+	 * This function is called every frame, after PlayerTick. It advances the input
+	 * recording frame.
 	 * 
 	 * @param DeltaTime The time elapsed since the last frame.
 	 */
 	virtual void Tick(float DeltaTime) override;	
+
+	/**
+	 * @brief Called when the controller is removed from play.
+	 * 
+	 * Writes the input recording to disk if one is being recorded.
+	 * 
+	 * @param EndPlayReason The reason play ended.
+	 */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 public:
 	/**
@@ -125,6 +149,60 @@ public:
 	void HandleCrouch();
 
 private:
+	/** Whether the handlers are being recorded or fed from a recording. */
+	enum class EInputRecordingMode : uint8
+	{
+		None,
+		Recording,
+		Replaying
+	};
+
+	/**
+	 * @brief Starts recording or replaying input if requested on the command line.
+	 * 
+	 * Only the first possession of a local controller is considered. Both modes switch the engine to a
+	 * fixed timestep so frame N of a replay consumes exactly the input of frame N of the recording.
+	 */
+	void InitializeInputRecording();
+
+	/**
+	 * @brief Appends a handler invocation to the recording for the current frame.
+	 * 
+	 * @param Action The action that fired.
+	 * @param Value The axis value of Move and Look.
+	 */
+	void RecordInput(EBelicaInputAction Action, const FVector2D& Value = FVector2D::ZeroVector);
+
+	/**
+	 * @brief Dispatches every recorded event of the current frame to its handler.
+	 */
+	void ReplayInputFrame();
+
+	/**
+	 * @brief Calls the handler of a recorded event.
+	 * 
+	 * @param Event The event to dispatch.
+	 */
+	void DispatchInputEvent(const FBelicaInputEvent& Event);
+
+	/** The current input recording mode. */
+	EInputRecordingMode InputRecordingMode = EInputRecordingMode::None;
+
+	/** Whether the command line has been checked for an input recording. */
+	bool bInputRecordingInitialized = false;
+
+	/** The recording being written or replayed. */
+	FBelicaInputRecording InputRecording;
+
+	/** The file the recording is written to or was read from. */
+	FString InputRecordingPath;
+
+	/** The fixed-step frame the recording or replay is on. */
+	uint32 InputRecordingFrame = 0;
+
+	/** The next event to replay. */
+	int32 ReplayEventIndex = 0;
+
 	/**
 	 * @brief The Belica character that this controller controls.
 	 * 
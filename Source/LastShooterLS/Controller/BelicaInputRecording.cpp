@@ -0,0 +1,100 @@
+/**
+ * @file BelicaInputRecording.cpp
+ * @brief This file contains the implementation of the FBelicaInputRecording struct.
+ */
+
+#include "BelicaInputRecording.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+/**
+ * @brief Resolves a recording name from the command line to a file path.
+ * @param Name The name or path passed on the command line.
+ * @return The path of the recording file.
+ */
+FString FBelicaInputRecording::ResolvePath( const FString& Name ) {
+	FString Path = FPaths::IsRelative(Name) ? FPaths::ProjectSavedDir() / TEXT("InputRecordings") / Name : Name;
+	if ( FPaths::GetExtension(Path).IsEmpty() ) { Path += TEXT(".binput"); }
+	return Path;
+}
+
+
+/**
+ * @brief Writes the recording to disk.
+ * @param Path The file to write.
+ * @return True if the file was written, false otherwise.
+ */
+bool FBelicaInputRecording::Save( const FString& Path ) {
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Path));
+	if ( !Writer ) { return false; }
+
+	Serialize(*Writer);
+	return Writer->Close();
+}
+
+
+/**
+ * @brief Reads a recording from disk.
+ * @param Path The file to read.
+ * @return True if the file was read and is a valid recording, false otherwise.
+ */
+bool FBelicaInputRecording::Load( const FString& Path ) {
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Path));
+	if ( !Reader ) { return false; }
+
+	Serialize(*Reader);
+	return Reader->Close() && !Reader->IsError();
+}
+
+
+/**
+ * @brief Serializes the header and the events.
+ *
+ * Frames are written as packed deltas from the previous event so long idle stretches cost a single byte.
+ * @param Ar The archive to serialize with.
+ */
+void FBelicaInputRecording::Serialize( FArchive& Ar ) {
+	uint32 FileMagic = Magic;
+	uint16 FileVersion = Version;
+	Ar << FileMagic << FileVersion;
+
+	if ( FileMagic != Magic || FileVersion != Version ) {
+		Ar.SetError();
+		return;
+	}
+
+	Ar << FixedDeltaTime << NumFrames;
+
+	int32 NumEvents = Events.Num();
+	Ar << NumEvents;
+	if ( Ar.IsLoading() ) {
+		// The count comes from the file, so it must fit in what is left of it before anything is allocated for it
+		const int64 RemainingBytes = Ar.TotalSize() >= 0 ? Ar.TotalSize() - Ar.Tell() : static_cast<int64>(MaxEvents) * MinEventBytes;
+		if ( NumEvents < 0 || NumEvents > MaxEvents || NumEvents > RemainingBytes / MinEventBytes ) {
+			Ar.SetError();
+			return;
+		}
+		Events.SetNumUninitialized(NumEvents);
+	}
+
+	uint32 PreviousFrame = 0;
+	for ( FBelicaInputEvent& Event : Events ) {
+		uint32 FrameDelta = Event.Frame - PreviousFrame;
+		Ar.SerializeIntPacked(FrameDelta);
+		Event.Frame = PreviousFrame + FrameDelta;
+		PreviousFrame = Event.Frame;
+
+		uint8 Action = static_cast<uint8>(Event.Action);
+		Ar << Action;
+		if ( Action >= static_cast<uint8>(EBelicaInputAction::Num) ) {
+			Ar.SetError();
+			Events.Reset();
+			return;
+		}
+		Event.Action = static_cast<EBelicaInputAction>(Action);
+
+		if ( HasValue(Event.Action) ) { Ar << Event.Value; }
+		else { Event.Value = FVector2f::ZeroVector; }
+	}
+}
@@ -0,0 +1,111 @@
+/**
+ * @file BelicaInputRecording.h
+ * @brief This file contains the declaration of the FBelicaInputRecording struct.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @enum EBelicaInputAction
+ * @brief The controller handlers an input recording can drive.
+ */
+enum class EBelicaInputAction : uint8
+{
+	Move,
+	Look,
+	Jump,
+	FireStart,
+	FireEnd,
+	AimStart,
+	AimEnd,
+	Equip,
+	Unequip,
+	Run,
+	Walk,
+	Crouch,
+	Num
+};
+
+/**
+ * @struct FBelicaInputEvent
+ * @brief A single input action value dispatched on a given fixed-step frame.
+ */
+struct FBelicaInputEvent
+{
+	/** The fixed-step frame the action fired on, counted from the start of the recording. */
+	uint32 Frame = 0;
+
+	/** The action that fired. */
+	EBelicaInputAction Action = EBelicaInputAction::Num;
+
+	/** The axis value of Move and Look. Unused by the other actions. */
+	FVector2f Value = FVector2f::ZeroVector;
+};
+
+/**
+ * @struct FBelicaInputRecording
+ * @brief A compact binary stream of the input actions of one play session, recorded and replayed under a fixed timestep.
+ *
+ * The stream is a small header followed by the events in frame order. Frames are stored as packed deltas and only
+ * Move and Look carry a value, so a typical event takes two to ten bytes.
+ */
+struct FBelicaInputRecording
+{
+	/** Identifies input recording files. */
+	static constexpr uint32 Magic = 0x52494C42; // 'BLIR'
+
+	/** Bumped whenever the stream layout changes. */
+	static constexpr uint16 Version = 1;
+
+	/** The fewest bytes an event takes in a file: a packed frame delta and an action. */
+	static constexpr int64 MinEventBytes = 2;
+
+	/** The most events a file may hold, for archives that cannot tell their size. About 90 minutes of input at 60 fps. */
+	static constexpr int32 MaxEvents = 4 * 1024 * 1024;
+
+	/** The fixed timestep the session was recorded at, in seconds. */
+	float FixedDeltaTime = 1.f / 60.f;
+
+	/** The number of frames recorded, including trailing frames without input. */
+	uint32 NumFrames = 0;
+
+	/** The recorded events, in frame order. */
+	TArray<FBelicaInputEvent> Events;
+
+	/**
+	 * @brief Checks whether an action carries an axis value.
+	 * @param Action The action to check.
+	 * @return True for Move and Look, false otherwise.
+	 */
+	static FORCEINLINE bool HasValue(const EBelicaInputAction Action) { return Action == EBelicaInputAction::Move || Action == EBelicaInputAction::Look; }
+
+	/**
+	 * @brief Resolves a recording name from the command line to a file path.
+	 * Bare names are placed in Saved/InputRecordings.
+	 * @param Name The name or path passed on the command line.
+	 * @return The path of the recording file.
+	 */
+	static FString ResolvePath(const FString& Name);
+
+	/**
+	 * @brief Writes the recording to disk.
+	 * @param Path The file to write.
+	 * @return True if the file was written, false otherwise.
+	 */
+	bool Save(const FString& Path);
+
+	/**
+	 * @brief Reads a recording from disk.
+	 * @param Path The file to read.
+	 * @return True if the file was read and is a valid recording, false otherwise.
+	 */
+	bool Load(const FString& Path);
+
+	/**
+	 * @brief Serializes the header and the events.
+	 * @param Ar The archive to serialize with.
+	 */
+	void Serialize(FArchive& Ar);
+};
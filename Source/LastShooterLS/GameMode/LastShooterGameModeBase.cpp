@@ -2,4 +2,176 @@
 
 
 #include "LastShooterGameModeBase.h"
+#include "LastShooterLS/Character/BelicaCharacter.h"
+#include "LastShooterLS/Profiling.h"
+#include "WorldItemsModule/ItemSnapshot/Public/ItemSnapshotSubsystem.h"
 
+#include "EngineUtils.h"
+#include "GameFramework/WorldSettings.h"
+#include "Particles/ParticleSystemComponent.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLastShooterGameMode, Log, All);
+
+/**
+ * @brief Spawns the default pawn, or reuses a pooled character of the same class.
+ *
+ * A pooled character is reset for the spawn transform; the controller possesses it right after.
+ */
+APawn* ALastShooterGameModeBase::SpawnDefaultPawnAtTransform_Implementation( AController* NewPlayer, const FTransform& SpawnTransform ) {
+	if ( ABelicaCharacter* Pooled = AcquirePooledPawn(GetDefaultPawnClassForController(NewPlayer)) ) {
+		Pooled->ResetForRespawn(SpawnTransform);
+		return Pooled;
+	}
+
+	// Registering the pawn's components creates its animation instance, so the whole spawn is tagged
+	LLM_SCOPE_BYTAG(LastShooter_Characters);
+	return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
+}
+
+
+/**
+ * @brief Starts play, fills the pawn pool and captures the item layout every round starts from.
+ *
+ * Every actor has begun play once Super::StartPlay returns, so the level's items are all in place.
+ */
+void ALastShooterGameModeBase::StartPlay() {
+	Super::StartPlay();
+
+	// Only Belica characters know how to reset themselves, other default pawns are spawned as usual
+	if ( DefaultPawnClass && DefaultPawnClass->IsChildOf(ABelicaCharacter::StaticClass()) ) {
+		LLM_SCOPE_BYTAG(LastShooter_Pooled);
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		PawnPool.Reserve(PawnPoolSize);
+		for ( int32 Index = 0; Index < PawnPoolSize; ++Index ) {
+			if ( ABelicaCharacter* Character = GetWorld()->SpawnActor<ABelicaCharacter>(DefaultPawnClass, FTransform::Identity, SpawnParameters) ) { ReleasePawn(Character); }
+		}
+	}
+
+	if ( const UItemSnapshotSubsystem* ItemSnapshots = GetWorld()->GetSubsystem<UItemSnapshotSubsystem>() ) { ItemSnapshots->CaptureSnapshot(InitialItemLayout); }
+}
+
+
+/**
+ * @brief Resets the match in place for a new round.
+ *
+ * Nothing is loaded or spawned if the pools are warm: items are parked and re-placed from the captured layout,
+ * pawns keep their actors and are reset at a player start, and spawned effects are destroyed.
+ */
+void ALastShooterGameModeBase::ResetMatch() {
+	LASTSHOOTER_SCOPE(ResetMatch);
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Pawns first, so the weapons they hold are back in the pool before the item layout is restored
+	for ( FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It ) {
+		AController* Controller = It->Get();
+		ABelicaCharacter* Belica = Controller ? Cast<ABelicaCharacter>(Controller->GetPawn()) : nullptr;
+		if ( Belica == nullptr ) { continue; }
+
+		const AActor* PlayerStart = FindPlayerStart(Controller);
+		Belica->ResetForRespawn(PlayerStart ? PlayerStart->GetActorTransform() : Belica->GetActorTransform());
+	}
+
+	if ( UItemSnapshotSubsystem* ItemSnapshots = GetWorld()->GetSubsystem<UItemSnapshotSubsystem>() ) { ItemSnapshots->RestoreSnapshot(InitialItemLayout); }
+
+	ClearTransientEffects();
+
+	LastResetDurationMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	SET_FLOAT_STAT(STAT_MatchResetTime, LastResetDurationMs);
+	UE_LOG(LogLastShooterGameMode, Display, TEXT("Match reset in %.2f ms"), LastResetDurationMs);
+}
+
+
+/**
+ * @brief Respawns a controller's character through the pawn pool.
+ *
+ * The old character is parked before the restart, so with a warm pool the respawn spawns no actors
+ * and loads no assets: the new life is the same character reset at a player start.
+ */
+void ALastShooterGameModeBase::RespawnPlayer( AController* Controller ) {
+	if ( Controller == nullptr ) { return; }
+
+	LASTSHOOTER_SCOPE(RespawnPlayer);
+	const double StartTime = FPlatformTime::Seconds();
+
+	if ( ABelicaCharacter* Character = Cast<ABelicaCharacter>(Controller->GetPawn()) ) {
+		Controller->UnPossess();
+		ReleasePawn(Character);
+	}
+
+	RestartPlayer(Controller);
+
+	LastRespawnDurationMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	SET_FLOAT_STAT(STAT_RespawnTime, LastRespawnDurationMs);
+	UE_LOG(LogLastShooterGameMode, Verbose, TEXT("Respawned %s in %.3f ms"), *Controller->GetName(), LastRespawnDurationMs);
+}
+
+
+/**
+ * @brief Respawns every controller's character.
+ */
+void ALastShooterGameModeBase::RespawnPlayers() {
+	// Restarting a player does not add or remove controllers, but collect them first all the same
+	TArray<AController*, TInlineAllocator<16>> Controllers;
+	for ( FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It ) {
+		if ( AController* Controller = It->Get() ) { Controllers.Add(Controller); }
+	}
+
+	for ( AController* Controller : Controllers ) { RespawnPlayer(Controller); }
+}
+
+
+/**
+ * @brief Deactivates a character and parks it in the pawn pool.
+ * @param Character The character to park. Must not be possessed.
+ */
+void ALastShooterGameModeBase::ReleasePawn( ABelicaCharacter* Character ) {
+	if ( !IsValid(Character) || Character->IsPooled() ) { return; }
+
+	Character->SetPooled(true);
+	PawnPool.Add(Character);
+}
+
+
+/**
+ * @brief Takes a character of the given class out of the pawn pool.
+ * @param PawnClass The class of character wanted.
+ * @return A re-enabled character, or nullptr if none of that class is pooled.
+ */
+ABelicaCharacter* ALastShooterGameModeBase::AcquirePooledPawn( const UClass* PawnClass ) {
+	for ( int32 Index = PawnPool.Num() - 1; Index >= 0; --Index ) {
+		ABelicaCharacter* Character = PawnPool[Index];
+		if ( !IsValid(Character) ) {
+			PawnPool.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		if ( Character->GetClass() == PawnClass ) {
+			PawnPool.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			Character->SetPooled(false);
+			return Character;
+		}
+	}
+	return nullptr;
+}
+
+
+/**
+ * @brief Clears the effect components spawned into the world, such as muzzle flashes, impacts and beams.
+ *
+ * Effects spawned at a location are owned by the world settings actor. Components owned by the world's particle pool
+ * are only stopped: auto-released ones return to the pool as they complete, and free ones are already in it.
+ * Only unpooled components are destroyed.
+ */
+void ALastShooterGameModeBase::ClearTransientEffects() const {
+	TInlineComponentArray<UParticleSystemComponent*> Effects(GetWorldSettings());
+	for ( UParticleSystemComponent* Effect : Effects ) {
+		if ( Effect->PoolingMethod == EPSCPoolMethod::None ) {
+			Effect->DestroyComponent();
+		}
+		else if ( Effect->IsActive() ) {
+			Effect->DeactivateImmediate();
+		}
+	}
+}
@@ -4,14 +4,110 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "WorldItemsModule/ItemSnapshot/Public/ItemSnapshot.h"
 #include "LastShooterGameModeBase.generated.h"
 
+class ABelicaCharacter;
+
 /**
- * 
+ * @class ALastShooterGameModeBase
+ * @brief The game mode of LastShooter. Owns the round lifecycle.
+ *
+ * Rounds restart in place: ResetMatch puts the world items back in the layout captured when play started,
+ * resets every pawn at a player start and clears transient effects without unloading the level.
+ *
+ * Respawning does not destroy and spawn characters. RespawnPlayer parks the old character in a pool of
+ * deactivated characters and RestartPlayer takes one out again, resets it for its player start and hands it
+ * to the controller, which re-binds its input on possession.
  */
 UCLASS()
 class LASTSHOOTERLS_API ALastShooterGameModeBase	: public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
+public:
+	/**
+	 * @brief Spawns the default pawn, accounting its components and animation instance to the character LLM tag.
+	 */
+	virtual APawn* SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform) override;
+
+	/**
+	 * @brief Starts play, fills the pawn pool and captures the item layout every round starts from.
+	 */
+	virtual void StartPlay() override;
+
+	/**
+	 * @brief Resets the match in place for a new round.
+	 * 
+	 * Returns every item to its starting layout through the item pool, resets every pawn at a player start,
+	 * clears transient effects and reports how long it took. Also available as the ResetMatch console command.
+	 */
+	UFUNCTION(Exec, BlueprintCallable, Category = "Match")
+	void ResetMatch();
+
+	/**
+	 * @brief Respawns a controller's character through the pawn pool.
+	 * 
+	 * Parks the current character and restarts the player, which takes a pooled character instead of spawning one.
+	 * 
+	 * @param Controller The controller to respawn.
+	 */
+	void RespawnPlayer(AController* Controller);
+
+	/**
+	 * @brief Respawns every controller's character. Also available as the RespawnPlayers console command.
+	 */
+	UFUNCTION(Exec, BlueprintCallable, Category = "Respawn")
+	void RespawnPlayers();
+
+	/**
+	 * @brief Gets how long the last respawn took.
+	 * @return The duration of the last respawn in milliseconds.
+	 */
+	FORCEINLINE float GetLastRespawnDurationMs() const { return LastRespawnDurationMs; }
+
+	/**
+	 * @brief Gets how long the last match reset took.
+	 * @return The duration of the last reset in milliseconds.
+	 */
+	FORCEINLINE float GetLastResetDurationMs() const { return LastResetDurationMs; }
+
+private:
+	/**
+	 * @brief Deactivates a character and parks it in the pawn pool.
+	 * @param Character The character to park. Must not be possessed.
+	 */
+	void ReleasePawn(ABelicaCharacter* Character);
+
+	/**
+	 * @brief Takes a character of the given class out of the pawn pool.
+	 * @param PawnClass The class of character wanted.
+	 * @return A re-enabled character, or nullptr if none of that class is pooled.
+	 */
+	ABelicaCharacter* AcquirePooledPawn(const UClass* PawnClass);
+
+	/**
+	 * @brief Clears the effect components spawned into the world, such as muzzle flashes, impacts and beams.
+	 * Pooled components are stopped and left to the world's particle pool; the rest are destroyed.
+	 */
+	void ClearTransientEffects() const;
+
+	/** The world items as they were when play started. */
+	FItemSnapshot InitialItemLayout;
+
+	/** The number of deactivated characters created when play starts, so the first respawns spawn nothing. */
+	UPROPERTY(EditDefaultsOnly, Category = "Respawn", meta = (ClampMin = 0))
+	int32 PawnPoolSize = 4;
+
+	/** The deactivated characters waiting to be respawned. */
+	UPROPERTY()
+	TArray<ABelicaCharacter*> PawnPool;
+
+	/** How long the last respawn took, in milliseconds. */
+	UPROPERTY(VisibleInstanceOnly, Category = "Respawn")
+	float LastRespawnDurationMs = 0.f;
+
+	/** How long the last match reset took, in milliseconds. */
+	UPROPERTY(VisibleInstanceOnly, Category = "Match")
+	float LastResetDurationMs = 0.f;
 };
@@ -1,6 +1,39 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "LastShooterLS.h"
+#include "Profiling.h"
+#include "Misc/CoreDelegates.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, LastShooterLS, "LastShooterLS" );
+void FLastShooterLSModule::StartupModule()
+{
+#if CSV_PROFILER
+	// Gameplay CSV metrics are opt-in so regular captures stay comparable
+	if (FParse::Param(FCommandLine::Get(), TEXT("GameplayCsv")))
+	{
+		FCsvProfiler::Get()->EnableCategoryByString(TEXT("LastShooter"));
+		PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddRaw(this, &FLastShooterLSModule::BeginGameplayCsvCapture);
+	}
+#endif
+}
+
+void FLastShooterLSModule::ShutdownModule()
+{
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+}
+
+void FLastShooterLSModule::BeginGameplayCsvCapture()
+{
+#if CSV_PROFILER
+	// One capture per run: the CSV file and its summary cover the whole session and can be diffed between builds.
+	// An explicit -csvCaptureFrames or csvprofile start takes precedence.
+	FCsvProfiler* CsvProfiler = FCsvProfiler::Get();
+	if (!CsvProfiler->IsCapturing())
+	{
+		CsvProfiler->BeginCapture();
+	}
+	CSV_METADATA(TEXT("GameplayCsv"), TEXT("1"));
+#endif
+}
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FLastShooterLSModule, LastShooterLS, "LastShooterLS" );
@@ -3,4 +3,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
 
+class FLastShooterLSModule : public FDefaultGameModuleImpl
+{
+public:
+
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+
+private:
+	/** Starts a CSV capture for the run once the engine is up, when -GameplayCsv is on the command line. */
+	void BeginGameplayCsvCapture();
+
+	FDelegateHandle PostEngineInitHandle;
+};
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Profiling.h"
+
+UE_TRACE_CHANNEL_DEFINE(LastShooterChannel);
+
+CSV_DEFINE_CATEGORY(LastShooter, false);
+
+LLM_DEFINE_TAG(LastShooter);
+LLM_DEFINE_TAG(LastShooter_Characters, TEXT("Characters"), TEXT("LastShooter"));
+LLM_DEFINE_TAG(LastShooter_Pooled, TEXT("Pooled"), TEXT("LastShooter"));
+
+DEFINE_STAT(STAT_TimeToArmed);
+DEFINE_STAT(STAT_BelicaTick);
+DEFINE_STAT(STAT_StartFireWeapon);
+DEFINE_STAT(STAT_HandleEquipWeapon);
+DEFINE_STAT(STAT_BelicaOverlap);
+DEFINE_STAT(STAT_NativeUpdateAnimation);
+DEFINE_STAT(STAT_ResetMatch);
+DEFINE_STAT(STAT_MatchResetTime);
+DEFINE_STAT(STAT_RespawnPlayer);
+DEFINE_STAT(STAT_RespawnTime);
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.h"
+
+/** Insights channel for the character and animation hot paths. Enable with -trace=cpu,LastShooter. */
+UE_TRACE_CHANNEL_EXTERN(LastShooterChannel);
+
+DECLARE_STATS_GROUP(TEXT("LastShooter"), STATGROUP_LastShooter, STATCAT_Advanced);
+
+/** Milliseconds between a pawn spawning and its default loadout being equipped, for the most recent spawn. */
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Time To Armed (ms)"), STAT_TimeToArmed, STATGROUP_LastShooter, );
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Belica Tick"), STAT_BelicaTick, STATGROUP_LastShooter, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("StartFireWeapon"), STAT_StartFireWeapon, STATGROUP_LastShooter, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("HandleEquipWeapon"), STAT_HandleEquipWeapon, STATGROUP_LastShooter, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Belica Overlap"), STAT_BelicaOverlap, STATGROUP_LastShooter, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("NativeUpdateAnimation"), STAT_NativeUpdateAnimation, STATGROUP_LastShooter, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ResetMatch"), STAT_ResetMatch, STATGROUP_LastShooter, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RespawnPlayer"), STAT_RespawnPlayer, STATGROUP_LastShooter, );
+
+/** Milliseconds the most recent in-place match reset took. */
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Match Reset (ms)"), STAT_MatchResetTime, STATGROUP_LastShooter, );
+
+/** Milliseconds the most recent respawn took, from releasing the old pawn to possessing the new one. */
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Respawn (ms)"), STAT_RespawnTime, STATGROUP_LastShooter, );
+
+/** CSV category for per-frame character and animation metrics. Off by default, enabled by -GameplayCsv. */
+CSV_DECLARE_CATEGORY_EXTERN(LastShooter);
+
+/** LLM tags for character allocations, including their animation instances. Visible with -llm in memreport and with -trace=memtag in Insights. */
+LLM_DECLARE_TAG(LastShooter);
+LLM_DECLARE_TAG(LastShooter_Characters);
+LLM_DECLARE_TAG(LastShooter_Pooled);
+
+/**
+ * Times the enclosing scope under STAT_<Name> (cycles and call count in `stat LastShooter`)
+ * and as a named CPU event on the LastShooter trace channel, which costs a single branch while the channel is off.
+ */
+#define LASTSHOOTER_SCOPE(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, LastShooterChannel)
@@ -0,0 +1,277 @@
+/**
+ * @file BotSoakSubsystem.cpp
+ * @brief This file contains the implementation of the UBotSoakSubsystem class.
+ */
+
+#include "BotSoakSubsystem.h"
+
+#include "LastShooterLS/Character/BelicaCharacter.h"
+#include "LastShooterLS/Profiling.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBotSoak, Log, All);
+
+namespace BotSoak
+{
+	/** Fixed seed so every run drives the bots through the same script. */
+	constexpr int32 Seed = 0x50A4;
+
+	/** Bots are spread over rings around the player start, this many per ring. */
+	constexpr int32 BotsPerRing = 8;
+
+	/** The spacing between rings of bots. */
+	constexpr float RingSpacing = 300.f;
+
+	/** Seconds between bots dropping and picking up their weapon. */
+	constexpr float LoadoutSwapInterval = 8.f;
+
+	/** Frames per second the frame time buffer is sized for up front. */
+	constexpr int32 ReservedFramesPerSecond = 120;
+
+	static const TCHAR* ActionNames[] = { TEXT("Move"), TEXT("Aim"), TEXT("Fire"), TEXT("RunWalk"), TEXT("DropAndPickup") };
+
+	/** Accumulates the cycles spent in the enclosing scope onto a soak action. */
+	struct FScopedActionTimer
+	{
+		FScopedActionTimer(uint64& InCycles, int32& InCalls) : Cycles(InCycles), StartCycles(FPlatformTime::Cycles64()) { ++InCalls; }
+		~FScopedActionTimer() { Cycles += FPlatformTime::Cycles64() - StartCycles; }
+
+		uint64& Cycles;
+		uint64 StartCycles;
+	};
+
+	/**
+	 * @brief Gets a percentile of an ascending sorted sample set.
+	 * @param SortedSamples The samples, sorted ascending.
+	 * @param Percentile The percentile in [0, 1].
+	 * @return The sample at the given percentile, or 0 if there are no samples.
+	 */
+	float GetPercentile(const TArray<float>& SortedSamples, const float Percentile) {
+		if ( SortedSamples.Num() == 0 ) { return 0.f; }
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * SortedSamples.Num()) - 1, 0, SortedSamples.Num() - 1);
+		return SortedSamples[Index];
+	}
+}
+
+#define SOAK_ACTION_SCOPE(Action) BotSoak::FScopedActionTimer ActionTimer(ActionCycles[static_cast<int32>(Action)], ActionCalls[static_cast<int32>(Action)])
+
+
+/**
+ * @brief The soak only runs when explicitly requested on the command line.
+ * @param Outer The world the subsystem would be created for.
+ * @return True if -BotSoak was passed, false otherwise.
+ */
+bool UBotSoakSubsystem::ShouldCreateSubsystem( UObject* Outer ) const {
+	return FParse::Param(FCommandLine::Get(), TEXT("BotSoak")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+
+/**
+ * @brief Reads the soak configuration from the command line and spawns the bots.
+ *
+ * Bots use the game mode's default pawn class so they carry the same assets and default loadout as players.
+ * @param InWorld The world that began play.
+ */
+void UBotSoakSubsystem::OnWorldBeginPlay( UWorld& InWorld ) {
+	Super::OnWorldBeginPlay(InWorld);
+
+	FParse::Value(FCommandLine::Get(), TEXT("BotSoakBots="), NumBots);
+	FParse::Value(FCommandLine::Get(), TEXT("BotSoakDuration="), SoakDuration);
+	NumBots = FMath::Max(NumBots, 0);
+	SoakDuration = FMath::Max(SoakDuration, 1.f);
+
+	AGameModeBase* GameMode = InWorld.GetAuthGameMode();
+	UClass* PawnClass = GameMode ? GameMode->DefaultPawnClass.Get() : nullptr;
+	if ( PawnClass == nullptr || !PawnClass->IsChildOf(ABelicaCharacter::StaticClass()) ) {
+		UE_LOG(LogBotSoak, Error, TEXT("The default pawn class of %s is not a Belica character, nothing to soak"), *InWorld.GetMapName());
+		FPlatformMisc::RequestExit(false, TEXT("BotSoak"));
+		return;
+	}
+
+	// Spread the bots over rings around the player start
+	const AActor* PlayerStart = GameMode->FindPlayerStart(nullptr);
+	const FVector Origin = PlayerStart ? PlayerStart->GetActorLocation() : FVector::ZeroVector;
+
+	Random.Initialize(BotSoak::Seed);
+	Bots.Reserve(NumBots);
+	for ( int32 BotIndex = 0; BotIndex < NumBots; ++BotIndex ) {
+		const float Radius = BotSoak::RingSpacing * (1 + BotIndex / BotSoak::BotsPerRing);
+		const float Angle = 2.f * PI * (BotIndex % BotSoak::BotsPerRing) / BotSoak::BotsPerRing;
+		SpawnBot(PawnClass, Origin + FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 0.f));
+	}
+
+	FrameTimesMs.Reserve(FMath::CeilToInt(SoakDuration) * BotSoak::ReservedFramesPerSecond);
+	SoakStartTime = FPlatformTime::Seconds();
+	bIsSoaking = true;
+
+	UE_LOG(LogBotSoak, Display, TEXT("Soaking %s with %d of %d bots for %.0f seconds"), *InWorld.GetMapName(), Bots.Num(), NumBots, SoakDuration);
+}
+
+
+/**
+ * @brief Spawns a bot at the given location and hands it to an AI controller.
+ * @param PawnClass The Belica class to spawn.
+ * @param Location The location to spawn at.
+ */
+void UBotSoakSubsystem::SpawnBot( UClass* PawnClass, const FVector& Location ) {
+	LLM_SCOPE_BYTAG(LastShooter_Characters);
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	ABelicaCharacter* Character = GetWorld()->SpawnActor<ABelicaCharacter>(PawnClass, Location, FRotator::ZeroRotator, SpawnParameters);
+	if ( Character == nullptr ) { return; }
+
+	Character->SpawnDefaultController();
+
+	FSoakBot& Bot = Bots.AddDefaulted_GetRef();
+	Bot.Character = Character;
+	Bot.NextLoadoutSwapTime = Random.FRandRange(0.f, BotSoak::LoadoutSwapInterval);
+}
+
+
+/**
+ * @brief Drives every bot, records the frame time and finishes the run once the duration has elapsed.
+ * @param DeltaTime The time since the last frame.
+ */
+void UBotSoakSubsystem::Tick( const float DeltaTime ) {
+	Super::Tick(DeltaTime);
+
+	FrameTimesMs.Add(static_cast<float>(FApp::GetDeltaTime() * 1000.0));
+	SoakElapsed += DeltaTime;
+
+	for ( FSoakBot& Bot : Bots ) {
+		if ( Bot.Character.IsValid() ) { DriveBot(Bot, DeltaTime); }
+	}
+
+	if ( SoakElapsed >= SoakDuration ) { FinishSoak(); }
+}
+
+
+/**
+ * @brief Advances the script of a single bot by one frame.
+ *
+ * Every one to three seconds the bot picks a new move direction, turn rate, aiming, firing and running state.
+ * Every few seconds it drops its weapon or picks one up. Inputs go through the same character APIs the
+ * player controller uses so the soak exercises the real gameplay paths.
+ * @param Bot The bot to drive.
+ * @param DeltaTime The time since the last frame.
+ */
+void UBotSoakSubsystem::DriveBot( FSoakBot& Bot, const float DeltaTime ) {
+	ABelicaCharacter* Character = Bot.Character.Get();
+
+	if ( SoakElapsed >= Bot.NextDecisionTime ) {
+		Bot.NextDecisionTime = SoakElapsed + Random.FRandRange(1.f, 3.f);
+		Bot.MoveInput = FVector2D(Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f)).GetSafeNormal();
+		Bot.YawRate = Random.FRandRange(-90.f, 90.f);
+
+		const bool bWantsToAim = Random.FRand() < 0.3f;
+		if ( bWantsToAim != Bot.bIsAiming ) {
+			SOAK_ACTION_SCOPE(ESoakAction::Aim);
+			if ( bWantsToAim ) { Character->StartAiming(); }
+			else { Character->StopAiming(); }
+			Bot.bIsAiming = bWantsToAim;
+		}
+
+		const bool bWantsToRun = Random.FRand() < 0.5f;
+		if ( bWantsToRun != Bot.bIsRunning ) {
+			SOAK_ACTION_SCOPE(ESoakAction::RunWalk);
+			if ( bWantsToRun ) { Character->ToggleRun(); }
+			else { Character->ToggleWalk(); }
+			Bot.bIsRunning = bWantsToRun;
+		}
+
+		const bool bWantsToFire = Random.FRand() < 0.6f;
+		if ( Bot.bIsFiring && !bWantsToFire ) {
+			SOAK_ACTION_SCOPE(ESoakAction::Fire);
+			Character->EndWeaponFIre();
+		}
+		Bot.bIsFiring = bWantsToFire;
+	}
+
+	{
+		SOAK_ACTION_SCOPE(ESoakAction::Move);
+		Character->AddMovementInput(Character->GetActorForwardVector(), Bot.MoveInput.Y);
+		Character->AddMovementInput(Character->GetActorRightVector(), Bot.MoveInput.X);
+
+		if ( AController* Controller = Character->GetController() ) {
+			Controller->SetControlRotation(Controller->GetControlRotation() + FRotator(0.f, Bot.YawRate * DeltaTime, 0.f));
+		}
+	}
+
+	// Holding fire calls into the weapon every frame, exactly like the triggered input action
+	if ( Bot.bIsFiring ) {
+		SOAK_ACTION_SCOPE(ESoakAction::Fire);
+		Character->StartFIreWeapon();
+	}
+
+	if ( SoakElapsed >= Bot.NextLoadoutSwapTime ) {
+		SOAK_ACTION_SCOPE(ESoakAction::DropAndPickup);
+		Bot.NextLoadoutSwapTime = SoakElapsed + BotSoak::LoadoutSwapInterval;
+		if ( Character->GetWeaponHandling()->GetIsArmed() ) { Character->UnEquipWeapon(); }
+		else { Character->HandleEquipWeapon(); }
+	}
+}
+
+
+/**
+ * @brief Logs and writes the report, then requests exit.
+ */
+void UBotSoakSubsystem::FinishSoak() {
+	bIsSoaking = false;
+
+	TArray<float> SortedFrameTimes = FrameTimesMs;
+	SortedFrameTimes.Sort();
+
+	const double WallSeconds = FPlatformTime::Seconds() - SoakStartTime;
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	constexpr double BytesPerMB = 1024.0 * 1024.0;
+
+	FString Report;
+	Report += FString::Printf(TEXT("BotSoak %s: %d bots, %.1f s, %d frames, %.1f fps average\n"), *GetWorld()->GetMapName(), Bots.Num(), WallSeconds, FrameTimesMs.Num(), FrameTimesMs.Num() / FMath::Max(WallSeconds, UE_DOUBLE_SMALL_NUMBER));
+	Report += FString::Printf(TEXT("Frame time (ms): p50 %.2f, p90 %.2f, p95 %.2f, p99 %.2f, max %.2f\n"),
+		BotSoak::GetPercentile(SortedFrameTimes, 0.5f), BotSoak::GetPercentile(SortedFrameTimes, 0.9f), BotSoak::GetPercentile(SortedFrameTimes, 0.95f),
+		BotSoak::GetPercentile(SortedFrameTimes, 0.99f), BotSoak::GetPercentile(SortedFrameTimes, 1.f));
+	Report += FString::Printf(TEXT("Memory high-water mark (MB): physical %.1f, virtual %.1f\n"), MemoryStats.PeakUsedPhysical / BytesPerMB, MemoryStats.PeakUsedVirtual / BytesPerMB);
+
+	for ( int32 ActionIndex = 0; ActionIndex < static_cast<int32>(ESoakAction::Num); ++ActionIndex ) {
+		const double TotalMs = FPlatformTime::ToMilliseconds64(ActionCycles[ActionIndex]);
+		const double AverageUs = ActionCalls[ActionIndex] > 0 ? TotalMs * 1000.0 / ActionCalls[ActionIndex] : 0.0;
+		Report += FString::Printf(TEXT("%s: %d calls, %.2f ms total, %.2f us average, %.3f ms per frame\n"), BotSoak::ActionNames[ActionIndex], ActionCalls[ActionIndex], TotalMs, AverageUs, TotalMs / FMath::Max(FrameTimesMs.Num(), 1));
+	}
+
+	TArray<FString> ReportLines;
+	Report.ParseIntoArrayLines(ReportLines);
+	for ( const FString& Line : ReportLines ) { UE_LOG(LogBotSoak, Display, TEXT("%s"), *Line); }
+
+	const FString ReportPath = FPaths::ProfilingDir() / TEXT("BotSoak") / FString::Printf(TEXT("BotSoak-%s.txt"), *FDateTime::Now().ToString());
+	if ( FFileHelper::SaveStringToFile(Report, *ReportPath) ) { UE_LOG(LogBotSoak, Display, TEXT("Report written to %s"), *ReportPath); }
+
+	FPlatformMisc::RequestExit(false, TEXT("BotSoak"));
+}
+
+
+/**
+ * @brief Only ticks while the soak is running.
+ * @return True while the soak is running, false otherwise.
+ */
+bool UBotSoakSubsystem::IsTickable() const { return bIsSoaking; }
+
+
+TStatId UBotSoakSubsystem::GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(UBotSoakSubsystem, STATGROUP_Tickables); }
+
+
+/**
+ * @brief The soak drives standalone game worlds only.
+ * @param WorldType The type of the world the subsystem would be created for.
+ * @return True for game worlds, false otherwise.
+ */
+bool UBotSoakSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const { return WorldType == EWorldType::Game; }
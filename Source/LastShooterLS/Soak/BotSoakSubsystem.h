@@ -0,0 +1,125 @@
+/**
+ * @file BotSoakSubsystem.h
+ * @brief This file contains the declaration of the UBotSoakSubsystem class.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BotSoakSubsystem.generated.h"
+
+class ABelicaCharacter;
+
+/**
+ * @class UBotSoakSubsystem
+ * @brief Headless throughput benchmark that drives scripted Belica bots and reports frame statistics.
+ *
+ * Only created when the game is launched with -BotSoak, typically as
+ * `LastShooterLS -game -nullrhi -BotSoak -BotSoakBots=32 -BotSoakDuration=120`.
+ * Once the default map begins play it spawns the configured number of bots, drives them through the regular
+ * ABelicaCharacter APIs (move, aim, fire, run/walk, drop and pick up weapons) for the configured duration,
+ * then logs frame-time percentiles, the memory high-water mark and the time spent in each driven API,
+ * writes the same report to Saved/Profiling/BotSoak and requests exit.
+ */
+UCLASS()
+class LASTSHOOTERLS_API UBotSoakSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	/**
+	 * @brief Reads the soak configuration from the command line and spawns the bots.
+	 * @param InWorld The world that began play.
+	 */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/**
+	 * @brief Drives every bot, records the frame time and finishes the run once the duration has elapsed.
+	 * @param DeltaTime The time since the last frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override;
+
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** The APIs the soak drives, timed separately in the report. */
+	enum class ESoakAction : uint8
+	{
+		Move,
+		Aim,
+		Fire,
+		RunWalk,
+		DropAndPickup,
+		Num
+	};
+
+	/** The scripted state of a single bot. */
+	struct FSoakBot
+	{
+		TWeakObjectPtr<ABelicaCharacter> Character;
+		FVector2D MoveInput = FVector2D::ZeroVector;
+		float YawRate = 0.f;
+		float NextDecisionTime = 0.f;
+		float NextLoadoutSwapTime = 0.f;
+		bool bIsAiming = false;
+		bool bIsFiring = false;
+		bool bIsRunning = false;
+	};
+
+	/**
+	 * @brief Spawns a bot at the given location and hands it to an AI controller.
+	 * @param PawnClass The Belica class to spawn.
+	 * @param Location The location to spawn at.
+	 */
+	void SpawnBot(UClass* PawnClass, const FVector& Location);
+
+	/**
+	 * @brief Advances the script of a single bot by one frame.
+	 * @param Bot The bot to drive.
+	 * @param DeltaTime The time since the last frame.
+	 */
+	void DriveBot(FSoakBot& Bot, float DeltaTime);
+
+	/**
+	 * @brief Logs and writes the report, then requests exit.
+	 */
+	void FinishSoak();
+
+	/** The scripted bots. */
+	TArray<FSoakBot> Bots;
+
+	/** The duration of every frame of the run in milliseconds, preallocated for the configured duration. */
+	TArray<float> FrameTimesMs;
+
+	/** Cycles spent in each driven API, indexed by ESoakAction. */
+	uint64 ActionCycles[static_cast<int32>(ESoakAction::Num)] = {};
+
+	/** Number of calls made to each driven API, indexed by ESoakAction. */
+	int32 ActionCalls[static_cast<int32>(ESoakAction::Num)] = {};
+
+	/** Seeds the bot scripts so runs are comparable between builds. */
+	FRandomStream Random;
+
+	/** The number of bots to spawn. */
+	int32 NumBots = 16;
+
+	/** The length of the run in seconds. */
+	float SoakDuration = 120.f;
+
+	/** The seconds elapsed since the bots were spawned. */
+	float SoakElapsed = 0.f;
+
+	/** Platform time at which the run started. */
+	double SoakStartTime = 0.0;
+
+	/** Whether the soak is currently running. */
+	bool bIsSoaking = false;
+};
@@ -12,5 +12,6 @@ public class LastShooterLSEditorTarget : TargetRules
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_4;
 		ExtraModuleNames.Add("LastShooterLS");
 		ExtraModuleNames.Add("WorldItemsModule");
+		ExtraModuleNames.Add("LastShooterTests");
 	}
 }
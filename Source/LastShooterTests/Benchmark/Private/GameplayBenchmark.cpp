@@ -0,0 +1,102 @@
+/**
+ * @file GameplayBenchmark.cpp
+ * @brief This file contains the implementation of the FGameplayBenchmarkWorld struct and the GameplayBenchmark helpers.
+ */
+
+#include "LastShooterTests/Benchmark/Private/GameplayBenchmark.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+
+namespace GameplayBenchmark
+{
+	/** The section of DefaultGame.ini holding the baselines. */
+	static const TCHAR* BaselineSection = TEXT("LastShooter.Benchmark");
+
+	/** The regression allowed when the section does not set one. */
+	constexpr double DefaultRegressionTolerance = 0.25;
+}
+
+
+/**
+ * @brief Spawns a character with a weapon handling component.
+ * @param Location Where the character stands.
+ * @param Rotation Where the character faces.
+ * @param ArmedState The weapon the handler is armed with.
+ * @return The handler, registered and past BeginPlay.
+ */
+UWeaponHandlingComponent* FGameplayBenchmarkWorld::SpawnHandler( const FVector& Location, const FRotator& Rotation, const EPlayerArmedState ArmedState ) const {
+	ACharacter* Character = World->SpawnActor<ACharacter>(Location, Rotation);
+	if ( Character == nullptr ) { return nullptr; }
+
+	UWeaponHandlingComponent* Handler = NewObject<UWeaponHandlingComponent>(Character);
+	Handler->RegisterComponent();
+	Handler->SetPlayerArmedState(ArmedState);
+	return Handler;
+}
+
+
+/**
+ * @brief Times an operation and returns the median cost of one run of it.
+ * @param NumSamples The number of batches to time.
+ * @param OpsPerSample The number of runs in every batch.
+ * @param Op The operation, given the index of the run across all batches.
+ * @return The median microseconds per run.
+ */
+double GameplayBenchmark::MeasureMicroseconds( const int32 NumSamples, const int32 OpsPerSample, const TFunctionRef<void(int32)> Op ) {
+	TArray<double> Samples;
+	Samples.Reserve(NumSamples);
+
+	int32 Run = 0;
+	for ( int32 Sample = 0; Sample < NumSamples; ++Sample ) {
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		for ( int32 Index = 0; Index < OpsPerSample; ++Index ) { Op(Run++); }
+		Samples.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0 / OpsPerSample);
+	}
+
+	if ( Samples.Num() == 0 ) { return 0.0; }
+	Samples.Sort();
+	return Samples[Samples.Num() / 2];
+}
+
+
+/**
+ * @brief Compares a timing with its stored baseline and fails the test if it has regressed past the tolerance.
+ * A timing without a baseline is reported as a warning so a new benchmark does not fail before it is recorded.
+ * @param Test The test to report to.
+ * @param Name The key of the baseline.
+ * @param Microseconds The measured microseconds per run.
+ * @return True if the timing is within its baseline or was recorded, false otherwise.
+ */
+bool GameplayBenchmark::CheckBaseline( FAutomationTestBase& Test, const TCHAR* Name, const double Microseconds ) {
+	if ( FParse::Param(FCommandLine::Get(), TEXT("BenchmarkRecord")) ) {
+		GConfig->SetDouble(BaselineSection, Name, Microseconds, GGameIni);
+		GConfig->Flush(false, GGameIni);
+		Test.AddInfo(FString::Printf(TEXT("%s: recorded %.3f us as the baseline"), Name, Microseconds));
+		return true;
+	}
+
+	double Baseline = 0.0;
+	if ( !GConfig->GetDouble(BaselineSection, Name, Baseline, GGameIni) || Baseline <= 0.0 ) {
+		Test.AddWarning(FString::Printf(TEXT("%s: %.3f us, no baseline stored in [%s]"), Name, Microseconds, BaselineSection));
+		return true;
+	}
+
+	double Tolerance = DefaultRegressionTolerance;
+	GConfig->GetDouble(BaselineSection, TEXT("RegressionTolerance"), Tolerance, GGameIni);
+
+	const double Limit = Baseline * (1.0 + Tolerance);
+	Test.AddInfo(FString::Printf(TEXT("%s: %.3f us against a baseline of %.3f us"), Name, Microseconds, Baseline));
+	if ( Microseconds > Limit ) {
+		Test.AddError(FString::Printf(TEXT("%s regressed: %.3f us is over %.3f us, the baseline plus %.0f%%"), Name, Microseconds, Limit, Tolerance * 100.0));
+		return false;
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file GameplayBenchmark.h
+ * @brief This file contains the declaration of the FGameplayBenchmarkWorld struct and the GameplayBenchmark helpers.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingComponent.h"
+#include "WorldItemsModule/Testing/Public/GameplayTestWorld.h"
+
+class FAutomationTestBase;
+
+/**
+ * @struct FGameplayBenchmarkWorld
+ * @brief A standalone game world that has begun play, with a helper to spawn weapon handlers in it.
+ * Runs under -nullrhi: nothing in it is rendered and the handlers have no effect assets.
+ */
+struct FGameplayBenchmarkWorld : FGameplayTestWorld
+{
+	/**
+	 * @brief Spawns a character with a weapon handling component.
+	 * @param Location Where the character stands.
+	 * @param Rotation Where the character faces.
+	 * @param ArmedState The weapon the handler is armed with.
+	 * @return The handler, registered and past BeginPlay.
+	 */
+	UWeaponHandlingComponent* SpawnHandler(const FVector& Location, const FRotator& Rotation, EPlayerArmedState ArmedState) const;
+};
+
+namespace GameplayBenchmark
+{
+	/**
+	 * @brief Times an operation and returns the median cost of one run of it.
+	 * Samples are timed in batches so the timer's resolution is no concern; the median keeps a stray context switch
+	 * from moving the result.
+	 * @param NumSamples The number of batches to time.
+	 * @param OpsPerSample The number of runs in every batch.
+	 * @param Op The operation, given the index of the run across all batches.
+	 * @return The median microseconds per run.
+	 */
+	double MeasureMicroseconds(int32 NumSamples, int32 OpsPerSample, TFunctionRef<void(int32)> Op);
+
+	/**
+	 * @brief Compares a timing with its stored baseline and fails the test if it has regressed past the tolerance.
+	 *
+	 * Baselines live in the [LastShooter.Benchmark] section of DefaultGame.ini, in microseconds per run, next to the
+	 * allowed RegressionTolerance. Running with -BenchmarkRecord stores the timing as the new baseline in the saved
+	 * Game.ini instead, to be copied into DefaultGame.ini once recorded on the reference machine.
+	 * @param Test The test to report to.
+	 * @param Name The key of the baseline.
+	 * @param Microseconds The measured microseconds per run.
+	 * @return True if the timing is within its baseline or was recorded, false otherwise.
+	 */
+	bool CheckBaseline(FAutomationTestBase& Test, const TCHAR* Name, double Microseconds);
+}
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * @file GameplayBenchmarkTests.cpp
+ * @brief This file contains the benchmark automation tests of the fire, equip and spawn paths.
+ *
+ * Run them headless with `UnrealEditor-Cmd LastShooterLS.uproject -nullrhi -unattended
+ * -ExecCmds="Automation RunTests LastShooter.Benchmark; Quit"`. Add -BenchmarkRecord to store the timings as the new
+ * baselines instead of checking them.
+ */
+
+#include "LastShooterTests/Benchmark/Private/GameplayBenchmark.h"
+#include "CharacterAttributeModule/WeaponHandling/Public/WeaponHandlingComponent.h"
+#include "WorldItemsModule/ItemPool/Public/ItemPoolSubsystem.h"
+#include "WorldItemsModule/Weapon/Public/Weapon.h"
+#include "Engine/SkeletalMeshSocket.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GameplayBenchmarkTests
+{
+	/** The batches every benchmark is timed in. */
+	constexpr int32 NumSamples = 31;
+
+	/** The runs warmed up before timing starts, so pools and arrays have grown to size. */
+	constexpr int32 NumWarmUpRuns = 64;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFireWeaponBenchmarkTest, "LastShooter.Benchmark.FireWeapon", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+/**
+ * @brief Times sustained fire: eight rifles in a ring firing at sixteen characters in the middle.
+ * Every shot goes through the whole fire path: the cooldown, the spread and the hit trace.
+ * @param Parameters Unused.
+ * @return True if the timing is within its baseline.
+ */
+bool FFireWeaponBenchmarkTest::RunTest( const FString& Parameters ) {
+	using namespace GameplayBenchmarkTests;
+	constexpr int32 NumShooters = 8;
+	constexpr int32 NumTargets = 16;
+	constexpr double RingRadius = 1500.0;
+
+	FGameplayBenchmarkWorld Benchmark;
+
+	for ( int32 Target = 0; Target < NumTargets; ++Target ) {
+		const FVector Location(static_cast<double>(Target % 4) * 100.0 - 150.0, static_cast<double>(Target / 4) * 100.0 - 150.0, 90.0);
+		Benchmark.SpawnHandler(Location, FRotator::ZeroRotator, EPlayerArmedState::EPAS_Unarmed);
+	}
+
+	struct FShooter
+	{
+		UWeaponHandlingComponent* Handler;
+		FTransform Barrel;
+	};
+	TArray<FShooter> Shooters;
+	for ( int32 Shooter = 0; Shooter < NumShooters; ++Shooter ) {
+		const FRotator Facing(0.0, Shooter * 360.0 / NumShooters + 180.0, 0.0);
+		const FVector Location = -Facing.Vector() * RingRadius + FVector(0.0, 0.0, 90.0);
+		UWeaponHandlingComponent* Handler = Benchmark.SpawnHandler(Location, Facing, EPlayerArmedState::EPAS_Rifle);
+		if ( !TestNotNull(TEXT("The shooter is spawned"), Handler) ) { return false; }
+		Shooters.Add({ Handler, FTransform(Facing, Location + Facing.Vector() * 50.0) });
+	}
+
+	auto FireShot = [&Shooters]( const int32 Run ) {
+		const FShooter& Shooter = Shooters[Run % Shooters.Num()];
+		FVector TraceEnd;
+		Shooter.Handler->SetShouldFireWeapon(true);
+		Shooter.Handler->FireWeapon(Shooter.Barrel, Shooter.Barrel.GetLocation(), TraceEnd);
+	};
+
+	for ( int32 Run = 0; Run < NumWarmUpRuns; ++Run ) { FireShot(Run); }
+	const double Microseconds = GameplayBenchmark::MeasureMicroseconds(NumSamples, 64, FireShot);
+	return GameplayBenchmark::CheckBaseline(*this, TEXT("FireWeapon"), Microseconds);
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEquipWeaponBenchmarkTest, "LastShooter.Benchmark.EquipWeapon", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+/**
+ * @brief Times equipping a pooled rifle and releasing it back to the pool.
+ * The character has no mesh asset, so the socket attachment finds no bone; the weapon state change, the trace ignores,
+ * the muzzle and the armed state are all still taken on.
+ * @param Parameters Unused.
+ * @return True if the timing is within its baseline.
+ */
+bool FEquipWeaponBenchmarkTest::RunTest( const FString& Parameters ) {
+	using namespace GameplayBenchmarkTests;
+
+	FGameplayBenchmarkWorld Benchmark;
+	UItemPoolSubsystem* ItemPool = Benchmark.World->GetSubsystem<UItemPoolSubsystem>();
+	UWeaponHandlingComponent* Handler = Benchmark.SpawnHandler(FVector(0.0, 0.0, 90.0), FRotator::ZeroRotator, EPlayerArmedState::EPAS_Unarmed);
+	if ( !TestNotNull(TEXT("The item pool exists"), ItemPool) || !TestNotNull(TEXT("The handler is spawned"), Handler) ) { return false; }
+
+	ACharacter* Character = CastChecked<ACharacter>(Handler->GetOwner());
+	USkeletalMeshSocket* Socket = NewObject<USkeletalMeshSocket>(GetTransientPackage());
+	Socket->SocketName = TEXT("RightHandSocket");
+	ItemPool->Prewarm(AWeapon::StaticClass(), 1);
+
+	auto EquipAndRelease = [&]( int32 ) {
+		AWeapon* Weapon = Cast<AWeapon>(ItemPool->AcquireItem(AWeapon::StaticClass(), Character->GetActorTransform()));
+		AWeapon* EquippedWeapon = nullptr;
+		Handler->EquipWeapon(Weapon, EquippedWeapon, Socket, Character->GetMesh());
+		Handler->ReleaseWeapon(EquippedWeapon);
+	};
+
+	for ( int32 Run = 0; Run < NumWarmUpRuns; ++Run ) { EquipAndRelease(Run); }
+	TestEqual(TEXT("Releasing returns the weapon to the pool"), ItemPool->GetNumPooled(AWeapon::StaticClass()), 1);
+
+	const double Microseconds = GameplayBenchmark::MeasureMicroseconds(NumSamples, 32, EquipAndRelease);
+	return GameplayBenchmark::CheckBaseline(*this, TEXT("EquipWeapon"), Microseconds);
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpawnItemBenchmarkTest, "LastShooter.Benchmark.SpawnItem", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+/**
+ * @brief Times a loot storm: weapons taken from a warm pool and put back, and weapons spawned and destroyed outright.
+ * The two timings show what the pool saves; each has its own baseline.
+ * @param Parameters Unused.
+ * @return True if both timings are within their baselines.
+ */
+bool FSpawnItemBenchmarkTest::RunTest( const FString& Parameters ) {
+	using namespace GameplayBenchmarkTests;
+	constexpr int32 StormSize = 64;
+
+	FGameplayBenchmarkWorld Benchmark;
+	UItemPoolSubsystem* ItemPool = Benchmark.World->GetSubsystem<UItemPoolSubsystem>();
+	if ( !TestNotNull(TEXT("The item pool exists"), ItemPool) ) { return false; }
+
+	auto GetDropTransform = []( const int32 Run ) {
+		return FTransform(FVector(static_cast<double>(Run % 16) * 60.0, static_cast<double>(Run / 16 % 16) * 60.0, 20.0));
+	};
+
+	// A whole storm is taken from the pool before any of it is put back, like loot dropped by a wave of kills
+	ItemPool->Prewarm(AWeapon::StaticClass(), StormSize);
+	TArray<AItem*> Storm;
+	Storm.Reserve(StormSize);
+	auto AcquireStorm = [&]( const int32 Run ) {
+		Storm.Add(ItemPool->AcquireItem(AWeapon::StaticClass(), GetDropTransform(Run)));
+		if ( Storm.Num() == StormSize ) {
+			for ( AItem* Item : Storm ) { ItemPool->ReleaseItem(Item); }
+			Storm.Reset();
+		}
+	};
+
+	for ( int32 Run = 0; Run < NumWarmUpRuns; ++Run ) { AcquireStorm(Run); }
+	const double PooledMicroseconds = GameplayBenchmark::MeasureMicroseconds(NumSamples, StormSize, AcquireStorm);
+	TestEqual(TEXT("The pool never spawns past the storm"), ItemPool->GetNumPooled(AWeapon::StaticClass()), StormSize);
+
+	auto SpawnAndDestroy = [&]( const int32 Run ) {
+		if ( AActor* Weapon = Benchmark.World->SpawnActor<AWeapon>(AWeapon::StaticClass(), GetDropTransform(Run)) ) { Weapon->Destroy(); }
+	};
+	for ( int32 Run = 0; Run < NumWarmUpRuns; ++Run ) { SpawnAndDestroy(Run); }
+	const double SpawnMicroseconds = GameplayBenchmark::MeasureMicroseconds(NumSamples, 16, SpawnAndDestroy);
+
+	const bool bPooledWithinBaseline = GameplayBenchmark::CheckBaseline(*this, TEXT("SpawnPooledItem"), PooledMicroseconds);
+	const bool bSpawnWithinBaseline = GameplayBenchmark::CheckBaseline(*this, TEXT("SpawnItem"), SpawnMicroseconds);
+	return bPooledWithinBaseline && bSpawnWithinBaseline;
+}
+
+#endif
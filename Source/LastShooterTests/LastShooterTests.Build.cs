@@ -0,0 +1,19 @@
+using UnrealBuildTool;
+
+public class LastShooterTests : ModuleRules
+{
+	public LastShooterTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"CharacterAttributeModule",
+				"WorldItemsModule",
+			});
+	}
+}
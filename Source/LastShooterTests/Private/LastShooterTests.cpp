@@ -0,0 +1,3 @@
+#include "LastShooterTests/Public/LastShooterTests.h"
+
+IMPLEMENT_MODULE(FLastShooterTestsModule, LastShooterTests)
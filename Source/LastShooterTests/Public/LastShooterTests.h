@@ -0,0 +1,12 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+
+/**
+ * @class FLastShooterTestsModule
+ * @brief Holds the gameplay benchmark automation tests. Never loaded by shipping builds.
+ */
+class FLastShooterTestsModule : public IModuleInterface
+{
+};
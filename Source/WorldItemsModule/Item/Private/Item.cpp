@@ -1,25 +1,44 @@
 ﻿// Fill out your copyright notice in the Description page of Project Settings.
 
 #include "WorldItemsModule/Item/Public/Item.h"
+#include "WorldItemsModule/ItemSnapshot/Public/ItemSnapshot.h"
+#include "WorldItemsModule/ItemStreaming/Public/ItemStreamingSubsystem.h"
+#include "WorldItemsModule/Private/Profiling.h"
 
 #include "Components/BoxComponent.h"
 #include "Components/SphereComponent.h"
 #include "Components/WidgetComponent.h"
 #include "GameFramework/Character.h"
 #include "Kismet/GameplayStatics.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Net/UnrealNetwork.h"
 
 /**
  * @brief Constructor for AItem.
  * Initializes all the item components and sets up the default item state and properties.
  * Sets collision responses and binds the overlap events for the collision sphere.
+ * Items replicate but start dormant: placed items open no channel at all until they are woken.
  */
 AItem::AItem() : ItemCount(0), ItemRarity(EItemRarity::EIR_MAX), ItemState(EItemState::EIS_InWorld),
 				// Initialize item rarity and state to default values
 				OverlappedItemCount(0), bShouldTraceForItem(false),
 				ThrowTime(4.0f), bIsFalling(false)
 {
-	// Enable Tick() to be called every frame for this actor.
-	PrimaryActorTick.bCanEverTick = true;
+	LLM_SCOPE_BYTAG(WorldItems_ItemActors);
+
+	// Enable Tick() to be called every frame for this actor. It only drives the local player's item details widget
+	PrimaryActorTick.bCanEverTick = !UE_SERVER;
+
+	// Replicate, but only when SetItemState, ThrowItem or pooling wakes the item
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
+
+	// Movement only replicates while an item is awake and falling; whole centimetres and byte angles are plenty for that
+	SetReplicatingMovement(true);
+	FRepMovement& RepMovement = GetReplicatedMovement_Mutable();
+	RepMovement.LocationQuantizationLevel = EVectorQuantization::RoundWholeNumber;
+	RepMovement.VelocityQuantizationLevel = EVectorQuantization::RoundWholeNumber;
+	RepMovement.RotationQuantizationLevel = ERotatorQuantization::ByteComponents;
 
 	// Create the item mesh component and set it as the root component
 	ItemMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ItemMesh"));
@@ -34,9 +53,16 @@ AItem::AItem() : ItemCount(0), ItemRarity(EItemRarity::EIR_MAX), ItemState(EItem
 	CollisionBox->SetCollisionResponseToAllChannels(ECR_Ignore);
 	CollisionBox->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
 
-	// Create the widget component for displaying item details when hovered
-	ItemDetailsWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("ItemDetailsWidget"));
-	ItemDetailsWidget->SetupAttachment(GetRootComponent());
+	// Create the widget component for displaying item details when hovered. Server builds have no screen to show it on
+#if !UE_SERVER
+	{
+		LLM_SCOPE_BYTAG(WorldItems_ItemWidgets);
+		ItemDetailsWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("ItemDetailsWidget"));
+		ItemDetailsWidget->SetupAttachment(GetRootComponent());
+	}
+#else
+	ItemDetailsWidget = nullptr;
+#endif
 
 	// Create the collision sphere component used for proximity detection
 	CollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionSphere"));
@@ -52,10 +78,25 @@ AItem::AItem() : ItemCount(0), ItemRarity(EItemRarity::EIR_MAX), ItemState(EItem
  * @brief Called when the game starts or when spawned.
  * Initializes the visibility of the item details widget and sets the active stars based on item rarity.
  * Also calls SetItemProperties() to configure the item according to its initial state.
+ * A client build running as a dedicated server drops the widget and the tick, which only serve the local player.
  */
 void AItem::BeginPlay()
 {
-	Super::BeginPlay();
+	if (IsRunningDedicatedServer())
+	{
+		if (ItemDetailsWidget)
+		{
+			ItemDetailsWidget->DestroyComponent();
+			ItemDetailsWidget = nullptr;
+		}
+		SetActorTickEnabled(false);
+	}
+
+	{
+		// The widget component instantiates the item details widget while the components begin play
+		LLM_SCOPE_BYTAG(WorldItems_ItemWidgets);
+		Super::BeginPlay();
+	}
 
 	// Hide the item details widget initially
 	if (ItemDetailsWidget)
@@ -68,6 +109,89 @@ void AItem::BeginPlay()
 
 	// Set the initial properties of the item based on its state
 	SetItemProperties(ItemState);
+
+	// Items placed in the level join the streaming cell they lie in. Only the server streams items
+	UItemStreamingSubsystem* Streaming = HasAuthority() ? GetWorld()->GetSubsystem<UItemStreamingSubsystem>() : nullptr;
+	if (Streaming)
+	{
+		Streaming->UpdateItem(this);
+	}
+}
+
+/**
+ * @brief Called when the item is destroyed or its level is unloaded.
+ * Removes the item from its streaming cell so the cell never holds a dangling item.
+ * @param EndPlayReason Why the item is leaving play.
+ */
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UItemStreamingSubsystem* Streaming = GetWorld()->GetSubsystem<UItemStreamingSubsystem>())
+	{
+		Streaming->UnregisterItem(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+/**
+ * @brief Registers the replicated item properties.
+ * They are push based: the server only compares them after they have been marked dirty.
+ * @param OutLifetimeProps The replicated properties of the class.
+ */
+void AItem::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AItem, ItemState, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AItem, ItemCount, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AItem, ItemRarity, Params);
+}
+
+/**
+ * @brief Applies a replicated item state on clients.
+ */
+void AItem::OnRep_ItemState()
+{
+	SetItemProperties(ItemState);
+}
+
+/**
+ * @brief Refreshes the rarity stars on clients when the replicated rarity arrives.
+ */
+void AItem::OnRep_ItemRarity()
+{
+	if (ItemDetailsWidget)
+	{
+		SetActiveStars();
+	}
+}
+
+/**
+ * @brief Sends the item's latest state to clients and picks the dormancy for it.
+ * Falling items stay awake so their movement replicates, every other state replicates once and goes back to sleep.
+ */
+void AItem::WakeForReplication()
+{
+	if (!HasAuthority() || GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	CSV_CUSTOM_STAT(WorldItems, ItemNetWakeups, 1, ECsvCustomStatOp::Accumulate);
+
+	if (ItemState == EItemState::EIS_Falling && !bIsPooled)
+	{
+		SetNetDormancy(DORM_Awake);
+		return;
+	}
+
+	if (NetDormancy < DORM_DormantAll)
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+	FlushNetDormancy();
 }
 
 /**
@@ -77,6 +201,9 @@ void AItem::BeginPlay()
  */
 void AItem::Tick(float DeltaTime)
 {
+	WORLDITEMS_SCOPE(ItemTick);
+	CSV_CUSTOM_STAT(WorldItems, ItemsTicking, 1, ECsvCustomStatOp::Accumulate);
+
 	Super::Tick(DeltaTime);
 
 	// Continuously trace for items if the player is in range
@@ -108,6 +235,11 @@ void AItem::IncreaseOverlappedItemCount(int Amount)
  */
 void AItem::HandleItemTrace()
 {
+	if (!ItemDetailsWidget)
+	{
+		return;
+	}
+
 	if (bShouldTraceForItem)
 	{
 		TraceForItemsInWorld();
@@ -131,6 +263,9 @@ void AItem::HandleItemTrace()
 void AItem::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
 							int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	WORLDITEMS_SCOPE(ItemOverlap);
+	CSV_CUSTOM_STAT(WorldItems, OverlapsProcessed, 1, ECsvCustomStatOp::Accumulate);
+
 	// Check if the overlapping actor is the player character
 	ACharacter* PlayerCharacter = UGameplayStatics::GetPlayerCharacter(this, 0);
 	ACharacter* OtherCharacter = Cast<ACharacter>(OtherActor);
@@ -153,6 +288,9 @@ void AItem::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* Oth
 void AItem::OnOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
 						int32 OtherBodyIndex)
 {
+	WORLDITEMS_SCOPE(ItemOverlap);
+	CSV_CUSTOM_STAT(WorldItems, OverlapsProcessed, 1, ECsvCustomStatOp::Accumulate);
+
 	// Check if the overlapping actor is the player character
 	ACharacter* PlayerCharacter = UGameplayStatics::GetPlayerCharacter(this, 0);
 	ACharacter* OtherCharacter = Cast<ACharacter>(OtherActor);
@@ -194,6 +332,7 @@ bool AItem::TraceForItems(FHitResult& HitItemResult)
 		// Large distance for long-range tracing
 
 		// Perform the line trace and check if it hits any objects
+		CSV_CUSTOM_STAT(WorldItems, TracesIssued, 1, ECsvCustomStatOp::Accumulate);
 		GetWorld()->LineTraceSingleByChannel(HitItemResult, TraceStart, TraceEnd, ECollisionChannel::ECC_Visibility);
 
 		if (HitItemResult.bBlockingHit)
@@ -211,6 +350,8 @@ bool AItem::TraceForItems(FHitResult& HitItemResult)
  */
 void AItem::TraceForItemsInWorld()
 {
+	WORLDITEMS_SCOPE(TraceForItemsInWorld);
+
 	// Perform a line trace to detect items in the world
 	FHitResult ItemTraceResult;
 	TraceForItems(ItemTraceResult);
@@ -276,6 +417,23 @@ void AItem::SetActiveStars()
 	}
 }
 
+/**
+ * @brief Sets the count of the item and marks it dirty for replication.
+ * The item is woken so the new count reaches clients even while it is dormant.
+ * @param NewCount The new count of the item.
+ */
+void AItem::SetItemCount(const int32 NewCount)
+{
+	if (ItemCount == NewCount)
+	{
+		return;
+	}
+
+	ItemCount = NewCount;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItem, ItemCount, this);
+	WakeForReplication();
+}
+
 /**
  * @brief Sets the item state and updates item properties accordingly.
  * This function transitions the item between different states such as being in the world, equipped, or falling.
@@ -284,7 +442,16 @@ void AItem::SetActiveStars()
 void AItem::SetItemState(EItemState NewState)
 {
 	ItemState = NewState;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItem, ItemState, this);
 	SetItemProperties(ItemState); // Update item properties based on the new state
+
+	// Picked up items leave their streaming cell, dropped items join the cell they come to rest in
+	if (UItemStreamingSubsystem* Streaming = GetWorld()->GetSubsystem<UItemStreamingSubsystem>())
+	{
+		Streaming->UpdateItem(this);
+	}
+
+	WakeForReplication();
 }
 
 /**
@@ -294,6 +461,8 @@ void AItem::SetItemState(EItemState NewState)
  */
 void AItem::SetItemProperties(EItemState State)
 {
+	WORLDITEMS_SCOPE(SetItemProperties);
+
 	switch (State)
 	{
 	case EItemState::EIS_InWorld:
@@ -353,6 +522,8 @@ void AItem::SetItemProperties(EItemState State)
  */
 void AItem::ThrowItem()
 {
+	WORLDITEMS_SCOPE(ThrowItem);
+
 	// Set the rotation of the item mesh before applying impulse
 	FRotator MeshRotation{0.0f, GetItemMesh()->GetComponentRotation().Yaw, 0.0f};
 	GetItemMesh()->SetWorldRotation(MeshRotation, false, nullptr, ETeleportType::TeleportPhysics);
@@ -374,6 +545,9 @@ void AItem::ThrowItem()
 
 	bIsFalling = true; // Set the falling state flag
 
+	// Keep the item awake for the whole throw so clients see it fly
+	WakeForReplication();
+
 	// Start a timer to stop the item from falling after a certain duration
 	GetWorldTimerManager().SetTimer(ThrowItemTimer, this, &AItem::StopFalling, ThrowTime, false);
 }
@@ -389,3 +563,73 @@ void AItem::StopFalling()
 	// Reset the item state to being in the world
 	SetItemState(EItemState::EIS_InWorld);
 }
+
+/**
+ * @brief Moves the item in or out of its pool.
+ * Pooled items are hidden, have no collision, do not tick and forget any transient interaction state.
+ * @param bInPooled Whether the item is being released to the pool.
+ */
+void AItem::SetPooled(bool bInPooled)
+{
+	bIsPooled = bInPooled;
+
+	SetActorHiddenInGame(bInPooled);
+	SetActorEnableCollision(!bInPooled);
+	SetActorTickEnabled(!bInPooled && !IsRunningDedicatedServer());
+
+	if (bInPooled)
+	{
+		// Forget everything the item was doing before it was parked
+		GetWorldTimerManager().ClearTimer(ThrowItemTimer);
+		bIsFalling = false;
+		ItemMesh->SetSimulatePhysics(false);
+		if (ItemDetailsWidget)
+		{
+			ItemDetailsWidget->SetVisibility(false);
+		}
+		OverlappedItemCount = 0;
+		bShouldTraceForItem = false;
+		TraceItem = nullptr;
+
+		if (UItemStreamingSubsystem* Streaming = GetWorld()->GetSubsystem<UItemStreamingSubsystem>())
+		{
+			Streaming->UnregisterItem(this);
+		}
+	}
+
+	// Clients hide or show the item with the replicated hidden flag
+	WakeForReplication();
+}
+
+/**
+ * @brief Writes the item's state into a snapshot record.
+ * @param Record The record to fill. The class index is filled in by the caller.
+ */
+void AItem::WriteSnapshot(FItemSnapshotRecord& Record) const
+{
+	Record.SetTransform(GetActorTransform());
+	Record.ItemCount = ItemCount;
+	// A falling item is restored at rest where it was, its throw timer is not part of the snapshot
+	Record.ItemState = static_cast<uint8>(ItemState == EItemState::EIS_Falling ? EItemState::EIS_InWorld : ItemState);
+	Record.ItemRarity = static_cast<uint8>(ItemRarity);
+	Record.Variant = 0;
+	Record.Flags = 0;
+	Record.Reserved = 0;
+}
+
+/**
+ * @brief Restores the item's state from a snapshot record.
+ * @param Record The record to read. The transform has already been applied by the pool.
+ */
+void AItem::ApplySnapshot(const FItemSnapshotRecord& Record)
+{
+	ItemCount = Record.ItemCount;
+	ItemRarity = static_cast<EItemRarity>(FMath::Min<uint8>(Record.ItemRarity, static_cast<uint8>(EItemRarity::EIR_MAX)));
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItem, ItemCount, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItem, ItemRarity, this);
+	if (ItemDetailsWidget)
+	{
+		SetActiveStars();
+	}
+	SetItemState(static_cast<EItemState>(FMath::Min<uint8>(Record.ItemState, static_cast<uint8>(EItemState::EIS_Falling))));
+}
@@ -0,0 +1,123 @@
+﻿/**
+ * @file ItemReplicationTests.cpp
+ * @brief This file contains the automation tests of the AItem net dormancy.
+ */
+
+#include "WorldItemsModule/Item/Public/Item.h"
+#include "WorldItemsModule/ItemPool/Public/ItemPoolSubsystem.h"
+#include "WorldItemsModule/Testing/Public/GameplayTestWorld.h"
+
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ItemReplicationTests
+{
+	/**
+	 * @brief Counts the items not dormant for every connection.
+	 * @param Items The items.
+	 * @return The number of items that would still be considered for replication every net tick.
+	 */
+	int32 CountAwake(const TArray<AItem*>& Items)
+	{
+		int32 NumAwake = 0;
+		for (const AItem* Item : Items)
+		{
+			if (Item->NetDormancy < DORM_DormantAll)
+			{
+				++NumAwake;
+			}
+		}
+		return NumAwake;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemDormancyTest, "LastShooter.WorldItems.Replication.Dormancy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * @brief Spawns 10,000 items through the pool on a listening server and follows their dormancy.
+ *
+ * Every resting item must be dormant, a thrown item must stay awake until it lands and then go back to sleep, and
+ * releasing the items to the pool must leave them all dormant. The time the server spends placing the items is reported.
+ *
+ * No client connects. The test checks the dormancy the net driver acts on; it does not measure replication CPU time
+ * or bandwidth per connection, which needs clients connected over real sockets and is out of scope here.
+ * @param Parameters Unused.
+ * @return True if every check passed.
+ */
+bool FItemDormancyTest::RunTest(const FString& Parameters)
+{
+	using namespace ItemReplicationTests;
+	constexpr int32 NumItems = 10000;
+	constexpr int32 NumThrown = 100;
+
+	// Port 0 binds whichever port the OS has free, so parallel runs and a running game never collide
+	FURL ListenURL;
+	ListenURL.Port = 0;
+	FGameplayTestWorld TestWorld(&ListenURL);
+	UWorld* World = TestWorld.World;
+	if (!TestTrue(TEXT("The server listens"), TestWorld.bIsListening))
+	{
+		return false;
+	}
+	TestTrue(TEXT("The world runs as a listen server"), World->GetNetMode() == NM_ListenServer);
+
+	UItemPoolSubsystem* ItemPool = World->GetSubsystem<UItemPoolSubsystem>();
+	if (!TestNotNull(TEXT("The item pool exists"), ItemPool))
+	{
+		return false;
+	}
+	ItemPool->Prewarm(AItem::StaticClass(), NumItems);
+
+	// Take every item out of the pool onto a grid, as a loaded match would
+	TArray<AItem*> Items;
+	Items.Reserve(NumItems);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	for (int32 Index = 0; Index < NumItems; ++Index)
+	{
+		const FVector Location(static_cast<double>(Index % 100) * 200.0, static_cast<double>(Index / 100) * 200.0, 0.0);
+		if (AItem* Item = ItemPool->AcquireItem(AItem::StaticClass(), FTransform(Location)))
+		{
+			Items.Add(Item);
+		}
+	}
+	const double WakeMilliseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+	AddInfo(FString::Printf(TEXT("Placing %d items took %.2f ms on the server"), Items.Num(), WakeMilliseconds));
+
+	TestEqual(TEXT("Every item is placed"), Items.Num(), NumItems);
+	TestEqual(TEXT("Resting items are dormant"), CountAwake(Items), 0);
+
+	// A thrown item stays awake for the whole flight so its movement replicates, then sleeps again where it lands
+	for (int32 Index = 0; Index < NumThrown; ++Index)
+	{
+		Items[Index]->SetItemState(EItemState::EIS_Falling);
+	}
+	TestEqual(TEXT("Only the thrown items are awake"), CountAwake(Items), NumThrown);
+	for (int32 Index = 0; Index < NumThrown; ++Index)
+	{
+		Items[Index]->StopFalling();
+	}
+	TestEqual(TEXT("Landed items are dormant again"), CountAwake(Items), 0);
+
+	// Picking an item up wakes it once to send the new state and puts it straight back to sleep
+	Items[0]->SetItemState(EItemState::EIS_Equipped);
+	TestTrue(TEXT("A picked up item is dormant once its state is sent"), Items[0]->NetDormancy == DORM_DormantAll);
+
+	for (AItem* Item : Items)
+	{
+		ItemPool->ReleaseItem(Item);
+	}
+	TestEqual(TEXT("Pooled items are dormant"), CountAwake(Items), 0);
+
+	if (const UNetDriver* NetDriver = World->GetNetDriver())
+	{
+		AddInfo(FString::Printf(TEXT("%d objects active in the network object list"), NetDriver->GetNetworkObjectList().GetActiveObjects().Num()));
+	}
+
+	return true;
+}
+
+#endif
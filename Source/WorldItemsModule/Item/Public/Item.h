@@ -9,6 +9,8 @@
 #include "GameFramework/Actor.h"
 #include "Item.generated.h"
 
+struct FItemSnapshotRecord;
+
 /**
  * @enum EItemRarity
  * @brief Enum to represent the rarity of an item.
@@ -48,6 +50,9 @@ enum class EItemState : uint8
  * @brief This class represents an item in the game world.
  *
  * It inherits from the AActor class and provides properties and methods for item interactions.
+ *
+ * Items replicate, but stay net dormant while they rest so the server does not consider them every net tick.
+ * Only SetItemState, ThrowItem and pooling wake them, and their state properties are pushed dirty explicitly.
  */
 UCLASS()
 class WORLDITEMSMODULE_API AItem : public AActor
@@ -123,6 +128,31 @@ public:
 	 */
 	void StopFalling();
 
+	/**
+	 * @brief Moves the item in or out of its pool.
+	 * @param bInPooled Whether the item is being released to the pool.
+	 *
+	 * Pooled items stay in the world hidden, without collision and without ticking, and forget any transient
+	 * interaction state. Leaving the pool only re-enables the actor; callers set the item state afterwards.
+	 */
+	void SetPooled(bool bInPooled);
+
+	/**
+	 * @brief Writes the item's state into a snapshot record.
+	 * @param Record The record to fill. The class index is filled in by the caller.
+	 *
+	 * Subclasses override this to store their variant.
+	 */
+	virtual void WriteSnapshot(FItemSnapshotRecord& Record) const;
+
+	/**
+	 * @brief Restores the item's state from a snapshot record.
+	 * @param Record The record to read. The transform has already been applied by the pool.
+	 *
+	 * Subclasses override this to restore their variant.
+	 */
+	virtual void ApplySnapshot(const FItemSnapshotRecord& Record);
+
 	/**
 	 * @brief Called when an overlap begins.
 	 * @param OverlappedComponent The component that was overlapped.
@@ -168,7 +198,36 @@ protected:
 	 */
 	virtual void BeginPlay() override;
 
+	/**
+	 * @brief Called when the item is destroyed or its level is unloaded.
+	 * @param EndPlayReason Why the item is leaving play.
+	 *
+	 * Removes the item from its streaming cell.
+	 */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/**
+	 * @brief Applies a replicated item state on clients.
+	 *
+	 * Configures the mesh and collision for the new state, as SetItemState does on the server.
+	 */
+	UFUNCTION()
+	void OnRep_ItemState();
+
+	/**
+	 * @brief Refreshes the rarity stars on clients when the replicated rarity arrives.
+	 */
+	UFUNCTION()
+	void OnRep_ItemRarity();
+
 public:
+	/**
+	 * @brief Registers the replicated item properties as push-model properties.
+	 * @param OutLifetimeProps The replicated properties of the class.
+	 */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+
 	/**
 	 * @brief Called every frame.
 	 * @param DeltaTime The time since the last frame.
@@ -202,12 +261,12 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
 	FText ItemName;
 
-	/** The count of the item. */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
+	/** The count of the item. Push replicated, so it is only written through SetItemCount. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
 	int32 ItemCount;
 
 	/** The rarity of the item. */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_ItemRarity, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
 	EItemRarity ItemRarity;
 
 	/** The active stars for the item. */
@@ -215,7 +274,7 @@ private:
 	TArray<bool> ActiveStars;
 
 	/** The current state of the item. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_ItemState, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
 	EItemState ItemState;
 
 	/** Timer handle for controlling the throw duration. */
@@ -234,6 +293,17 @@ private:
 	/** Whether the item is currently falling. */
 	bool bIsFalling;
 
+	/** Whether the item is parked in its pool. */
+	bool bIsPooled = false;
+
+	/**
+	 * @brief Sends the item's latest state to clients and picks the dormancy for it.
+	 *
+	 * Falling items stay awake so their movement replicates, every other state replicates once and goes back to sleep.
+	 * Does nothing on clients.
+	 */
+	void WakeForReplication();
+
 public:
 	/**
 	 * @brief Gets the mesh component of the item.
@@ -259,9 +329,30 @@ public:
 	 */
 	FORCEINLINE EItemState GetItemState() const { return ItemState; }
 
+	/**
+	 * @brief Gets whether the item is parked in its pool.
+	 * @return True if the item is pooled, false otherwise.
+	 */
+	FORCEINLINE bool IsPooled() const { return bIsPooled; }
+
+	/**
+	 * @brief Gets the count of the item.
+	 * @return The count of the item.
+	 */
+	FORCEINLINE int32 GetItemCount() const { return ItemCount; }
+
+	/**
+	 * @brief Sets the count of the item and marks it dirty for replication.
+	 * @param NewCount The new count of the item.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Item Property")
+	void SetItemCount(int32 NewCount);
+
 	/**
 	 * @brief Sets the state of the item.
 	 * @param NewState The new state to set the item to.
+	 *
+	 * Items coming to rest in the world register with their streaming cell, any other state leaves it.
 	 */
 	void SetItemState(EItemState NewState);
 
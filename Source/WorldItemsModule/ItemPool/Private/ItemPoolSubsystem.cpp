@@ -0,0 +1,135 @@
+﻿/**
+ * @file ItemPoolSubsystem.cpp
+ * @brief This file contains the implementation of the UItemPoolSubsystem class.
+ */
+
+#include "WorldItemsModule/ItemPool/Public/ItemPoolSubsystem.h"
+#include "WorldItemsModule/Item/Public/Item.h"
+#include "WorldItemsModule/Private/Profiling.h"
+
+#include "Engine/World.h"
+
+/**
+ * @brief Takes an item of the given class from the pool, spawning one if the pool is empty.
+ * @param ItemClass The class of item to acquire.
+ * @param Transform The world transform to place the item at.
+ * @return The item, enabled and in place, or nullptr if it could not be spawned.
+ */
+AItem* UItemPoolSubsystem::AcquireItem(UClass* ItemClass, const FTransform& Transform)
+{
+	if (FItemPoolBucket* Bucket = Buckets.Find(ItemClass))
+	{
+		while (Bucket->Items.Num() > 0)
+		{
+			AItem* Item = Bucket->Items.Pop(EAllowShrinking::No);
+			if (IsValid(Item))
+			{
+				Item->SetActorLocationAndRotation(Transform.GetLocation(), Transform.GetRotation(), false, nullptr, ETeleportType::TeleportPhysics);
+				Item->SetPooled(false);
+				return Item;
+			}
+		}
+	}
+
+	AItem* Item = SpawnPooledItem(ItemClass, Transform);
+	if (Item)
+	{
+		Item->SetPooled(false);
+	}
+	return Item;
+}
+
+/**
+ * @brief Disables an item and returns it to the pool of its class.
+ * @param Item The item to release.
+ */
+void UItemPoolSubsystem::ReleaseItem(AItem* Item)
+{
+	if (!IsValid(Item) || Item->IsPooled())
+	{
+		return;
+	}
+
+	Item->SetPooled(true);
+	Buckets.FindOrAdd(Item->GetClass()).Items.Add(Item);
+}
+
+/**
+ * @brief Spawns pooled items until the pool of the given class holds at least Count items.
+ * @param ItemClass The class of item to prewarm.
+ * @param Count The number of items the pool should hold.
+ */
+void UItemPoolSubsystem::Prewarm(UClass* ItemClass, const int32 Count)
+{
+	if (ItemClass == nullptr)
+	{
+		return;
+	}
+
+	FItemPoolBucket& Bucket = Buckets.FindOrAdd(ItemClass);
+	Bucket.Items.Reserve(Count);
+	while (Bucket.Items.Num() < Count)
+	{
+		AItem* Item = SpawnPooledItem(ItemClass, FTransform::Identity);
+		if (Item == nullptr)
+		{
+			break;
+		}
+		Item->SetPooled(true);
+		Bucket.Items.Add(Item);
+	}
+}
+
+/**
+ * @brief Destroys pooled items until the pool of the given class holds at most MaxPooled items.
+ * @param ItemClass The class of item to trim.
+ * @param MaxPooled The number of items the pool may keep.
+ */
+void UItemPoolSubsystem::Trim(UClass* ItemClass, const int32 MaxPooled)
+{
+	FItemPoolBucket* Bucket = Buckets.Find(ItemClass);
+	if (Bucket == nullptr)
+	{
+		return;
+	}
+
+	while (Bucket->Items.Num() > FMath::Max(MaxPooled, 0))
+	{
+		AItem* Item = Bucket->Items.Pop(EAllowShrinking::No);
+		if (IsValid(Item))
+		{
+			Item->Destroy();
+		}
+	}
+}
+
+/**
+ * @brief Gets the number of items waiting in the pool of a class.
+ * @param ItemClass The class to query.
+ * @return The number of pooled items.
+ */
+int32 UItemPoolSubsystem::GetNumPooled(UClass* ItemClass) const
+{
+	const FItemPoolBucket* Bucket = Buckets.Find(ItemClass);
+	return Bucket ? Bucket->Items.Num() : 0;
+}
+
+/**
+ * @brief Spawns a new item for the pool.
+ * @param ItemClass The class of item to spawn.
+ * @param Transform The world transform to spawn the item at.
+ * @return The new item, or nullptr if it could not be spawned.
+ */
+AItem* UItemPoolSubsystem::SpawnPooledItem(UClass* ItemClass, const FTransform& Transform)
+{
+	LLM_SCOPE_BYTAG(WorldItems_Pooled);
+
+	if (ItemClass == nullptr || !ItemClass->IsChildOf(AItem::StaticClass()))
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AItem>(ItemClass, Transform, SpawnParameters);
+}
@@ -0,0 +1,88 @@
+﻿/**
+ * @file ItemPoolSubsystem.h
+ * @brief This file contains the declaration of the UItemPoolSubsystem class.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemPoolSubsystem.generated.h"
+
+class AItem;
+
+/**
+ * @struct FItemPoolBucket
+ * @brief The pooled items of a single class.
+ */
+USTRUCT()
+struct FItemPoolBucket
+{
+	GENERATED_BODY()
+
+	/** The items waiting to be reused. */
+	UPROPERTY()
+	TArray<AItem*> Items;
+};
+
+/**
+ * @class UItemPoolSubsystem
+ * @brief Recycles item actors instead of spawning and destroying them.
+ *
+ * Released items stay in the world hidden, without collision and without ticking. Acquiring one moves it into
+ * place and re-enables it, which is a handful of component state changes instead of a full actor spawn.
+ */
+UCLASS()
+class WORLDITEMSMODULE_API UItemPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief Takes an item of the given class from the pool, spawning one if the pool is empty.
+	 * @param ItemClass The class of item to acquire.
+	 * @param Transform The world transform to place the item at.
+	 * @return The item, enabled and in place, or nullptr if it could not be spawned.
+	 */
+	AItem* AcquireItem(UClass* ItemClass, const FTransform& Transform);
+
+	/**
+	 * @brief Disables an item and returns it to the pool of its class.
+	 * @param Item The item to release.
+	 */
+	void ReleaseItem(AItem* Item);
+
+	/**
+	 * @brief Spawns pooled items until the pool of the given class holds at least Count items.
+	 * @param ItemClass The class of item to prewarm.
+	 * @param Count The number of items the pool should hold.
+	 */
+	void Prewarm(UClass* ItemClass, int32 Count);
+
+	/**
+	 * @brief Destroys pooled items until the pool of the given class holds at most MaxPooled items.
+	 * @param ItemClass The class of item to trim.
+	 * @param MaxPooled The number of items the pool may keep.
+	 */
+	void Trim(UClass* ItemClass, int32 MaxPooled);
+
+	/**
+	 * @brief Gets the number of items waiting in the pool of a class.
+	 * @param ItemClass The class to query.
+	 * @return The number of pooled items.
+	 */
+	int32 GetNumPooled(UClass* ItemClass) const;
+
+private:
+	/**
+	 * @brief Spawns a new item for the pool.
+	 * @param ItemClass The class of item to spawn.
+	 * @param Transform The world transform to spawn the item at.
+	 * @return The new item, or nullptr if it could not be spawned.
+	 */
+	AItem* SpawnPooledItem(UClass* ItemClass, const FTransform& Transform);
+
+	/** The pooled items, per class. */
+	UPROPERTY()
+	TMap<UClass*, FItemPoolBucket> Buckets;
+};
@@ -0,0 +1,147 @@
+﻿/**
+ * @file ItemSnapshot.cpp
+ * @brief This file contains the implementation of the item snapshot record and file layout.
+ */
+
+#include "WorldItemsModule/ItemSnapshot/Public/ItemSnapshot.h"
+
+/**
+ * @brief Gets the transform stored in the record.
+ * @return The world transform of the item.
+ */
+FTransform FItemSnapshotRecord::GetTransform() const
+{
+	const FRotator Rotation(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), FRotator::DecompressAxisFromShort(Roll));
+	return FTransform(Rotation, FVector(Location));
+}
+
+/**
+ * @brief Stores a transform in the record.
+ * @param Transform The world transform of the item.
+ */
+void FItemSnapshotRecord::SetTransform(const FTransform& Transform)
+{
+	const FRotator Rotation = Transform.Rotator();
+	Location = FVector3f(Transform.GetLocation());
+	Pitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+	Yaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+	Roll = FRotator::CompressAxisToShort(Rotation.Roll);
+}
+
+/**
+ * @brief Finds or adds a class to the class table.
+ * Snapshots reference a handful of classes, so a linear search is cheaper than a map.
+ * @param ItemClass The class to look up.
+ * @return The index of the class in the class table.
+ */
+uint16 FItemSnapshot::FindOrAddClass(const UClass* ItemClass)
+{
+	const FSoftClassPath ClassPath(ItemClass);
+	int32 ClassIndex = Classes.IndexOfByKey(ClassPath);
+	if (ClassIndex == INDEX_NONE)
+	{
+		check(Classes.Num() < MAX_uint16);
+		ClassIndex = Classes.Add(ClassPath);
+	}
+	return static_cast<uint16>(ClassIndex);
+}
+
+/**
+ * @brief Writes the snapshot in the file layout.
+ * @param OutBytes Receives the file contents.
+ */
+void FItemSnapshot::WriteToBytes(TArray<uint8>& OutBytes) const
+{
+	OutBytes.Reset();
+	OutBytes.AddZeroed(sizeof(FItemSnapshotHeader));
+
+	// Class table
+	const uint32 ClassTableOffset = OutBytes.Num();
+	for (const FSoftClassPath& ClassPath : Classes)
+	{
+		const FTCHARToUTF8 Utf8Path(*ClassPath.ToString());
+		const uint16 Length = static_cast<uint16>(Utf8Path.Length());
+		OutBytes.Append(reinterpret_cast<const uint8*>(&Length), sizeof(Length));
+		OutBytes.Append(reinterpret_cast<const uint8*>(Utf8Path.Get()), Length);
+	}
+
+	// Records, aligned so they can be read in place from a mapping
+	OutBytes.AddZeroed(Align(OutBytes.Num(), 16) - OutBytes.Num());
+	const uint32 RecordsOffset = OutBytes.Num();
+	OutBytes.Append(reinterpret_cast<const uint8*>(Records.GetData()), Records.Num() * sizeof(FItemSnapshotRecord));
+
+	FItemSnapshotHeader& Header = *reinterpret_cast<FItemSnapshotHeader*>(OutBytes.GetData());
+	Header.Magic = FItemSnapshotHeader::FileMagic;
+	Header.Version = FItemSnapshotHeader::FileVersion;
+	Header.RecordSize = sizeof(FItemSnapshotRecord);
+	Header.NumClasses = Classes.Num();
+	Header.NumRecords = Records.Num();
+	Header.ClassTableOffset = ClassTableOffset;
+	Header.RecordsOffset = RecordsOffset;
+}
+
+/**
+ * @brief Reads a snapshot in the file layout without copying the records.
+ * @param Data The file contents.
+ * @param Size The size of the file contents in bytes.
+ * @return True if the data is a valid snapshot of the current version, false otherwise.
+ */
+bool FItemSnapshot::ReadFromMemory(const uint8* Data, const int64 Size)
+{
+	Classes.Reset();
+	RecordStorage.Reset();
+	Records = TConstArrayView<FItemSnapshotRecord>();
+
+	if (Data == nullptr || Size < static_cast<int64>(sizeof(FItemSnapshotHeader)))
+	{
+		return false;
+	}
+
+	FItemSnapshotHeader Header;
+	FMemory::Memcpy(&Header, Data, sizeof(Header));
+	if (Header.Magic != FItemSnapshotHeader::FileMagic || Header.Version != FItemSnapshotHeader::FileVersion || Header.RecordSize != sizeof(FItemSnapshotRecord))
+	{
+		return false;
+	}
+
+	// Class table
+	int64 Offset = Header.ClassTableOffset;
+	Classes.Reserve(Header.NumClasses);
+	for (uint32 ClassIndex = 0; ClassIndex < Header.NumClasses; ++ClassIndex)
+	{
+		uint16 Length = 0;
+		if (Offset + static_cast<int64>(sizeof(Length)) > Size)
+		{
+			return false;
+		}
+		FMemory::Memcpy(&Length, Data + Offset, sizeof(Length));
+		Offset += sizeof(Length);
+
+		if (Offset + Length > Size)
+		{
+			return false;
+		}
+		const auto ClassPath = StringCast<TCHAR>(reinterpret_cast<const UTF8CHAR*>(Data + Offset), Length);
+		Classes.Emplace(FString(ClassPath.Length(), ClassPath.Get()));
+		Offset += Length;
+	}
+
+	// Records are read in place
+	const int64 RecordsSize = static_cast<int64>(Header.NumRecords) * sizeof(FItemSnapshotRecord);
+	if (!IsAligned(Header.RecordsOffset, 16) || Header.RecordsOffset + RecordsSize > Size)
+	{
+		return false;
+	}
+	Records = MakeArrayView(reinterpret_cast<const FItemSnapshotRecord*>(Data + Header.RecordsOffset), Header.NumRecords);
+
+	// Every record must reference a class in the table
+	for (const FItemSnapshotRecord& Record : Records)
+	{
+		if (Record.ClassIndex >= Header.NumClasses)
+		{
+			Records = TConstArrayView<FItemSnapshotRecord>();
+			return false;
+		}
+	}
+	return true;
+}
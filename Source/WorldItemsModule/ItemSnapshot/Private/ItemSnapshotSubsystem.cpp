@@ -0,0 +1,345 @@
+﻿/**
+ * @file ItemSnapshotSubsystem.cpp
+ * @brief This file contains the implementation of the UItemSnapshotSubsystem class.
+ */
+
+#include "WorldItemsModule/ItemSnapshot/Public/ItemSnapshotSubsystem.h"
+#include "WorldItemsModule/Item/Public/Item.h"
+#include "WorldItemsModule/ItemPool/Public/ItemPoolSubsystem.h"
+#include "WorldItemsModule/ItemStreaming/Public/ItemStreamingSubsystem.h"
+#include "WorldItemsModule/Private/Profiling.h"
+
+#include "Async/MappedFileHandle.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogItemSnapshot, Log, All);
+
+namespace ItemSnapshot
+{
+	/** The number of items a save captures per frame. */
+	constexpr int32 CaptureItemsPerTick = 2048;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs SaveItemSnapshotCommand(
+	TEXT("LastShooter.Items.SaveSnapshot"),
+	TEXT("Saves every world item to Saved/ItemSnapshots/<Name>. Usage: LastShooter.Items.SaveSnapshot [Name]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UItemSnapshotSubsystem* Subsystem = World ? World->GetSubsystem<UItemSnapshotSubsystem>() : nullptr;
+		if (Subsystem)
+		{
+			Subsystem->BeginSaveSnapshot(UItemSnapshotSubsystem::ResolvePath(Args.Num() > 0 ? Args[0] : TEXT("Default")));
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs LoadItemSnapshotCommand(
+	TEXT("LastShooter.Items.LoadSnapshot"),
+	TEXT("Replaces every world item with the items saved in Saved/ItemSnapshots/<Name>. Usage: LastShooter.Items.LoadSnapshot [Name]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UItemSnapshotSubsystem* Subsystem = World ? World->GetSubsystem<UItemSnapshotSubsystem>() : nullptr;
+		if (Subsystem)
+		{
+			Subsystem->LoadSnapshot(UItemSnapshotSubsystem::ResolvePath(Args.Num() > 0 ? Args[0] : TEXT("Default")));
+		}
+	}));
+
+/**
+ * @brief Resolves a snapshot name to a file path. Bare names are placed in Saved/ItemSnapshots.
+ * @param Name The name or path of the snapshot.
+ * @return The path of the snapshot file.
+ */
+FString UItemSnapshotSubsystem::ResolvePath(const FString& Name)
+{
+	FString Path = FPaths::IsRelative(Name) ? FPaths::ProjectSavedDir() / TEXT("ItemSnapshots") / Name : Name;
+	if (FPaths::GetExtension(Path).IsEmpty())
+	{
+		Path += TEXT(".itemsnap");
+	}
+	return Path;
+}
+
+/**
+ * @brief Checks whether an item is part of a snapshot.
+ * @param Item The item to check.
+ * @return True for live, unpooled items lying in the world, false otherwise.
+ */
+bool UItemSnapshotSubsystem::IsSnapshotItem(const AItem* Item)
+{
+	if (!IsValid(Item) || Item->IsPooled() || Item->IsActorBeingDestroyed())
+	{
+		return false;
+	}
+	return Item->GetItemState() == EItemState::EIS_InWorld || Item->GetItemState() == EItemState::EIS_Falling;
+}
+
+/**
+ * @brief Appends an item to a snapshot.
+ * @param Item The item to capture.
+ * @param Snapshot The snapshot to append to.
+ */
+void UItemSnapshotSubsystem::CaptureItem(const AItem* Item, FItemSnapshot& Snapshot)
+{
+	FItemSnapshotRecord& Record = Snapshot.RecordStorage.AddUninitialized_GetRef();
+	Item->WriteSnapshot(Record);
+	Record.ClassIndex = Snapshot.FindOrAddClass(Item->GetClass());
+}
+
+/**
+ * @brief Captures every world item into a snapshot in one go.
+ * @param OutSnapshot Receives the snapshot.
+ */
+void UItemSnapshotSubsystem::CaptureSnapshot(FItemSnapshot& OutSnapshot) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_ItemSnapshotCapture);
+
+	OutSnapshot = FItemSnapshot();
+	for (TActorIterator<AItem> It(GetWorld()); It; ++It)
+	{
+		if (IsSnapshotItem(*It))
+		{
+			CaptureItem(*It, OutSnapshot);
+		}
+	}
+	if (const UItemStreamingSubsystem* Streaming = GetWorld()->GetSubsystem<UItemStreamingSubsystem>())
+	{
+		Streaming->AppendDehydratedItems(OutSnapshot);
+	}
+	OutSnapshot.UseRecordStorage();
+}
+
+/**
+ * @brief Returns every world item to the pool and places the items of a snapshot instead.
+ *
+ * Classes are resolved once, the pool of every class is prewarmed to the number of records that need it
+ * and the records are then applied in a single pass without any per-item UObject serialisation.
+ * @param Snapshot The snapshot to restore.
+ */
+void UItemSnapshotSubsystem::RestoreSnapshot(const FItemSnapshot& Snapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ItemSnapshotRestore);
+
+	UItemPoolSubsystem* Pool = GetWorld()->GetSubsystem<UItemPoolSubsystem>();
+	check(Pool);
+
+	// Park every item currently lying in the world
+	for (TActorIterator<AItem> It(GetWorld()); It; ++It)
+	{
+		if (IsSnapshotItem(*It))
+		{
+			Pool->ReleaseItem(*It);
+		}
+	}
+	// Items of streamed out cells are replaced as well; the ones placed below are streamed out again as needed
+	if (UItemStreamingSubsystem* Streaming = GetWorld()->GetSubsystem<UItemStreamingSubsystem>())
+	{
+		Streaming->ResetDehydratedItems();
+	}
+
+	// Resolve the class table and size the pools
+	TArray<UClass*, TInlineAllocator<16>> Classes;
+	TArray<int32, TInlineAllocator<16>> ClassCounts;
+	Classes.Reserve(Snapshot.Classes.Num());
+	for (const FSoftClassPath& ClassPath : Snapshot.Classes)
+	{
+		UClass* ItemClass = ClassPath.TryLoadClass<AItem>();
+		if (ItemClass == nullptr)
+		{
+			UE_LOG(LogItemSnapshot, Warning, TEXT("Item class %s could not be loaded, its items are skipped"), *ClassPath.ToString());
+		}
+		Classes.Add(ItemClass);
+	}
+	ClassCounts.SetNumZeroed(Classes.Num());
+	for (const FItemSnapshotRecord& Record : Snapshot.Records)
+	{
+		++ClassCounts[Record.ClassIndex];
+	}
+	for (int32 ClassIndex = 0; ClassIndex < Classes.Num(); ++ClassIndex)
+	{
+		Pool->Prewarm(Classes[ClassIndex], ClassCounts[ClassIndex]);
+	}
+
+	// Place the items
+	for (const FItemSnapshotRecord& Record : Snapshot.Records)
+	{
+		if (AItem* Item = Pool->AcquireItem(Classes[Record.ClassIndex], Record.GetTransform()))
+		{
+			Item->ApplySnapshot(Record);
+		}
+	}
+}
+
+/**
+ * @brief Starts capturing the world items over the next frames and writes them to a file in the background.
+ *
+ * The dehydrated items are copied straight away. Streaming holds still until the capture ends, so no item can move
+ * between a live actor and a record halfway through and be captured twice or not at all.
+ * @param Path The file to write.
+ * @return True if the save started, false if a save is already in progress.
+ */
+bool UItemSnapshotSubsystem::BeginSaveSnapshot(const FString& Path)
+{
+	if (IsSaving())
+	{
+		UE_LOG(LogItemSnapshot, Warning, TEXT("An item snapshot is already being saved, ignoring %s"), *Path);
+		return false;
+	}
+
+	PendingCaptureItems.Reset();
+	for (TActorIterator<AItem> It(GetWorld()); It; ++It)
+	{
+		PendingCaptureItems.Add(*It);
+	}
+	PendingCaptureIndex = 0;
+	PendingSnapshot = FItemSnapshot();
+	if (const UItemStreamingSubsystem* Streaming = GetWorld()->GetSubsystem<UItemStreamingSubsystem>())
+	{
+		Streaming->AppendDehydratedItems(PendingSnapshot);
+	}
+	PendingSnapshot.RecordStorage.Reserve(PendingSnapshot.RecordStorage.Num() + PendingCaptureItems.Num());
+	PendingSavePath = Path;
+	bIsCapturing = true;
+	return true;
+}
+
+/**
+ * @brief Captures the next batch of items of a save in progress.
+ *
+ * Once every item is captured, the snapshot is handed to a background task that writes the file.
+ * @param DeltaTime The time since the last frame.
+ */
+void UItemSnapshotSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ItemSnapshotCapture);
+
+		const int32 EndIndex = FMath::Min(PendingCaptureIndex + ItemSnapshot::CaptureItemsPerTick, PendingCaptureItems.Num());
+		for (; PendingCaptureIndex < EndIndex; ++PendingCaptureIndex)
+		{
+			// Items destroyed or picked up since the save started are skipped
+			const AItem* Item = PendingCaptureItems[PendingCaptureIndex].Get();
+			if (IsSnapshotItem(Item))
+			{
+				CaptureItem(Item, PendingSnapshot);
+			}
+		}
+	}
+
+	if (PendingCaptureIndex < PendingCaptureItems.Num())
+	{
+		return;
+	}
+
+	bIsCapturing = false;
+	PendingCaptureItems.Empty();
+
+	SaveTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Snapshot = MoveTemp(PendingSnapshot), Path = MoveTemp(PendingSavePath)]() mutable
+	{
+		Snapshot.UseRecordStorage();
+		TArray<uint8> Bytes;
+		Snapshot.WriteToBytes(Bytes);
+		if (FFileHelper::SaveArrayToFile(Bytes, *Path))
+		{
+			UE_LOG(LogItemSnapshot, Display, TEXT("Saved %d items to %s"), Snapshot.Records.Num(), *Path);
+		}
+		else
+		{
+			UE_LOG(LogItemSnapshot, Error, TEXT("Failed to write item snapshot %s"), *Path);
+		}
+	});
+	PendingSnapshot = FItemSnapshot();
+}
+
+/**
+ * @brief Maps a snapshot file into memory and restores it.
+ *
+ * The records are read straight from the mapping. Platforms without file mapping read the file instead.
+ * @param Path The file to read.
+ * @return True if the file was a valid snapshot and was restored, false otherwise.
+ */
+bool UItemSnapshotSubsystem::LoadSnapshot(const FString& Path)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	FItemSnapshot Snapshot;
+	TArray<uint8> FileBytes;
+
+	// The region must be released before the file handle, so it is declared after it
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile ? MappedFile->MapRegion(0, MappedFile->GetFileSize()) : nullptr);
+
+	bool bIsValid;
+	if (MappedRegion)
+	{
+		bIsValid = Snapshot.ReadFromMemory(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+	}
+	else
+	{
+		bIsValid = FFileHelper::LoadFileToArray(FileBytes, *Path) && Snapshot.ReadFromMemory(FileBytes.GetData(), FileBytes.Num());
+	}
+
+	if (!bIsValid)
+	{
+		UE_LOG(LogItemSnapshot, Error, TEXT("%s is not a valid item snapshot"), *Path);
+		return false;
+	}
+
+	RestoreSnapshot(Snapshot);
+
+	UE_LOG(LogItemSnapshot, Display, TEXT("Restored %d items from %s in %.2f ms"), Snapshot.Records.Num(), *Path, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
+
+/**
+ * @brief Gets whether a save is still capturing or writing.
+ * @return True while a save is in progress, false otherwise.
+ */
+bool UItemSnapshotSubsystem::IsSaving() const
+{
+	return bIsCapturing || (SaveTask.IsValid() && !SaveTask.IsCompleted());
+}
+
+/**
+ * @brief Only ticks while a save is capturing items.
+ * @return True while capturing, false otherwise.
+ */
+bool UItemSnapshotSubsystem::IsTickable() const
+{
+	return bIsCapturing;
+}
+
+TStatId UItemSnapshotSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemSnapshotSubsystem, STATGROUP_Tickables);
+}
+
+/**
+ * @brief Waits for a background write to finish before the world goes away.
+ */
+void UItemSnapshotSubsystem::Deinitialize()
+{
+	if (SaveTask.IsValid())
+	{
+		SaveTask.Wait();
+	}
+	bIsCapturing = false;
+	PendingCaptureItems.Empty();
+
+	Super::Deinitialize();
+}
+
+/**
+ * @brief Item snapshots are only taken in worlds that actually play.
+ * @param WorldType The type of the world the subsystem would be created for.
+ * @return True for game and PIE worlds, false otherwise.
+ */
+bool UItemSnapshotSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,134 @@
+﻿/**
+ * @file ItemSnapshot.h
+ * @brief This file contains the declaration of the item snapshot record, file layout and in-memory snapshot.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+/**
+ * @struct FItemSnapshotRecord
+ * @brief The compact, position-independent state of a single world item.
+ *
+ * Plain data so a snapshot file can be memory mapped and its records read in place without any deserialisation.
+ */
+struct FItemSnapshotRecord
+{
+	/** The world location of the item. */
+	FVector3f Location;
+
+	/** The rotation of the item, each axis compressed with FRotator::CompressAxisToShort. */
+	uint16 Pitch;
+	uint16 Yaw;
+	uint16 Roll;
+
+	/** The index of the item's class in the snapshot class table. */
+	uint16 ClassIndex;
+
+	/** The stack count of the item. */
+	int32 ItemCount;
+
+	/** The EItemState of the item. */
+	uint8 ItemState;
+
+	/** The EItemRarity of the item. */
+	uint8 ItemRarity;
+
+	/** A subclass specific variant, e.g. the EWeaponType of a weapon. */
+	uint8 Variant;
+
+	/** Reserved for future use, always zero. */
+	uint8 Flags;
+
+	/** Reserved for future use, always zero. */
+	uint32 Reserved;
+
+	/**
+	 * @brief Gets the transform stored in the record.
+	 * @return The world transform of the item.
+	 */
+	FTransform GetTransform() const;
+
+	/**
+	 * @brief Stores a transform in the record.
+	 * @param Transform The world transform of the item.
+	 */
+	void SetTransform(const FTransform& Transform);
+};
+
+static_assert(sizeof(FItemSnapshotRecord) == 32, "FItemSnapshotRecord is part of the snapshot file format");
+static_assert(std::is_trivially_copyable_v<FItemSnapshotRecord>, "FItemSnapshotRecord must be readable in place from a mapped file");
+
+/**
+ * @struct FItemSnapshotHeader
+ * @brief The header at the start of every item snapshot file. All offsets are relative to the start of the file.
+ *
+ * The header is followed by the class table, a sequence of [uint16 length][UTF-8 class path] entries,
+ * and then by NumRecords FItemSnapshotRecord entries starting at the 16 byte aligned RecordsOffset.
+ */
+struct FItemSnapshotHeader
+{
+	/** Identifies item snapshot files. */
+	static constexpr uint32 FileMagic = 0x53544D49; // 'IMTS'
+
+	/** Bumped whenever the file layout or the record layout changes. */
+	static constexpr uint16 FileVersion = 1;
+
+	uint32 Magic;
+	uint16 Version;
+	uint16 RecordSize;
+	uint32 NumClasses;
+	uint32 NumRecords;
+	uint32 ClassTableOffset;
+	uint32 RecordsOffset;
+};
+
+static_assert(sizeof(FItemSnapshotHeader) == 24, "FItemSnapshotHeader is part of the snapshot file format");
+
+/**
+ * @struct FItemSnapshot
+ * @brief A snapshot of world items: a class table and one record per item.
+ *
+ * Used directly as the in-memory layout of a match reset, or written to and read from a snapshot file.
+ * When read from a mapped file, Records points into the mapping and RecordStorage stays empty.
+ */
+struct WORLDITEMSMODULE_API FItemSnapshot
+{
+	/** The classes referenced by the records. */
+	TArray<FSoftClassPath> Classes;
+
+	/** The records, owned by the snapshot when captured in memory. */
+	TArray<FItemSnapshotRecord> RecordStorage;
+
+	/** The records to restore, either RecordStorage or a view into a mapped file. */
+	TConstArrayView<FItemSnapshotRecord> Records;
+
+	/**
+	 * @brief Finds or adds a class to the class table.
+	 * @param ItemClass The class to look up.
+	 * @return The index of the class in the class table.
+	 */
+	uint16 FindOrAddClass(const UClass* ItemClass);
+
+	/**
+	 * @brief Points Records at the owned RecordStorage. Call after filling RecordStorage.
+	 */
+	FORCEINLINE void UseRecordStorage() { Records = RecordStorage; }
+
+	/**
+	 * @brief Writes the snapshot in the file layout.
+	 * @param OutBytes Receives the file contents.
+	 */
+	void WriteToBytes(TArray<uint8>& OutBytes) const;
+
+	/**
+	 * @brief Reads a snapshot in the file layout without copying the records.
+	 * Records will point into Data, which must outlive the snapshot.
+	 * @param Data The file contents.
+	 * @param Size The size of the file contents in bytes.
+	 * @return True if the data is a valid snapshot of the current version, false otherwise.
+	 */
+	bool ReadFromMemory(const uint8* Data, int64 Size);
+};
@@ -0,0 +1,127 @@
+﻿/**
+ * @file ItemSnapshotSubsystem.h
+ * @brief This file contains the declaration of the UItemSnapshotSubsystem class.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "WorldItemsModule/ItemSnapshot/Public/ItemSnapshot.h"
+#include "ItemSnapshotSubsystem.generated.h"
+
+class AItem;
+
+/**
+ * @class UItemSnapshotSubsystem
+ * @brief Captures and restores the state of every world item through compact FItemSnapshot records.
+ *
+ * Only items lying in the world are part of a snapshot; equipped items belong to their owner's loadout.
+ * Items of cells dehydrated by UItemStreamingSubsystem are included from their records.
+ * Saving captures a bounded number of items per frame and writes the file on a background task.
+ * Loading maps the file into memory, reads the records in place and places the items from UItemPoolSubsystem.
+ * Available from the console as LastShooter.Items.SaveSnapshot and LastShooter.Items.LoadSnapshot.
+ */
+UCLASS()
+class WORLDITEMSMODULE_API UItemSnapshotSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief Captures every world item into a snapshot in one go.
+	 * @param OutSnapshot Receives the snapshot.
+	 */
+	void CaptureSnapshot(FItemSnapshot& OutSnapshot) const;
+
+	/**
+	 * @brief Returns every world item to the pool and places the items of a snapshot instead.
+	 * @param Snapshot The snapshot to restore.
+	 */
+	void RestoreSnapshot(const FItemSnapshot& Snapshot);
+
+	/**
+	 * @brief Starts capturing the world items over the next frames and writes them to a file in the background.
+	 * @param Path The file to write.
+	 * @return True if the save started, false if a save is already in progress.
+	 */
+	bool BeginSaveSnapshot(const FString& Path);
+
+	/**
+	 * @brief Maps a snapshot file into memory and restores it.
+	 * @param Path The file to read.
+	 * @return True if the file was a valid snapshot and was restored, false otherwise.
+	 */
+	bool LoadSnapshot(const FString& Path);
+
+	/**
+	 * @brief Gets whether a save is still capturing or writing.
+	 * @return True while a save is in progress, false otherwise.
+	 */
+	bool IsSaving() const;
+
+	/**
+	 * @brief Gets whether a save is still capturing items over the frames.
+	 * @return True until every item of the save in progress has been captured, false otherwise.
+	 */
+	FORCEINLINE bool IsCapturing() const { return bIsCapturing; }
+
+	/**
+	 * @brief Resolves a snapshot name to a file path. Bare names are placed in Saved/ItemSnapshots.
+	 * @param Name The name or path of the snapshot.
+	 * @return The path of the snapshot file.
+	 */
+	static FString ResolvePath(const FString& Name);
+
+	/**
+	 * @brief Checks whether an item is part of a snapshot.
+	 * @param Item The item to check.
+	 * @return True for live, unpooled items lying in the world, false otherwise.
+	 */
+	static bool IsSnapshotItem(const AItem* Item);
+
+	/**
+	 * @brief Captures the next batch of items of a save in progress.
+	 * @param DeltaTime The time since the last frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * @brief Waits for a background write to finish before the world goes away.
+	 */
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * @brief Appends an item to a snapshot.
+	 * @param Item The item to capture.
+	 * @param Snapshot The snapshot to append to.
+	 */
+	static void CaptureItem(const AItem* Item, FItemSnapshot& Snapshot);
+
+	/** The items a save in progress still has to capture. */
+	TArray<TWeakObjectPtr<AItem>> PendingCaptureItems;
+
+	/** The next item of PendingCaptureItems to capture. */
+	int32 PendingCaptureIndex = 0;
+
+	/** The snapshot a save in progress is capturing into. */
+	FItemSnapshot PendingSnapshot;
+
+	/** The file a save in progress writes to. */
+	FString PendingSavePath;
+
+	/** Whether a save is capturing items. */
+	bool bIsCapturing = false;
+
+	/** The background write of the last save. */
+	UE::Tasks::FTask SaveTask;
+};
@@ -0,0 +1,421 @@
+﻿/**
+ * @file ItemStreamingSubsystem.cpp
+ * @brief This file contains the implementation of the UItemStreamingSubsystem class.
+ */
+
+#include "WorldItemsModule/ItemStreaming/Public/ItemStreamingSubsystem.h"
+#include "WorldItemsModule/Item/Public/Item.h"
+#include "WorldItemsModule/ItemPool/Public/ItemPoolSubsystem.h"
+#include "WorldItemsModule/ItemSnapshot/Public/ItemSnapshotSubsystem.h"
+#include "WorldItemsModule/Private/Profiling.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarItemStreamingEnabled(
+	TEXT("LastShooter.Items.Streaming"),
+	true,
+	TEXT("Dehydrates world items in cells out of range of every player to compact records."));
+
+static TAutoConsoleVariable<float> CVarItemStreamingCellSize(
+	TEXT("LastShooter.Items.StreamingCellSize"),
+	12800.f,
+	TEXT("The edge length of an item streaming cell in centimetres. Read when a world starts."));
+
+static TAutoConsoleVariable<float> CVarItemStreamingLoadRange(
+	TEXT("LastShooter.Items.StreamingLoadRange"),
+	25600.f,
+	TEXT("Cells closer than this to a player, in centimetres, keep their items live."));
+
+static TAutoConsoleVariable<float> CVarItemStreamingUpdateInterval(
+	TEXT("LastShooter.Items.StreamingUpdateInterval"),
+	0.25f,
+	TEXT("Seconds between evaluations of which cells should be live."));
+
+static TAutoConsoleVariable<int32> CVarItemStreamingPoolBudget(
+	TEXT("LastShooter.Items.StreamingPoolBudget"),
+	32,
+	TEXT("The number of items per class released by streaming that the pool keeps after a cell is dehydrated. The rest of them are destroyed."));
+
+/**
+ * @brief Reads the cell size, which stays fixed for the lifetime of the world.
+ * @param Collection The collection of subsystems being initialized.
+ */
+void UItemStreamingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UItemPoolSubsystem>();
+	CellSize = FMath::Max(CVarItemStreamingCellSize.GetValueOnGameThread(), 100.f);
+}
+
+/**
+ * @brief Gets the cell that contains a location.
+ * @param Location The world location.
+ * @return The grid coordinates of the cell.
+ */
+FIntPoint UItemStreamingSubsystem::GetCellAt(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+/**
+ * @brief Registers, moves or unregisters an item to match its current state.
+ * @param Item The item whose state or location changed.
+ */
+void UItemStreamingSubsystem::UpdateItem(AItem* Item)
+{
+	if (!bIsStreamingWorld)
+	{
+		return;
+	}
+
+	if (!IsValid(Item) || Item->IsPooled() || Item->GetItemState() != EItemState::EIS_InWorld)
+	{
+		UnregisterItem(Item);
+		return;
+	}
+
+	const FIntPoint NewCell = GetCellAt(Item->GetActorLocation());
+	if (const FIntPoint* CurrentCell = ItemCells.Find(Item))
+	{
+		if (*CurrentCell == NewCell)
+		{
+			return;
+		}
+		UnregisterItem(Item);
+	}
+
+	Cells.FindOrAdd(NewCell).Items.Add(Item);
+	ItemCells.Add(Item, NewCell);
+}
+
+/**
+ * @brief Removes an item from its cell.
+ * @param Item The item to unregister.
+ */
+void UItemStreamingSubsystem::UnregisterItem(const AItem* Item)
+{
+	FIntPoint CellCoord;
+	if (!ItemCells.RemoveAndCopyValue(Item, CellCoord))
+	{
+		return;
+	}
+
+	if (FItemStreamingCell* Cell = Cells.Find(CellCoord))
+	{
+		Cell->Items.RemoveSingleSwap(const_cast<AItem*>(Item), EAllowShrinking::No);
+	}
+}
+
+/**
+ * @brief Appends the dehydrated items of every cell to a snapshot.
+ * @param Snapshot The snapshot to append to. Its record storage is appended, not its record view.
+ */
+void UItemStreamingSubsystem::AppendDehydratedItems(FItemSnapshot& Snapshot) const
+{
+	Snapshot.RecordStorage.Reserve(Snapshot.RecordStorage.Num() + NumDehydratedItems);
+	for (const TPair<FIntPoint, FItemStreamingCell>& Pair : Cells)
+	{
+		for (const FItemSnapshotRecord& Record : Pair.Value.Records)
+		{
+			FItemSnapshotRecord& Appended = Snapshot.RecordStorage.Add_GetRef(Record);
+			Appended.ClassIndex = Snapshot.FindOrAddClass(Classes[Record.ClassIndex]);
+		}
+	}
+}
+
+/**
+ * @brief Forgets every dehydrated item, for when the world items are replaced wholesale.
+ */
+void UItemStreamingSubsystem::ResetDehydratedItems()
+{
+	for (TPair<FIntPoint, FItemStreamingCell>& Pair : Cells)
+	{
+		Pair.Value.Records.Empty();
+	}
+	NumDehydratedItems = 0;
+}
+
+/**
+ * @brief Dehydrates and rehydrates cells as the streaming sources move.
+ *
+ * A cell stays live while any source is within the load range of its bounds and is only dehydrated once every
+ * source is half a cell further out, so a player walking along a cell border does not make it thrash.
+ * @param DeltaTime The time since the last frame.
+ */
+void UItemStreamingSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0.f)
+	{
+		return;
+	}
+
+	// A save copies the records when it starts and the live items over the next frames, so cells hold still meanwhile
+	const UItemSnapshotSubsystem* Snapshots = GetWorld()->GetSubsystem<UItemSnapshotSubsystem>();
+	if (Snapshots && Snapshots->IsCapturing())
+	{
+		return;
+	}
+	TimeUntilUpdate = CVarItemStreamingUpdateInterval.GetValueOnGameThread();
+
+	WORLDITEMS_SCOPE(ItemStreamingUpdate);
+
+	TArray<FVector, TInlineAllocator<16>> Sources;
+	GatherStreamingSources(Sources);
+
+	// Without a source there is nothing to stream around, so the world stays as it is
+	if (Sources.Num() == 0)
+	{
+		return;
+	}
+
+	const float LoadRange = CVarItemStreamingLoadRange.GetValueOnGameThread();
+	const float UnloadRange = LoadRange + CellSize * 0.5f;
+
+	TArray<FIntPoint, TInlineAllocator<32>> CellsToDehydrate;
+	TArray<FIntPoint, TInlineAllocator<32>> CellsToRehydrate;
+	TArray<FIntPoint, TInlineAllocator<32>> EmptyCells;
+	for (const TPair<FIntPoint, FItemStreamingCell>& Pair : Cells)
+	{
+		if (Pair.Value.Items.Num() == 0 && Pair.Value.Records.Num() == 0)
+		{
+			EmptyCells.Add(Pair.Key);
+			continue;
+		}
+
+		const FBox2D CellBounds(FVector2D(Pair.Key) * CellSize, FVector2D(Pair.Key + FIntPoint(1, 1)) * CellSize);
+		double ClosestDistanceSquared = TNumericLimits<double>::Max();
+		for (const FVector& Source : Sources)
+		{
+			ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, CellBounds.ComputeSquaredDistanceToPoint(FVector2D(Source)));
+		}
+
+		if (Pair.Value.Records.Num() > 0 && ClosestDistanceSquared <= FMath::Square(LoadRange))
+		{
+			CellsToRehydrate.Add(Pair.Key);
+		}
+		else if (Pair.Value.Items.Num() > 0 && ClosestDistanceSquared > FMath::Square(UnloadRange))
+		{
+			CellsToDehydrate.Add(Pair.Key);
+		}
+	}
+
+	for (const FIntPoint& CellCoord : EmptyCells)
+	{
+		Cells.Remove(CellCoord);
+	}
+	for (const FIntPoint& CellCoord : CellsToDehydrate)
+	{
+		DehydrateCell(CellCoord);
+	}
+	for (const FIntPoint& CellCoord : CellsToRehydrate)
+	{
+		RehydrateCell(CellCoord);
+	}
+
+	// Released actors are what the records replace, so the pool only keeps enough of them to serve rehydration
+	if (CellsToDehydrate.Num() > 0)
+	{
+		TrimReleasedItems();
+	}
+
+	CSV_CUSTOM_STAT(WorldItems, StreamedLiveItems, ItemCells.Num(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(WorldItems, DehydratedItems, NumDehydratedItems, ECsvCustomStatOp::Set);
+}
+
+/**
+ * @brief Gathers the locations cells are streamed around: every controlled pawn and every player view point.
+ * @param OutSources Receives the source locations.
+ */
+void UItemStreamingSubsystem::GatherStreamingSources(TArray<FVector, TInlineAllocator<16>>& OutSources) const
+{
+	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
+	{
+		const AController* Controller = It->Get();
+		if (Controller == nullptr)
+		{
+			continue;
+		}
+
+		if (const APawn* Pawn = Controller->GetPawn())
+		{
+			OutSources.Add(Pawn->GetActorLocation());
+		}
+		else if (Controller->IsPlayerController())
+		{
+			// Spectating players still need the items around their camera
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			Controller->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			OutSources.Add(ViewLocation);
+		}
+	}
+}
+
+/**
+ * @brief Writes every live item of a cell to records and returns the items to the pool.
+ * @param CellCoord The cell to dehydrate.
+ */
+void UItemStreamingSubsystem::DehydrateCell(const FIntPoint& CellCoord)
+{
+	UItemPoolSubsystem* Pool = GetWorld()->GetSubsystem<UItemPoolSubsystem>();
+	FItemStreamingCell& Cell = Cells.FindChecked(CellCoord);
+
+	// The items are unregistered up front, so releasing them does not reach back into the cell
+	TArray<AItem*> Items = MoveTemp(Cell.Items);
+	Cell.Records.Reserve(Cell.Records.Num() + Items.Num());
+	for (AItem* Item : Items)
+	{
+		ItemCells.Remove(Item);
+		if (!IsValid(Item))
+		{
+			continue;
+		}
+
+		FItemSnapshotRecord& Record = Cell.Records.AddUninitialized_GetRef();
+		Item->WriteSnapshot(Record);
+		Record.ClassIndex = FindOrAddClass(Item->GetClass());
+		Pool->ReleaseItem(Item);
+		++NumReleasedByClass[Record.ClassIndex];
+		++NumDehydratedItems;
+	}
+}
+
+/**
+ * @brief Places the dehydrated items of a cell from the pool.
+ *
+ * Applying a record sets the item state, which registers the item with its cell again.
+ * @param CellCoord The cell to rehydrate.
+ */
+void UItemStreamingSubsystem::RehydrateCell(const FIntPoint& CellCoord)
+{
+	UItemPoolSubsystem* Pool = GetWorld()->GetSubsystem<UItemPoolSubsystem>();
+
+	// Registering the items may add cells, so the records are taken out before the map can change
+	const TArray<FItemSnapshotRecord> Records = MoveTemp(Cells.FindChecked(CellCoord).Records);
+	NumDehydratedItems -= Records.Num();
+
+	for (const FItemSnapshotRecord& Record : Records)
+	{
+		if (AItem* Item = Pool->AcquireItem(Classes[Record.ClassIndex], Record.GetTransform()))
+		{
+			Item->ApplySnapshot(Record);
+		}
+		NumReleasedByClass[Record.ClassIndex] = FMath::Max(NumReleasedByClass[Record.ClassIndex] - 1, 0);
+	}
+}
+
+/**
+ * @brief Finds or adds the class table index of an item class.
+ * @param ItemClass The class to look up.
+ * @return The index of the class in Classes.
+ */
+uint16 UItemStreamingSubsystem::FindOrAddClass(UClass* ItemClass)
+{
+	const int32 ClassIndex = Classes.AddUnique(ItemClass);
+	NumReleasedByClass.SetNumZeroed(Classes.Num());
+	return static_cast<uint16>(ClassIndex);
+}
+
+/**
+ * @brief Destroys the actors streaming released past the pool budget of their class.
+ *
+ * Anything may take the released actors back out of the pool, so streaming never counts more of them than the pool
+ * still holds. Prewarmed items and items released by anything else stay pooled.
+ */
+void UItemStreamingSubsystem::TrimReleasedItems()
+{
+	UItemPoolSubsystem* Pool = GetWorld()->GetSubsystem<UItemPoolSubsystem>();
+	const int32 PoolBudget = FMath::Max(CVarItemStreamingPoolBudget.GetValueOnGameThread(), 0);
+
+	for (int32 ClassIndex = 0; ClassIndex < Classes.Num(); ++ClassIndex)
+	{
+		const int32 NumPooled = Pool->GetNumPooled(Classes[ClassIndex]);
+		const int32 NumReleased = FMath::Min(NumReleasedByClass[ClassIndex], NumPooled);
+		const int32 NumExcess = NumReleased - PoolBudget;
+		if (NumExcess > 0)
+		{
+			Pool->Trim(Classes[ClassIndex], NumPooled - NumExcess);
+		}
+		NumReleasedByClass[ClassIndex] = FMath::Min(NumReleased, PoolBudget);
+	}
+}
+
+/**
+ * @brief Only ticks in server worlds, while streaming is enabled and there are items to stream.
+ * @return True if cells may need to be dehydrated or rehydrated, false otherwise.
+ */
+bool UItemStreamingSubsystem::IsTickable() const
+{
+	return bIsStreamingWorld && Cells.Num() > 0 && CVarItemStreamingEnabled.GetValueOnGameThread();
+}
+
+TStatId UItemStreamingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemStreamingSubsystem, STATGROUP_Tickables);
+}
+
+/**
+ * @brief Forgets every cell before the world goes away.
+ */
+void UItemStreamingSubsystem::Deinitialize()
+{
+	Cells.Empty();
+	ItemCells.Empty();
+	Classes.Empty();
+	NumReleasedByClass.Empty();
+	NumDehydratedItems = 0;
+
+	Super::Deinitialize();
+}
+
+/**
+ * @brief Keeps client worlds from streaming, once their net mode is known.
+ *
+ * A client's world is created before its net driver is set, so ShouldCreateSubsystem cannot always tell.
+ * By the time play begins it can, and anything registered before then is dropped.
+ * @param InWorld The world that begins play.
+ */
+void UItemStreamingSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() == NM_Client)
+	{
+		bIsStreamingWorld = false;
+		Cells.Empty();
+		ItemCells.Empty();
+	}
+}
+
+/**
+ * @brief Keeps the subsystem out of client-only builds and of worlds already known to be network clients.
+ * @param Outer The world the subsystem would be created for.
+ * @return True if the world may stream items, false otherwise.
+ */
+bool UItemStreamingSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer) || IsRunningClientOnly())
+	{
+		return false;
+	}
+
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World == nullptr || World->GetNetMode() != NM_Client;
+}
+
+/**
+ * @brief Items are only streamed in worlds that actually play.
+ * @param WorldType The type of the world the subsystem would be created for.
+ * @return True for game and PIE worlds, false otherwise.
+ */
+bool UItemStreamingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
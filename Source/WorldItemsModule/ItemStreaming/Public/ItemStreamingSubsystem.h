@@ -0,0 +1,179 @@
+﻿/**
+ * @file ItemStreamingSubsystem.h
+ * @brief This file contains the declaration of the UItemStreamingSubsystem class.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldItemsModule/ItemSnapshot/Public/ItemSnapshot.h"
+#include "ItemStreamingSubsystem.generated.h"
+
+class AItem;
+
+/**
+ * @struct FItemStreamingCell
+ * @brief The items of a single streaming cell, either live or dehydrated to snapshot records.
+ */
+USTRUCT()
+struct FItemStreamingCell
+{
+	GENERATED_BODY()
+
+	/** The live items lying in the cell. */
+	UPROPERTY()
+	TArray<AItem*> Items;
+
+	/** The dehydrated items of the cell. Class indices refer to UItemStreamingSubsystem's class table. */
+	TArray<FItemSnapshotRecord> Records;
+};
+
+/**
+ * @class UItemStreamingSubsystem
+ * @brief Keeps only the items near a streaming source alive and stores the rest as compact records.
+ *
+ * Items lying in the world register with the cell of a 2D grid that contains them, the same layout as a
+ * World Partition runtime grid. Cells out of range of every player are dehydrated: their items are written to
+ * FItemSnapshotRecords and returned to UItemPoolSubsystem, which is trimmed so the released actors do not pile up.
+ * Cells coming back into range are rehydrated from the pool. Picking an item up removes it from its cell and
+ * dropping it registers it with the cell it comes to rest in, so memory follows the loaded area, not the map.
+ *
+ * Streaming is server side only. Clients get their items through replication and never stream them themselves.
+ */
+UCLASS()
+class WORLDITEMSMODULE_API UItemStreamingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief Registers, moves or unregisters an item to match its current state.
+	 * Items lying in the world belong to the cell containing them; pooled, falling, equipped and stored items
+	 * belong to no cell.
+	 * @param Item The item whose state or location changed.
+	 */
+	void UpdateItem(AItem* Item);
+
+	/**
+	 * @brief Removes an item from its cell.
+	 * @param Item The item to unregister.
+	 */
+	void UnregisterItem(const AItem* Item);
+
+	/**
+	 * @brief Appends the dehydrated items of every cell to a snapshot.
+	 * @param Snapshot The snapshot to append to. Its record storage is appended, not its record view.
+	 */
+	void AppendDehydratedItems(FItemSnapshot& Snapshot) const;
+
+	/**
+	 * @brief Forgets every dehydrated item, for when the world items are replaced wholesale.
+	 */
+	void ResetDehydratedItems();
+
+	/**
+	 * @brief Gets the cell that contains a location.
+	 * @param Location The world location.
+	 * @return The grid coordinates of the cell.
+	 */
+	FIntPoint GetCellAt(const FVector& Location) const;
+
+	/**
+	 * @brief Gets the number of items currently dehydrated to records.
+	 * @return The number of dehydrated items.
+	 */
+	FORCEINLINE int32 GetNumDehydratedItems() const { return NumDehydratedItems; }
+
+	/**
+	 * @brief Dehydrates and rehydrates cells as the streaming sources move.
+	 * @param DeltaTime The time since the last frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * @brief Reads the cell size, which stays fixed for the lifetime of the world.
+	 * @param Collection The collection of subsystems being initialized.
+	 */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * @brief Keeps client worlds from streaming, once their net mode is known.
+	 * @param InWorld The world that begins play.
+	 */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/**
+	 * @brief Keeps the subsystem out of client-only builds and of worlds already known to be network clients.
+	 * @param Outer The world the subsystem would be created for.
+	 * @return True if the world may stream items, false otherwise.
+	 */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * @brief Gathers the locations cells are streamed around: every controlled pawn and every player view point.
+	 * @param OutSources Receives the source locations.
+	 */
+	void GatherStreamingSources(TArray<FVector, TInlineAllocator<16>>& OutSources) const;
+
+	/**
+	 * @brief Writes every live item of a cell to records and returns the items to the pool.
+	 * @param CellCoord The cell to dehydrate.
+	 */
+	void DehydrateCell(const FIntPoint& CellCoord);
+
+	/**
+	 * @brief Places the dehydrated items of a cell from the pool.
+	 * @param CellCoord The cell to rehydrate.
+	 */
+	void RehydrateCell(const FIntPoint& CellCoord);
+
+	/**
+	 * @brief Finds or adds the class table index of an item class.
+	 * @param ItemClass The class to look up.
+	 * @return The index of the class in Classes.
+	 */
+	uint16 FindOrAddClass(UClass* ItemClass);
+
+	/**
+	 * @brief Destroys the actors streaming released past the pool budget of their class.
+	 * Items prewarmed or released to the pool by anything else are left alone.
+	 */
+	void TrimReleasedItems();
+
+	/** The cells holding live or dehydrated items, by grid coordinates. */
+	UPROPERTY()
+	TMap<FIntPoint, FItemStreamingCell> Cells;
+
+	/** The cell every registered item lives in. */
+	TMap<const AItem*, FIntPoint> ItemCells;
+
+	/** The class table dehydrated records index into. */
+	UPROPERTY()
+	TArray<UClass*> Classes;
+
+	/** The actors streaming released to the pool and has not taken back yet, by class table index. */
+	TArray<int32> NumReleasedByClass;
+
+	/** The number of items currently dehydrated to records. */
+	int32 NumDehydratedItems = 0;
+
+	/** Seconds until the cells are evaluated again. */
+	float TimeUntilUpdate = 0.f;
+
+	/** The edge length of a cell in centimetres. */
+	float CellSize = 12800.f;
+
+	/** False in network client worlds, which take their items from the server. */
+	bool bIsStreamingWorld = true;
+};
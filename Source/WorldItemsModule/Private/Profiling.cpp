@@ -0,0 +1,19 @@
+﻿#include "Profiling.h"
+
+UE_TRACE_CHANNEL_DEFINE(WorldItemsChannel);
+
+CSV_DEFINE_CATEGORY(WorldItems, false);
+
+LLM_DEFINE_TAG(WorldItems);
+LLM_DEFINE_TAG(WorldItems_ItemActors, TEXT("ItemActors"), TEXT("WorldItems"));
+LLM_DEFINE_TAG(WorldItems_ItemWidgets, TEXT("ItemWidgets"), TEXT("WorldItems"));
+LLM_DEFINE_TAG(WorldItems_Pooled, TEXT("Pooled"), TEXT("WorldItems"));
+
+DEFINE_STAT(STAT_ItemTick);
+DEFINE_STAT(STAT_TraceForItemsInWorld);
+DEFINE_STAT(STAT_SetItemProperties);
+DEFINE_STAT(STAT_ItemOverlap);
+DEFINE_STAT(STAT_ThrowItem);
+DEFINE_STAT(STAT_ItemSnapshotCapture);
+DEFINE_STAT(STAT_ItemSnapshotRestore);
+DEFINE_STAT(STAT_ItemStreamingUpdate);
@@ -0,0 +1,39 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.h"
+
+/** Insights channel for the world item hot paths. Enable with -trace=cpu,WorldItems. */
+UE_TRACE_CHANNEL_EXTERN(WorldItemsChannel);
+
+DECLARE_STATS_GROUP(TEXT("WorldItems"), STATGROUP_WorldItems, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item Tick"), STAT_ItemTick, STATGROUP_WorldItems, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TraceForItemsInWorld"), STAT_TraceForItemsInWorld, STATGROUP_WorldItems, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SetItemProperties"), STAT_SetItemProperties, STATGROUP_WorldItems, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item Overlap"), STAT_ItemOverlap, STATGROUP_WorldItems, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ThrowItem"), STAT_ThrowItem, STATGROUP_WorldItems, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item Snapshot Capture"), STAT_ItemSnapshotCapture, STATGROUP_WorldItems, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item Snapshot Restore"), STAT_ItemSnapshotRestore, STATGROUP_WorldItems, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item Streaming Update"), STAT_ItemStreamingUpdate, STATGROUP_WorldItems, );
+
+/** CSV category for per-frame item metrics. Off by default, enabled by -GameplayCsv. */
+CSV_DECLARE_CATEGORY_EXTERN(WorldItems);
+
+/** LLM tags for world item allocations. Visible with -llm in memreport and with -trace=memtag in Insights. */
+LLM_DECLARE_TAG(WorldItems);
+LLM_DECLARE_TAG(WorldItems_ItemActors);
+LLM_DECLARE_TAG(WorldItems_ItemWidgets);
+LLM_DECLARE_TAG(WorldItems_Pooled);
+
+/**
+ * Times the enclosing scope under STAT_<Name> (cycles and call count in `stat WorldItems`)
+ * and as a named CPU event on the WorldItems trace channel, which costs a single branch while the channel is off.
+ */
+#define WORLDITEMS_SCOPE(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, WorldItemsChannel)
@@ -1,10 +1,17 @@
 ﻿#include "WorldItemsModule.h"
+#include "Profiling.h"
 
 #define LOCTEXT_NAMESPACE "FWorldItemsModuleModule"
 
 void FWorldItemsModuleModule::StartupModule()
 {
-    
+#if CSV_PROFILER
+    // Gameplay CSV metrics are opt-in so regular captures stay comparable
+    if (FParse::Param(FCommandLine::Get(), TEXT("GameplayCsv")))
+    {
+        FCsvProfiler::Get()->EnableCategoryByString(TEXT("WorldItems"));
+    }
+#endif
 }
 
 void FWorldItemsModuleModule::ShutdownModule()
@@ -0,0 +1,57 @@
+﻿/**
+ * @file GameplayTestWorld.h
+ * @brief This file contains the FGameplayTestWorld helper shared by the automation tests of every gameplay module.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+/**
+ * @struct FGameplayTestWorld
+ * @brief A game world that has begun play, destroyed when the helper goes out of scope.
+ *
+ * The world is standalone unless it is given a URL to listen on, in which case it runs as a listen server with no
+ * clients. Header only, so the tests of any module depending on WorldItemsModule can use it.
+ */
+struct FGameplayTestWorld
+{
+	UE_NONCOPYABLE(FGameplayTestWorld);
+
+	/**
+	 * @brief Creates a game world and begins play in it.
+	 * @param ListenURL The URL to listen on before play begins, or nullptr for a standalone world.
+	 */
+	explicit FGameplayTestWorld(const FURL* ListenURL = nullptr)
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false);
+		GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+
+		if (ListenURL)
+		{
+			FURL URL = *ListenURL;
+			bIsListening = World->Listen(URL);
+		}
+
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+	}
+
+	~FGameplayTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	UWorld* World = nullptr;
+
+	/** Whether the world was asked to listen and its net driver is up. */
+	bool bIsListening = false;
+};
+
+#endif
@@ -3,9 +3,12 @@
 
 #include "WorldItemsModule/Weapon/Public/Weapon.h"
 
+#include "Engine/SkeletalMeshSocket.h"
+#include "WorldItemsModule/ItemSnapshot/Public/ItemSnapshot.h"
+
 
 // Sets default values
-AWeapon::AWeapon(): WeaponType(EWeaponType::EWT_MAX)
+AWeapon::AWeapon(): WeaponType(EWeaponType::EWT_MAX), MuzzleSocketName(TEXT("SMG_Barrel"))
 {
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
@@ -24,3 +27,61 @@ void AWeapon::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 }
 
+/**
+ * @brief Resolves the muzzle descriptor from the muzzle socket.
+ * The item mesh is searched first. Weapons whose mesh has no such socket are fired from the socket on the mesh
+ * holding them, like the character's SMG_Barrel socket.
+ * Stores the mesh, the socket's bone index and its offset from that bone.
+ */
+void AWeapon::ResolveMuzzle()
+{
+	Muzzle = FWeaponMuzzle();
+
+	const USkeletalMeshComponent* WeaponMesh = GetItemMesh();
+	const USkeletalMeshComponent* HolderMesh = Cast<USkeletalMeshComponent>(WeaponMesh->GetAttachParent());
+	for (const USkeletalMeshComponent* Mesh : { WeaponMesh, HolderMesh })
+	{
+		const USkeletalMeshSocket* MuzzleSocket = Mesh ? Mesh->GetSocketByName(MuzzleSocketName) : nullptr;
+		if (MuzzleSocket)
+		{
+			Muzzle.BoneIndex = Mesh->GetBoneIndex(MuzzleSocket->BoneName);
+			Muzzle.LocalOffset = MuzzleSocket->GetSocketLocalTransform();
+			Muzzle.Mesh = Mesh;
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Gets the world transform of the muzzle from the cached bone index.
+ * @return The world transform shots and muzzle effects start from.
+ */
+FTransform AWeapon::GetMuzzleTransform() const
+{
+	const USkeletalMeshComponent* MuzzleMesh = Muzzle.Mesh.Get();
+	if (Muzzle.IsValid() && MuzzleMesh)
+	{
+		return Muzzle.LocalOffset * MuzzleMesh->GetBoneTransform(Muzzle.BoneIndex);
+	}
+	return GetItemMesh()->GetComponentTransform();
+}
+
+/**
+ * @brief Writes the item state and the weapon type into a snapshot record.
+ * @param Record The record to fill.
+ */
+void AWeapon::WriteSnapshot(FItemSnapshotRecord& Record) const
+{
+	Super::WriteSnapshot(Record);
+	Record.Variant = static_cast<uint8>(WeaponType);
+}
+
+/**
+ * @brief Restores the item state and the weapon type from a snapshot record.
+ * @param Record The record to read.
+ */
+void AWeapon::ApplySnapshot(const FItemSnapshotRecord& Record)
+{
+	WeaponType = static_cast<EWeaponType>(FMath::Min<uint8>(Record.Variant, static_cast<uint8>(EWeaponType::EWT_MAX)));
+	Super::ApplySnapshot(Record);
+}
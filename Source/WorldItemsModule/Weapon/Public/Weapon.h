@@ -15,6 +15,30 @@ enum class EWeaponType : uint8
 	EWT_MAX UMETA(DisplayName = "DefaultMax")
 };
 
+/**
+ * @struct FWeaponMuzzle
+ * @brief Precomputed muzzle location on the weapon's mesh, or on the mesh holding the weapon.
+ *
+ * Resolved from the muzzle socket when the weapon is equipped so the fire path reads the muzzle
+ * transform from a cached bone index without any socket name lookups.
+ */
+USTRUCT()
+struct WORLDITEMSMODULE_API FWeaponMuzzle
+{
+	GENERATED_BODY()
+
+	/** The bone the muzzle socket is attached to, or INDEX_NONE if the socket could not be resolved. */
+	int32 BoneIndex = INDEX_NONE;
+
+	/** The socket's offset relative to its bone. */
+	FTransform LocalOffset = FTransform::Identity;
+
+	/** The mesh the muzzle socket was found on. */
+	TWeakObjectPtr<const USkeletalMeshComponent> Mesh;
+
+	FORCEINLINE bool IsValid() const { return BoneIndex != INDEX_NONE; }
+};
+
 UCLASS()
 class WORLDITEMSMODULE_API AWeapon : public AItem
 {
@@ -32,10 +56,47 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Weapon Type", meta = (AllowPrivateAccess = true))
 	EWeaponType WeaponType;
 
+	/**
+	 * The socket shots and muzzle effects start from. Looked up on the item mesh first, then on the mesh the weapon is attached to.
+	 * Defaults to the barrel socket of the character skeleton, which the weapons were fired from before they carried their own muzzle.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon Muzzle", meta = (AllowPrivateAccess = true))
+	FName MuzzleSocketName;
+
+	/** The muzzle resolved from MuzzleSocketName when the weapon was last equipped. */
+	FWeaponMuzzle Muzzle;
+
 public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+	/**
+	 * @brief Resolves the muzzle descriptor from the muzzle socket on the item mesh or on the mesh holding the weapon.
+	 * Called when the weapon is equipped so the fire path never looks the socket up by name.
+	 */
+	void ResolveMuzzle();
+
+	/**
+	 * @brief Gets the world transform of the muzzle.
+	 * Reads the cached bone directly. Falls back to the item mesh transform if the muzzle socket was not found on either mesh.
+	 * @return The world transform shots and muzzle effects start from.
+	 */
+	FTransform GetMuzzleTransform() const;
+
+	/**
+	 * @brief Writes the item state and the weapon type into a snapshot record.
+	 * @param Record The record to fill.
+	 */
+	virtual void WriteSnapshot(FItemSnapshotRecord& Record) const override;
+
+	/**
+	 * @brief Restores the item state and the weapon type from a snapshot record.
+	 * @param Record The record to read.
+	 */
+	virtual void ApplySnapshot(const FItemSnapshotRecord& Record) override;
+
 	FORCEINLINE EWeaponType GetWeaponType () const {return WeaponType;}
+
+	FORCEINLINE const FWeaponMuzzle& GetMuzzle() const { return Muzzle; }
 	
 };
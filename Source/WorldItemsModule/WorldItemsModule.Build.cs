@@ -18,6 +18,7 @@ public class WorldItemsModule : ModuleRules
             {
                 "CoreUObject",
                 "Engine",
+                "NetCore",
                 "Slate",
                 "SlateCore"
             }